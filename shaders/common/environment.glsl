@@ -0,0 +1,102 @@
+// ------- Environment Map ------- //
+// Equirectangular HDR map stored as half float texels. Every texel also holds an alias table
+// entry over luminance * sin(theta) for importance sampling (see EnvironmentMap.cpp).
+// Requires: common/scene.glsl, GL_EXT_scalar_block_layout
+
+struct EnvironmentTexel {
+    uint  radianceRG;
+    uint  radianceB;
+    float aliasProbability;
+    uint  alias;
+};
+
+// Uniform 9: Environment map (width = 0 when no map is loaded)
+layout(binding = 9, set = 0, scalar) readonly buffer EnvironmentBuffer {
+    uint  width;
+    uint  height;
+    float weightSum;
+    uint  pad;
+    EnvironmentTexel texels[];
+} environment;
+
+
+float luminance(vec3 color) {
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+vec3 unpackEnvironmentRadiance(EnvironmentTexel texel) {
+    return vec3(unpackHalf2x16(texel.radianceRG), unpackHalf2x16(texel.radianceB).x);
+}
+
+vec2 directionToEquirect(vec3 direction) {
+    return vec2(atan(direction.z, direction.x) / (2.0 * PI) + 0.5,
+                acos(clamp(direction.y, -1.0, 1.0)) / PI);
+}
+
+vec3 equirectToDirection(vec2 uv) {
+    float phi = (uv.x - 0.5) * 2.0 * PI;
+    float theta = uv.y * PI;
+    return vec3(sin(theta) * cos(phi), cos(theta), sin(theta) * sin(phi));
+}
+
+vec3 environmentTexel(uint x, uint y) {
+    return unpackEnvironmentRadiance(environment.texels[y * environment.width + x]);
+}
+
+// Bilinear lookup (wraps horizontally, clamps at the poles)
+vec3 lookupEnvironment(vec3 direction)
+{
+    int w = int(environment.width);
+    int h = int(environment.height);
+    vec2 p = directionToEquirect(direction) * vec2(w, h) - 0.5;
+    ivec2 p0 = ivec2(floor(p));
+    vec2 f = p - vec2(p0);
+
+    uint x0 = uint((p0.x % w + w) % w);
+    uint x1 = (x0 + 1) % uint(w);
+    uint y0 = uint(clamp(p0.y, 0, h - 1));
+    uint y1 = uint(clamp(p0.y + 1, 0, h - 1));
+
+    vec3 top = mix(environmentTexel(x0, y0), environmentTexel(x1, y0), f.x);
+    vec3 bottom = mix(environmentTexel(x0, y1), environmentTexel(x1, y1), f.x);
+    return mix(top, bottom, f.y);
+}
+
+// Solid angle pdf of sampleEnvironment picking direction
+float environmentPdf(vec3 direction)
+{
+    vec2 uv = directionToEquirect(direction);
+    uint x = min(uint(uv.x * float(environment.width)), environment.width - 1);
+    uint y = min(uint(uv.y * float(environment.height)), environment.height - 1);
+
+    float sinThetaCenter = sin((float(y) + 0.5) / float(environment.height) * PI);
+    float sinTheta = max(sin(uv.y * PI), 1e-4);
+    float texelProbability = luminance(environmentTexel(x, y)) * sinThetaCenter / environment.weightSum;
+    return texelProbability * float(environment.width * environment.height) / (2.0 * PI * PI * sinTheta);
+}
+
+// Picks a direction proportional to luminance * solid angle (u in [0,1)^3).
+// Returns the texel radiance and the solid angle pdf of the direction.
+vec3 sampleEnvironment(vec3 u, out vec3 direction, out float pdf)
+{
+    uint count = environment.width * environment.height;
+    float scaled = u.x * float(count);
+    uint bucket = min(uint(scaled), count - 1);
+    EnvironmentTexel entry = environment.texels[bucket];
+    uint index = (scaled - float(bucket)) < entry.aliasProbability ? bucket : entry.alias;
+
+    uint x = index % environment.width;
+    uint y = index / environment.width;
+    vec3 radiance = environmentTexel(x, y);
+
+    // Uniform position inside the texel
+    vec2 uv = (vec2(x, y) + u.yz) / vec2(environment.width, environment.height);
+    direction = equirectToDirection(uv);
+
+    // Texel probability over the texel's solid angle (2pi/W * pi/H * sin(theta))
+    float sinThetaCenter = sin((float(y) + 0.5) / float(environment.height) * PI);
+    float sinTheta = max(sin(uv.y * PI), 1e-4);
+    float texelProbability = luminance(radiance) * sinThetaCenter / environment.weightSum;
+    pdf = texelProbability * float(count) / (2.0 * PI * PI * sinTheta);
+    return radiance;
+}
@@ -0,0 +1,11 @@
+// Primary ray payload shared by raygen, miss and all hit groups (location 0)
+struct RayPayload {
+    vec3 color;
+    uint depth;
+    float hitT;      // Primary hit distance, -1 on miss (only written for depth 0)
+    int instanceId;  // Primary hit instance, -1 on miss (only written for depth 0)
+    vec3 normal;     // Primary hit world normal (only written for depth 0)
+    vec3 albedo;     // Primary hit base color, 1 on miss (only written for depth 0)
+    float misBsdfPdf;  // Reflection pdf over the tracing hit's light sample count, MIS weights the
+                       // emitters and environment this ray reaches against NEE (0 = unweighted)
+};
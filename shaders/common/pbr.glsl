@@ -0,0 +1,89 @@
+// ------- PBR Helper Functions ------- //
+// Requires: PI (common/scene.glsl)
+
+// Fresnel Equation (F)
+vec3 fresnelSchlick(float cosTheta, vec3 F0)
+{
+    return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+
+// Normal Distribution Function (D)
+float distributionGGX(vec3 N, vec3 H, float roughness)
+{
+    float a = roughness * roughness;
+    float a2 = a * a;
+    float NdotH = max(dot(N, H), 0.0);
+    float NdotH2 = NdotH * NdotH;
+
+    float num = a2;
+    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+    denom = PI * denom * denom;
+
+    return num / denom;
+}
+
+// Geometry Function (G)
+float geometrySchlickGGX(float NdotV, float roughness)
+{
+    float r = (roughness + 1.0);
+    float k = (r * r) / 8.0; // Note: usage differs for IBL (k = a^2 / 2)
+
+    float num = NdotV;
+    float denom = NdotV * (1.0 - k) + k;
+
+    return num / denom;
+}
+
+float geometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
+{
+    float NdotV = max(dot(N, V), 0.0);
+    float NdotL = max(dot(N, L), 0.0);
+    float ggx2 = geometrySchlickGGX(NdotV, roughness);
+    float ggx1 = geometrySchlickGGX(NdotL, roughness);
+
+    return ggx1 * ggx2;
+}
+
+// Cook-Torrance BRDF times the cosine term for light arriving from L, with the specular lobe
+// scaled by specularWeight (MIS weight against the reflection ray)
+vec3 evaluateBRDFWeighted(vec3 N, vec3 V, vec3 L, vec3 baseColor, float metallic, float roughness,
+                          float specularWeight)
+{
+    vec3 H = normalize(L + V);
+    float NdotL = max(dot(N, L), 0.0);
+    float NdotV = max(dot(N, V), 0.0);
+
+    vec3 F0 = mix(vec3(0.04), baseColor, metallic);
+    vec3 F = fresnelSchlick(max(dot(H, V), 0.0), F0);
+    vec3 specular = distributionGGX(N, H, roughness) * geometrySmith(N, V, L, roughness) * F
+                  / (4.0 * NdotV * NdotL + 0.001);
+
+    vec3 kD = (vec3(1.0) - F) * (1.0 - metallic);
+    return (kD * baseColor / PI + specular * specularWeight) * NdotL;
+}
+
+vec3 evaluateBRDF(vec3 N, vec3 V, vec3 L, vec3 baseColor, float metallic, float roughness)
+{
+    return evaluateBRDFWeighted(N, V, L, baseColor, metallic, roughness, 1.0);
+}
+
+
+// ------- Multiple Importance Sampling ------- //
+
+// Solid angle pdf of picking L through a GGX distributed half vector. Stands in for the pdf of the
+// reflection ray, which follows the lobe's peak; roughness is clamped so the peak stays finite.
+float specularLobePdf(vec3 N, vec3 V, vec3 L, float roughness)
+{
+    vec3 H = normalize(L + V);
+    float NdotH = max(dot(N, H), 0.0);
+    float VdotH = max(dot(V, H), 1e-4);
+    return distributionGGX(N, H, max(roughness, 0.05)) * NdotH / (4.0 * VdotH);
+}
+
+// Power heuristic (beta = 2) weight of a strategy with pdf against one with otherPdf
+float powerHeuristic(float pdf, float otherPdf)
+{
+    float p2 = pdf * pdf;
+    float o2 = otherPdf * otherPdf;
+    return p2 + o2 > 0.0 ? p2 / (p2 + o2) : 0.0;
+}
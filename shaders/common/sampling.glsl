@@ -0,0 +1,174 @@
+// ------- Low Discrepancy Sampling ------- //
+// Sample values are indexed by pixel, sample index (frame * samplesPerFrame + i) and a
+// dimension id. Each dimension id consumes a 2D (or 4D) "padded" sample, decorrelated
+// from the other dimensions by scrambling, so callers never run out of dimensions.
+// The blue noise tile is generated on the CPU (see SamplerTables.cpp).
+// Requires: GL_EXT_scalar_block_layout
+
+// 0 = Sobol (Owen scrambled), 1 = R2, 2 = blue noise (see SamplerType in SamplerTables.h)
+layout(constant_id = 3) const uint SAMPLER_TYPE = 0;
+
+const uint SOBOL_BITS = 32;
+const uint BLUE_NOISE_SIZE = 64;
+
+// Dimension ids per bounce (dimension = depth * DIMENSIONS_PER_BOUNCE + DIM_*)
+const uint DIMENSIONS_PER_BOUNCE = 4;
+const uint DIM_SHADOW = 0;
+
+// Uniform 7: Sampler tables
+layout(binding = 7, set = 0, scalar) readonly buffer SamplerTables {
+    vec2 blueNoise[BLUE_NOISE_SIZE * BLUE_NOISE_SIZE];
+} samplerTables;
+
+// Sobol direction numbers for dimensions 1-3 (Joe & Kuo, new-joe-kuo-6.21201), constant data
+// instead of buffer loads. Dimension 0 (van der Corput) is just the bit reversed index.
+const uint SOBOL_DIRECTIONS[3 * SOBOL_BITS] = uint[](
+    0x80000000u, 0xc0000000u, 0xa0000000u, 0xf0000000u,
+    0x88000000u, 0xcc000000u, 0xaa000000u, 0xff000000u,
+    0x80800000u, 0xc0c00000u, 0xa0a00000u, 0xf0f00000u,
+    0x88880000u, 0xcccc0000u, 0xaaaa0000u, 0xffff0000u,
+    0x80008000u, 0xc000c000u, 0xa000a000u, 0xf000f000u,
+    0x88008800u, 0xcc00cc00u, 0xaa00aa00u, 0xff00ff00u,
+    0x80808080u, 0xc0c0c0c0u, 0xa0a0a0a0u, 0xf0f0f0f0u,
+    0x88888888u, 0xccccccccu, 0xaaaaaaaau, 0xffffffffu,
+
+    0x80000000u, 0xc0000000u, 0x60000000u, 0x90000000u,
+    0xe8000000u, 0x5c000000u, 0x8e000000u, 0xc5000000u,
+    0x68800000u, 0x9cc00000u, 0xee600000u, 0x55900000u,
+    0x80680000u, 0xc09c0000u, 0x60ee0000u, 0x90550000u,
+    0xe8808000u, 0x5cc0c000u, 0x8e606000u, 0xc5909000u,
+    0x6868e800u, 0x9c9c5c00u, 0xeeee8e00u, 0x5555c500u,
+    0x8000e880u, 0xc0005cc0u, 0x60008e60u, 0x9000c590u,
+    0xe8006868u, 0x5c009c9cu, 0x8e00eeeeu, 0xc5005555u,
+
+    0x80000000u, 0xc0000000u, 0x20000000u, 0x50000000u,
+    0xf8000000u, 0x74000000u, 0xa2000000u, 0x93000000u,
+    0xd8800000u, 0x25400000u, 0x59e00000u, 0xe6d00000u,
+    0x78080000u, 0xb40c0000u, 0x82020000u, 0xc3050000u,
+    0x208f8000u, 0x51474000u, 0xfbea2000u, 0x75d93000u,
+    0xa0858800u, 0x914e5400u, 0xdbe79e00u, 0x25db6d00u,
+    0x58800080u, 0xe54000c0u, 0x79e00020u, 0xb6d00050u,
+    0x800800f8u, 0xc00c0074u, 0x200200a2u, 0x50050093u
+);
+
+
+// Cheap integer hash (lowbias32)
+uint hashUint(uint x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+uint hashCombine(uint seed, uint value) {
+    return seed ^ (hashUint(value) + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+}
+
+float uintToUnitFloat(uint x) {
+    return float(x >> 8) * (1.0 / 16777216.0);
+}
+
+
+// --- Sobol + hash based Owen scrambling (Burley 2020) --- //
+
+uint sobolSample(uint index, uint dim) {
+    if (dim == 0u) return bitfieldReverse(index);
+
+    // Only the bits up to the highest set one contribute
+    uint result = 0u;
+    uint base = (dim - 1u) * SOBOL_BITS;
+    int lastBit = findMSB(index);  // -1 for index 0
+    for (int bit = 0; bit <= lastBit; bit++) {
+        if ((index & (1u << bit)) != 0u) result ^= SOBOL_DIRECTIONS[base + uint(bit)];
+    }
+    return result;
+}
+
+uint laineKarrasPermutation(uint x, uint seed) {
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return x;
+}
+
+uint nestedUniformScramble(uint x, uint seed) {
+    x = bitfieldReverse(x);
+    x = laineKarrasPermutation(x, seed);
+    return bitfieldReverse(x);
+}
+
+vec4 sobolOwen4D(uint index, uint seed) {
+    // Shuffle the sequence order per pixel/dimension, then Owen scramble every component
+    uint shuffled = nestedUniformScramble(index, hashUint(seed));
+    vec4 result;
+    for (uint d = 0u; d < 4u; d++) {
+        uint value = sobolSample(shuffled, d);
+        result[d] = uintToUnitFloat(nestedUniformScramble(value, hashCombine(seed, d)));
+    }
+    return result;
+}
+
+
+// --- R2 / R4 additive recurrence (Roberts 2018) --- //
+
+const vec2 R2_ALPHA = vec2(0.7548776662466927, 0.5698402909980532);                                   // 1 / g^k, g = 1.3247179572
+const vec4 R4_ALPHA = vec4(0.8566748838545029, 0.7338918566271260, 0.6287067210378086, 0.5385972572236101); // 1 / g^k, g = 1.1673039783
+
+// Per pixel/dimension Cranley-Patterson rotation
+vec4 cranleyPattersonRotation(uint seed) {
+    return vec4(uintToUnitFloat(hashUint(seed)),
+                uintToUnitFloat(hashUint(seed ^ 0x68bc21ebu)),
+                uintToUnitFloat(hashUint(seed ^ 0x02e5be93u)),
+                uintToUnitFloat(hashUint(seed ^ 0x967a889bu)));
+}
+
+vec2 r2Sequence(uint index, uint seed) {
+    // fract(n * alpha) in float loses precision for large n, so wrap the index first
+    float n = float(index % 16777216u);
+    return fract(cranleyPattersonRotation(seed).xy + n * R2_ALPHA);
+}
+
+vec4 r4Sequence(uint index, uint seed) {
+    float n = float(index % 16777216u);
+    return fract(cranleyPattersonRotation(seed) + n * R4_ALPHA);
+}
+
+
+// --- Blue noise tile rotated over time (spatio-temporal) --- //
+
+vec4 blueNoise4D(uvec2 pixel, uint index, uint dimension) {
+    // Shift the tile per dimension so dimensions do not share the same pattern
+    uvec2 p0 = (pixel + uvec2(dimension * 17u, dimension * 29u)) % BLUE_NOISE_SIZE;
+    uvec2 p1 = (pixel + uvec2(dimension * 17u + 32u, dimension * 29u + 32u)) % BLUE_NOISE_SIZE;
+    vec2 n0 = samplerTables.blueNoise[p0.y * BLUE_NOISE_SIZE + p0.x];
+    vec2 n1 = samplerTables.blueNoise[p1.y * BLUE_NOISE_SIZE + p1.x];
+
+    // R2 rotation keeps each pixel's samples well distributed over time
+    float n = float(index % 16777216u);
+    return fract(vec4(n0 + n * R2_ALPHA, n1 + n * R2_ALPHA.yx));
+}
+
+
+// --- Public interface --- //
+
+uint pixelSeed(uvec2 pixel, uint dimension) {
+    return hashCombine(hashUint(pixel.x + (pixel.y << 16)), dimension);
+}
+
+vec4 sample4D(uvec2 pixel, uint sampleIndex, uint dimension) {
+    uint seed = pixelSeed(pixel, dimension);
+    if (SAMPLER_TYPE == 1u) return r4Sequence(sampleIndex, seed);
+    if (SAMPLER_TYPE == 2u) return blueNoise4D(pixel, sampleIndex, dimension);
+    return sobolOwen4D(sampleIndex, seed);
+}
+
+vec2 sample2D(uvec2 pixel, uint sampleIndex, uint dimension) {
+    uint seed = pixelSeed(pixel, dimension);
+    if (SAMPLER_TYPE == 1u) return r2Sequence(sampleIndex, seed);
+    if (SAMPLER_TYPE == 2u) return blueNoise4D(pixel, sampleIndex, dimension).xy;
+    return sobolOwen4D(sampleIndex, seed).xy;
+}
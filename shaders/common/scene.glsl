@@ -0,0 +1,84 @@
+// Scene resources shared by the hit groups (descriptor set 0)
+// Requires: GL_EXT_ray_tracing, GL_EXT_scalar_block_layout, GL_EXT_buffer_reference(2),
+//           GL_EXT_shader_explicit_arithmetic_types_int64
+
+// ------- Parameters ------- //
+
+const float PI = 3.14159265;
+
+// Quality knobs are specialization constants so presets can be swapped at runtime
+// without recompiling (see QualityPreset.h). Defaults match the "final" preset.
+layout(constant_id = 0) const uint MAX_RECURSION_DEPTH = 6;
+layout(constant_id = 1) const bool SOFT_SHADOWS = true;
+layout(constant_id = 2) const uint SHADOW_GRID_SIZE = 4;
+layout(constant_id = 4) const bool SHADOW_RAYS = true;  // False when the device can't nest them below the hits
+
+
+// ------- Structs ------- //
+
+// Vertex structure matching C++ Vertex struct
+struct Vertex {
+    vec3 pos;    float pad0;
+    vec3 normal; float pad1;
+};
+
+// Instance data structure matching C++ InstanceData struct
+// Note: uint64_t addresses are split into uvec2 (low, high) for GLSL compatibility
+struct InstanceData {
+    uvec2 vertexBufferAddress;  // 64-bit address as uvec2
+    uvec2 indexBufferAddress;   // 64-bit address as uvec2
+    uint  materialType;
+    vec3  color;
+    float metallic;
+    float roughness;
+    float transparency;  // 0 = opaque, 1 = fully transparent
+    float ior;           // Index of refraction
+    vec3  absorbance;    // Used for semi-translucent objects (Beer-Lambert law)
+    float emissionStrength;
+};
+
+// Emissive triangle matching C++ EmissiveTriangle struct (entries form an alias table)
+struct EmissiveTriangle {
+    vec3 p0; float pdf;
+    vec3 p1; float aliasProbability;
+    vec3 p2; uint alias;
+    vec3 emission; float area;
+};
+
+
+// ------- Shader Resources ------- //
+
+// Buffer reference types for device address access
+layout(buffer_reference, scalar) readonly buffer VertexBuffer {
+    Vertex vertices[];
+};
+
+layout(buffer_reference, scalar) readonly buffer IndexBuffer {
+    uint indices[];
+};
+
+// Uniform 0: Acceleration structure for shadow ray tracing
+layout(binding = 0, set = 0) uniform accelerationStructureEXT TLAS;
+
+// Uniform 1: Storage Image (we dont need that here)
+
+// Uniform 2: Buffer for Scene data
+layout(binding = 2, set = 0) uniform SceneUBO
+{
+	mat4 viewInverse;
+	mat4 projInverse;
+	vec3 camPosition;   uint frameIndex;
+	vec3 lightPosition; uint emissiveTriangleCount;
+    vec3 lightU; float environmentIntensity;
+    vec3 lightV; uint environmentEnabled;
+} scene;
+
+// Uniform 3: Instance data buffer
+layout(binding = 3, set = 0, scalar) readonly buffer InstanceDataBuffer {
+    InstanceData instances[];
+} instanceDataBuffer;
+
+// Uniform 8: Emissive triangles for next event estimation (scene.emissiveTriangleCount entries)
+layout(binding = 8, set = 0, scalar) readonly buffer EmissiveTriangleBuffer {
+    EmissiveTriangle triangles[];
+} emissiveTriangleBuffer;
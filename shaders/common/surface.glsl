@@ -0,0 +1,438 @@
+// Shared surface shading for the non-emissive hit groups.
+// The including hit shader selects its variant at compile time:
+//   MATERIAL_CHECKER    - procedural checkerboard base color
+//   MATERIAL_DIELECTRIC - refraction / transmission (glass)
+// Requires: common/scene.glsl, common/payload.glsl, common/sampling.glsl,
+//           common/environment.glsl, common/pbr.glsl, common/tile.glsl
+
+
+// ------- Ray Payloads ------- //
+
+layout(location = 0) rayPayloadInEXT RayPayload incomingPayload;
+layout(location = 1) rayPayloadEXT float shadowPayload;
+
+hitAttributeEXT vec2 attribs;
+
+
+// ------- Helpers ------- //
+
+struct SurfaceHit {
+    vec3 position;  // World space
+    vec3 normal;    // World space, geometric side (not flipped towards the ray)
+};
+
+SurfaceHit getSurfaceHit(InstanceData instanceData)
+{
+    // Convert uvec2 addresses to uint64_t and create buffer references
+    uint64_t vertexAddr = packUint2x32(instanceData.vertexBufferAddress);
+    uint64_t indexAddr = packUint2x32(instanceData.indexBufferAddress);
+
+    // Get Index/Vertex Buffers
+    VertexBuffer vertexBuffer = VertexBuffer(vertexAddr);
+    IndexBuffer indexBuffer = IndexBuffer(indexAddr);
+
+    // Calculate barycentric coordinates
+    const vec3 barycentricCoords = vec3(1.0f - attribs.x - attribs.y, attribs.x, attribs.y);
+
+    // Get triangle indices
+    const uint primitiveID = gl_PrimitiveID;
+    const uint i0 = indexBuffer.indices[primitiveID * 3 + 0];
+    const uint i1 = indexBuffer.indices[primitiveID * 3 + 1];
+    const uint i2 = indexBuffer.indices[primitiveID * 3 + 2];
+
+    // Get vertices
+    const Vertex v0 = vertexBuffer.vertices[i0];
+    const Vertex v1 = vertexBuffer.vertices[i1];
+    const Vertex v2 = vertexBuffer.vertices[i2];
+
+    // Interpolate position using barycentric coordinates
+    const vec3 position = v0.pos * barycentricCoords.x +
+                          v1.pos * barycentricCoords.y +
+                          v2.pos * barycentricCoords.z;
+
+    // Interpolate normal using barycentric coordinates
+    const vec3 normal = normalize(v0.normal * barycentricCoords.x +
+                                  v1.normal * barycentricCoords.y +
+                                  v2.normal * barycentricCoords.z);
+
+    // Transform position and normal to world space
+    SurfaceHit hit;
+    hit.position = vec3(gl_ObjectToWorldEXT * vec4(position, 1.0));
+    hit.normal = normalize(mat3(gl_ObjectToWorldEXT) * normal);
+    return hit;
+}
+
+
+// ------- Direct Lighting ------- //
+
+// Returns 1 if nothing blocks the segment, 0 otherwise
+float traceShadowRay(vec3 origin, vec3 direction, float maxDistance)
+{
+    if (!SHADOW_RAYS) return 1.0;
+
+    shadowPayload = 0.0;
+    traceRayEXT(
+        TLAS,
+        gl_RayFlagsTerminateOnFirstHitEXT | gl_RayFlagsSkipClosestHitShaderEXT,
+        0xFF,
+        0,
+        1,
+        1,                               // Miss Index (Use miss shader index 1 for shadows)
+        origin,
+        0.001,
+        direction,
+        maxDistance,
+        1                                // shadow ray payload is located at layout(location=1)
+    );
+    return shadowPayload;
+}
+
+// Visibility of one point on the key area light (u in [0,1)^2)
+float sampleKeyLight(vec3 worldPosition, vec3 worldNormal, vec2 u)
+{
+    if (!SOFT_SHADOWS) {
+        // Simple hard shadow - single ray cast toward light center
+        vec3 lightDir = scene.lightPosition - worldPosition;
+        float lightDistance = length(lightDir);
+        return traceShadowRay(worldPosition + worldNormal * 0.001, lightDir / lightDistance, lightDistance);
+    }
+
+    // Convert to [-0.5, 0.5] range for centered sampling
+    u = clamp(u - 0.5, -0.49, 0.49);
+
+    // Calculate point on area light
+    vec3 lightSamplePos = scene.lightPosition
+                        + (u.x * scene.lightU)
+                        + (u.y * scene.lightV);
+
+    // Direction and distance to this light sample
+    vec3 L = lightSamplePos - worldPosition;
+    float sampleDistance = length(L);
+    L = normalize(L);
+
+    if (dot(L, worldNormal) <= 0.0) {
+        return 1.0; // Light is behind → treat as fully lit for shadow only
+    }
+    return traceShadowRay(worldPosition + worldNormal * 0.001, L, sampleDistance);
+}
+
+// Picks an emissive triangle proportional to its power (alias table lookup)
+uint pickEmissiveTriangle(float u)
+{
+    uint count = scene.emissiveTriangleCount;
+    float scaled = u * float(count);
+    uint bucket = min(uint(scaled), count - 1);
+    EmissiveTriangle entry = emissiveTriangleBuffer.triangles[bucket];
+    return (scaled - float(bucket)) < entry.aliasProbability ? bucket : entry.alias;
+}
+
+// Radiance reflected towards the viewer from one sampled point on an emissive triangle.
+// lightSampleCount (samples per light type) scales the pdf for the MIS weight of the specular lobe.
+vec3 sampleEmissiveLight(vec3 worldPosition, vec3 worldNormal, vec3 viewDir, vec3 baseColor,
+                         float metallic, float roughness, float lightSampleCount, vec3 u)
+{
+    EmissiveTriangle tri = emissiveTriangleBuffer.triangles[pickEmissiveTriangle(u.x)];
+
+    // Uniform point on the triangle
+    float su = sqrt(u.y);
+    vec3 lightSamplePos = (1.0 - su) * tri.p0 + su * (1.0 - u.z) * tri.p1 + su * u.z * tri.p2;
+
+    vec3 L = lightSamplePos - worldPosition;
+    float distanceSquared = dot(L, L);
+    float sampleDistance = sqrt(distanceSquared);
+    L /= sampleDistance;
+
+    vec3 lightNormal = normalize(cross(tri.p1 - tri.p0, tri.p2 - tri.p0));
+    float cosLight = abs(dot(lightNormal, L));
+    if (dot(L, worldNormal) <= 0.0 || cosLight <= 0.0) return vec3(0.0);
+
+    // Stop short of the emitter so it does not shadow itself
+    float visibility = traceShadowRay(worldPosition + worldNormal * 0.001, L, sampleDistance * 0.999);
+    if (visibility == 0.0) return vec3(0.0);
+
+    // Area pdf (pdf / area) converted to solid angle: pdf * d^2 / (cos * area)
+    float solidAnglePdf = tri.pdf * distanceSquared / (cosLight * tri.area);
+    float specularWeight = powerHeuristic(lightSampleCount * solidAnglePdf,
+                                          specularLobePdf(worldNormal, viewDir, L, roughness));
+    vec3 brdf = evaluateBRDFWeighted(worldNormal, viewDir, L, baseColor, metallic, roughness, specularWeight);
+    return tri.emission * brdf * visibility / solidAnglePdf;
+}
+
+// Radiance reflected towards the viewer from one importance sampled environment direction
+vec3 sampleEnvironmentLight(vec3 worldPosition, vec3 worldNormal, vec3 viewDir, vec3 baseColor,
+                            float metallic, float roughness, float lightSampleCount, vec3 u)
+{
+    vec3 L;
+    float pdf;
+    vec3 radiance = sampleEnvironment(u, L, pdf);
+    if (dot(L, worldNormal) <= 0.0 || pdf <= 0.0) return vec3(0.0);
+
+    float visibility = traceShadowRay(worldPosition + worldNormal * 0.001, L, 10000.0);
+    if (visibility == 0.0) return vec3(0.0);
+
+    float specularWeight = powerHeuristic(lightSampleCount * pdf,
+                                          specularLobePdf(worldNormal, viewDir, L, roughness));
+    vec3 brdf = evaluateBRDFWeighted(worldNormal, viewDir, L, baseColor, metallic, roughness, specularWeight);
+    return radiance * scene.environmentIntensity * brdf * visibility / pdf;
+}
+
+struct DirectLight {
+    float keyVisibility;     // Fraction of the key area light visible (1 = fully lit)
+    vec3 emitted;            // Radiance from emissive triangles and the environment (BRDF and cosine applied)
+    float lightSampleCount;  // Expected samples per emitter / environment type, 0 if neither exists
+};
+
+// Every sample traces the key area light, plus one stochastic light: an emissive triangle picked
+// by power or an environment direction picked by luminance. At most two shadow rays per sample
+// however many lights there are, and the key light never flickers at one sample per pixel.
+DirectLight gatherDirectLight(vec3 worldPosition, vec3 worldNormal, vec3 viewDir, vec3 baseColor,
+                              float metallic, float roughness)
+{
+    DirectLight result;
+    result.keyVisibility = 0.0;
+    result.emitted = vec3(0.0);
+    result.lightSampleCount = 0.0;
+
+    // Emitters and environment share the stochastic shadow ray evenly
+    bool hasEmitters = scene.emissiveTriangleCount > 0;
+    bool hasEnvironment = scene.environmentEnabled != 0u;
+    uint stochasticTypeCount = (hasEmitters ? 1u : 0u) + (hasEnvironment ? 1u : 0u);
+    float selectProbability = 1.0 / float(max(stochasticTypeCount, 1u));
+
+    // Low discrepancy samples (sampler picked by SAMPLER_TYPE).
+    // The sequence continues across frames so temporal accumulation keeps converging.
+    uint numSamples = SOFT_SHADOWS ? SHADOW_GRID_SIZE * SHADOW_GRID_SIZE : 1u;
+    uint dimension = incomingPayload.depth * DIMENSIONS_PER_BOUNCE + DIM_SHADOW;
+    if (stochasticTypeCount > 0u) result.lightSampleCount = float(numSamples) * selectProbability;
+
+    for (uint i = 0; i < numSamples; i++) {
+        vec4 xi = sample4D(tracePixel(), scene.frameIndex * numSamples + i, dimension);
+
+        result.keyVisibility += sampleKeyLight(worldPosition, worldNormal, xi.xy);
+
+        if (stochasticTypeCount == 0u) continue;
+        bool pickEmitter = hasEmitters && (!hasEnvironment || xi.w < 0.5);
+        if (pickEmitter) {
+            result.emitted += sampleEmissiveLight(worldPosition, worldNormal, viewDir, baseColor,
+                                                  metallic, roughness, result.lightSampleCount, xi.xyz) / selectProbability;
+        } else {
+            result.emitted += sampleEnvironmentLight(worldPosition, worldNormal, viewDir, baseColor,
+                                                     metallic, roughness, result.lightSampleCount, xi.xyz) / selectProbability;
+        }
+    }
+
+    result.keyVisibility /= float(numSamples);
+    result.emitted /= float(numSamples);
+    return result;
+}
+
+
+// Traces a secondary radiance ray one level deeper and returns its color. misBsdfPdf > 0 MIS
+// weights the emitters and the environment it reaches against NEE (see RayPayload).
+vec3 traceSecondary(vec3 origin, vec3 direction, float misBsdfPdf)
+{
+    incomingPayload.color = vec3(0.0);
+    incomingPayload.depth += 1;
+    incomingPayload.misBsdfPdf = misBsdfPdf;
+
+    traceRayEXT(
+        TLAS,
+        gl_RayFlagsOpaqueEXT,  // Skip any hit shader for regular rays
+        0xFF,
+        0,
+        1,
+        0,
+        origin,
+        0.001,
+        direction,
+        10000.0,
+        0
+    );
+
+    incomingPayload.depth -= 1;
+    return incomingPayload.color;
+}
+
+
+// ------- Surface Shading ------- //
+
+void shadeSurface()
+{
+    // Get instance data using custom index
+    const InstanceData instanceData = instanceDataBuffer.instances[gl_InstanceCustomIndexEXT];
+
+    // Primary hit info for temporal reprojection
+    if (incomingPayload.depth == 0) {
+        incomingPayload.hitT = gl_HitTEXT;
+        incomingPayload.instanceId = gl_InstanceCustomIndexEXT;
+    }
+
+    const SurfaceHit hit = getSurfaceHit(instanceData);
+    vec3 worldPosition = hit.position;
+    vec3 worldNormal = hit.normal;
+
+    vec3 rayDir = normalize(gl_WorldRayDirectionEXT);
+    float NdotR = dot(worldNormal, rayDir);
+
+    vec3 lightDir = normalize(scene.lightPosition - worldPosition);
+
+    // ------------------------
+    // Direct Lighting & Base Color
+    // ------------------------
+
+    // Base color
+#ifdef MATERIAL_CHECKER
+    // Checkerboard pattern
+    float checkerScale = 1.0;
+    float checker = mod(floor(worldPosition.x * checkerScale) + floor(worldPosition.y * checkerScale) + floor(worldPosition.z * checkerScale), 2.0);
+    vec3 baseColor = mix(vec3(1.0), vec3(0.5), checker);
+#else
+    vec3 baseColor = instanceData.color;
+#endif
+
+    // Denoiser guides for the primary hit
+    if (incomingPayload.depth == 0) {
+        incomingPayload.normal = NdotR < 0.0 ? worldNormal : -worldNormal;
+        incomingPayload.albedo = baseColor;
+    }
+
+    vec3 lightColor = vec3(1.0);
+    vec3 viewDir = normalize(scene.camPosition - worldPosition);
+    vec3 halfVec = normalize(lightDir + viewDir);
+    float NdotL = max(dot(worldNormal, lightDir), 0.0);
+    float NdotV = max(dot(worldNormal, viewDir), 0.0);
+    float HdotV = max(dot(halfVec, viewDir), 0.0);
+
+    // Shadow ray(s)
+    DirectLight direct = gatherDirectLight(worldPosition, worldNormal, viewDir, baseColor,
+                                           instanceData.metallic, instanceData.roughness);
+
+    // Base reflectivity (F0)
+    // 0.04 is a standard value for dielectrics (plastic, wood, etc.)
+    // For metals, the F0 is the albedo color itself.
+    vec3 F0 = vec3(0.04);
+    F0 = mix(F0, baseColor, instanceData.metallic);
+
+    // Cooking-Torrance BRDF components
+    float D = distributionGGX(worldNormal, halfVec, instanceData.roughness);
+    float G = geometrySmith(worldNormal, viewDir, lightDir, instanceData.roughness);
+    vec3 F = fresnelSchlick(HdotV, F0);
+
+    vec3 numerator = D * G * F;
+    float denominator = 4.0 * NdotV * NdotL + 0.001; // prevent divide by zero
+    vec3 specular = numerator / denominator;
+
+    // kD is the ratio of light that gets refracted (diffuse)
+    // Because metals absorb all refracted light, kD is 0.0 for pure metals.
+    vec3 kD = vec3(1.0) - F;
+    kD *= 1.0 - instanceData.metallic;
+
+    // Emitters and the environment reach the surface through NEE and the reflection ray. Their
+    // specular parts are MIS weighted against each other: NEE keeps rough lobes, the reflection
+    // keeps near mirror ones that a light sample can't find. See-through glass has no NEE share.
+#ifdef MATERIAL_DIELECTRIC
+    bool useLightSamples = instanceData.transparency <= 0.0;
+#else
+    bool useLightSamples = true;
+#endif
+
+    // Direct lighting is the light coming directly from the key light and the emissive objects
+    vec3 directLighting = (kD * baseColor / PI + specular) * lightColor * NdotL * direct.keyVisibility
+                        + (useLightSamples ? direct.emitted : vec3(0.0));
+
+
+    // Terminate recursion at max depth: this hit's shadow rays are already the deepest traces
+    // the pipeline allows (maxPipelineRayRecursionDepth = MAX_RECURSION_DEPTH + 2)
+    if (incomingPayload.depth >= MAX_RECURSION_DEPTH) {
+        incomingPayload.color = directLighting;
+        return;
+    }
+
+    float NdotI = dot(worldNormal, rayDir);
+    bool isEntering = NdotI < 0.0;
+    vec3 N = isEntering ? worldNormal : -worldNormal;
+    float refrCosTheta = clamp(abs(NdotI), 0.0, 1.0);
+
+    // ------------------------
+    // Reflection
+    // ------------------------
+
+    vec3 reflectedDir = reflect(rayDir, N);
+    float reflectionPdf = 0.0;
+    if (useLightSamples && direct.lightSampleCount > 0.0) {
+        reflectionPdf = specularLobePdf(worldNormal, viewDir, reflectedDir, instanceData.roughness)
+                      / direct.lightSampleCount;
+    }
+    vec3 reflectColor = traceSecondary(worldPosition + N * 0.001, reflectedDir, reflectionPdf);
+
+    // ------------------------
+    // Diffuse Ambient
+    // ------------------------
+
+    vec3 ambientUp = vec3(0.1, 0.1, 0.1) * 0.25; // Sky color
+    vec3 ambientDown = vec3(0.1, 0.1, 0.1) * 0.15; // Ground color
+
+    float hemiMix = smoothstep(-1.0, 1.0, worldNormal.y);
+    vec3 ambientLight = mix(ambientDown, ambientUp, hemiMix);
+
+    vec3 diffuseAmbient = vec3(0.0);
+    if (incomingPayload.depth == 0 && scene.environmentEnabled == 0u) {
+        // Only add ambient at the primary ray level to avoid over-brightening
+        // (an environment map replaces it with importance sampled sky light)
+        diffuseAmbient = kD * (baseColor * ambientLight);
+    }
+
+    vec3 kS = fresnelSchlick(refrCosTheta, F0); // Reflection weight
+
+#ifdef MATERIAL_DIELECTRIC
+    // ------------------------
+    // Refraction and transparency
+    // ------------------------
+
+    // If entering: Normal is fine. Ratio is 1.0/IOR
+    // If exiting: Flip normal. Ratio is IOR/1.0
+    float ior = instanceData.ior;
+    float eta = isEntering ? (1.0 / ior) : (ior / 1.0);
+
+    vec3 transmissionColor = vec3(0.0);
+    float transmission = instanceData.transparency;
+    vec3 kT = (vec3(1.0) - kS) * transmission;  // Transmission weight
+
+    // Snell's Law
+    vec3 refractDir = refract(rayDir, N, eta);
+
+    // Handle Total Internal Reflection (TIR)
+    // If the angle is too shallow (like looking up from underwater),
+    // light cannot escape. refract() returns vec3(0.0) in this case.
+    bool isTIR = length(refractDir) == 0.0;
+
+    if (!isTIR) {
+        // Offset slightly inside the surface
+        transmissionColor = traceSecondary(worldPosition + refractDir * 0.005, normalize(refractDir), 0.0);
+
+        // Beer's Law for attenuation (semi-translucent materials)
+        if (!isEntering) {
+            float distance = gl_HitTEXT;
+            vec3 transmissionCoeff = exp(-instanceData.absorbance * distance);
+            transmissionColor *= transmissionCoeff;
+        }
+    }
+    else {
+        // If TIR happens, 100% of the light reflects.
+        kS = vec3(1.0);
+        kT = vec3(0.0);
+    }
+
+    // ------------------------ //
+    // Combining everything
+    // ------------------------ //
+
+    vec3 finalOpaque = directLighting + (reflectColor * kS) + diffuseAmbient;           // Diffuse + specular, reflection + ambient
+    vec3 finalGlass = specular * lightColor * NdotL + (transmissionColor * kT) + (reflectColor * kS); // Specular, reflection + refraction
+
+    incomingPayload.color = mix(finalOpaque, finalGlass, transmission);
+#else
+    // Opaque: direct lighting + reflection + ambient
+    incomingPayload.color = directLighting + (reflectColor * kS) + diffuseAmbient;
+#endif
+}
@@ -0,0 +1,17 @@
+// Image tile covered by the current trace dispatch (tiled dispatch mode).
+// The launch size is only the tile; a full-frame dispatch uses a zero offset.
+// Requires: GL_EXT_ray_tracing
+
+
+// ------- Push Constants ------- //
+
+layout(push_constant) uniform TraceTile {
+	uvec2 offset;     // First pixel of the tile
+	uvec2 imageSize;  // Full trace extent
+} traceTile;
+
+
+// Pixel of the storage image written by this invocation
+uvec2 tracePixel() {
+	return gl_LaunchIDEXT.xy + traceTile.offset;
+}
@@ -0,0 +1,80 @@
+#include "core/BatchRenderer.h"
+
+
+BatchRenderer::BatchRenderer(std::shared_ptr<VulkanContext> ctx, BatchScript script, const LaunchOptions& options)
+    : _script(std::move(script))
+{
+    LaunchOptions batchOptions = options;
+    batchOptions.quality = _script.getQuality().value_or(options.quality);
+    _presenter = std::make_unique<HeadlessPresenter>(std::move(ctx), _script.getExtent(), batchOptions);
+    _presenter->getRenderer().setDenoiserEnabled(_script.getDenoise());
+
+    // The initial scene is the renderer's default until the script says otherwise
+    _activeScene = "teapot";
+}
+
+void BatchRenderer::applyFrameState(const BatchFrameState& state) {
+    RayTracingRenderer& renderer = _presenter->getRenderer();
+
+    if (state.scene != _activeScene) {
+        if (!renderer.setScene(state.scene)) {
+            throw std::runtime_error("Unknown scene in batch script!");
+        }
+        _activeScene = state.scene;
+        _activeMaterial.clear();
+    }
+    if (!state.material.empty() && state.material != _activeMaterial) {
+        // A material held from an earlier keyframe does not apply to a scene without presets
+        if (renderer.getMaterialPresets().empty()) {
+            spdlog::warn("Scene '{}' has no material presets, ignoring material '{}'", state.scene, state.material);
+        } else if (!renderer.setMaterialPreset(state.material)) {
+            spdlog::error("Unknown material preset '{}' in batch script!", state.material);
+            throw std::runtime_error("Unknown material preset in batch script!");
+        }
+        _activeMaterial = state.material;
+    }
+
+    renderer.setCameraOrbit(state.cameraRadius, state.cameraAzimuth, state.cameraElevation);
+}
+
+void BatchRenderer::run() {
+    RayTracingRenderer& renderer = _presenter->getRenderer();
+    const uint32_t frameCount = _script.getFrameCount();
+
+    uint64_t totalSamples = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    auto lastReport = start;
+
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+        const BatchFrameState state = _script.evaluate(frame);
+        applyFrameState(state);
+
+        // Scene time only advances between output frames, accumulation samples see the same instant
+        for (uint32_t sample = 0; sample < state.samples; sample++) {
+            renderer.setFixedTimeStep((sample == 0 && frame > 0) ? _script.getFrameTime() : 0.0f);
+            renderer.setAccumulationSample(sample);
+
+            const bool lastSample = sample + 1 == state.samples;
+            _presenter->renderFrame(lastSample ? _script.getOutputPath(frame) : std::string());
+        }
+        totalSamples += state.samples;
+
+        // Progress (throttled, always on the last frame)
+        auto now = std::chrono::high_resolution_clock::now();
+        if (now - lastReport > std::chrono::seconds(2) || frame + 1 == frameCount) {
+            lastReport = now;
+            const float minutes = std::chrono::duration<float, std::ratio<60>>(now - start).count();
+            const float framesPerMinute = minutes > 0.0f ? static_cast<float>(frame + 1) / minutes : 0.0f;
+            const float etaSeconds = framesPerMinute > 0.0f ? (frameCount - frame - 1) / framesPerMinute * 60.0f : 0.0f;
+            spdlog::info("Batch: frame {}/{} ({:.0f}%), {:.1f} frames/min, ETA {:.0f}s, {} image(s) encoding",
+                frame + 1, frameCount, 100.0f * (frame + 1) / frameCount, framesPerMinute, etaSeconds,
+                _presenter->getImageEncoder().getPendingCount());
+        }
+    }
+
+    _presenter->finish();
+
+    const float seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - start).count();
+    spdlog::info("Batch finished: {} frames ({} trace samples) in {:.1f}s, {:.1f} frames/min",
+        frameCount, totalSamples, seconds, seconds > 0.0f ? frameCount / seconds * 60.0f : 0.0f);
+}
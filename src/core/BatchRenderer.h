@@ -0,0 +1,26 @@
+#pragma once
+
+#include "stdafx.h"
+#include "core/BatchScript.h"
+#include "core/HeadlessPresenter.h"
+#include "core/LaunchOptions.h"
+
+// Renders a keyframe script to an image sequence without a window.
+// Frames are pipelined: while the GPU traces frame N (up to the pacer depth submissions deep)
+// the CPU already updates the scene for the next one, and finished frames are read back and
+// encoded on worker threads.
+class BatchRenderer {
+public:
+    BatchRenderer(std::shared_ptr<VulkanContext> ctx, BatchScript script, const LaunchOptions& options = LaunchOptions());
+
+    void run();
+
+private:
+    BatchScript _script;
+    std::unique_ptr<HeadlessPresenter> _presenter;
+
+    // Last applied held state, scene and material switches are expensive (device idle + rebuild)
+    std::string _activeScene;
+    std::string _activeMaterial;
+    void applyFrameState(const BatchFrameState& state);
+};
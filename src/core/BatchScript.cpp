@@ -0,0 +1,158 @@
+#include "core/BatchScript.h"
+#include "utils/ImageWriter.h"
+
+
+BatchScript BatchScript::load(const std::string& scriptPath) {
+    std::ifstream file(scriptPath);
+    if (!file.is_open()) {
+        spdlog::error("Failed to open batch script: {}", scriptPath);
+        throw std::runtime_error("Failed to open batch script!");
+    }
+
+    BatchScript script;
+    std::optional<uint32_t> explicitFrameCount;
+    Keyframe* current = &script._defaults;
+
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        // '#' starts a comment at the line start or after whitespace ('####' in paths is a placeholder)
+        for (size_t i = 0; i < line.size(); i++) {
+            if (line[i] == '#' && (i == 0 || std::isspace(static_cast<unsigned char>(line[i - 1])))) {
+                line.resize(i);
+                break;
+            }
+        }
+
+        std::istringstream stream(line);
+        std::string directive;
+        if (!(stream >> directive)) continue;
+
+        auto fail = [&](const std::string& message) {
+            spdlog::error("{}:{}: {}", scriptPath, lineNumber, message);
+            throw std::runtime_error("Invalid batch script!");
+        };
+
+        if (directive == "output") {
+            if (!(stream >> script._outputPattern)) fail("output expects a path");
+            if (!ImageWriter::isSupported(script._outputPattern)) fail("output must end in .png or .ppm");
+        } else if (directive == "size") {
+            std::string value;
+            unsigned int width = 0, height = 0;
+            if (!(stream >> value) || std::sscanf(value.c_str(), "%ux%u", &width, &height) != 2 || width == 0 || height == 0)
+                fail("size expects WxH");
+            script._extent = { width, height };
+        } else if (directive == "quality") {
+            std::string value;
+            stream >> value;
+            auto preset = Quality::fromString(value);
+            if (!preset) fail(fmt::format("unknown quality preset '{}'", value));
+            script._quality = preset.value();
+        } else if (directive == "fps") {
+            if (!(stream >> script._fps) || script._fps <= 0.0f) fail("fps expects a positive number");
+        } else if (directive == "denoise") {
+            std::string value;
+            stream >> value;
+            if (value != "on" && value != "off") fail("denoise expects on or off");
+            script._denoise = value == "on";
+        } else if (directive == "frames") {
+            uint32_t frames = 0;
+            if (!(stream >> frames) || frames == 0) fail("frames expects a positive integer");
+            explicitFrameCount = frames;
+        } else if (directive == "keyframe") {
+            Keyframe keyframe;
+            if (!(stream >> keyframe.frame)) fail("keyframe expects a frame number");
+            if (!script._keyframes.empty() && keyframe.frame <= script._keyframes.back().frame)
+                fail("keyframes must be in increasing frame order");
+            script._keyframes.push_back(keyframe);
+            current = &script._keyframes.back();
+        } else if (directive == "scene") {
+            std::string value;
+            if (!(stream >> value)) fail("scene expects a name");
+            current->scene = value;
+        } else if (directive == "material") {
+            std::string value;
+            if (!(stream >> value)) fail("material expects a preset name");
+            current->material = value;
+        } else if (directive == "samples") {
+            uint32_t samples = 0;
+            if (!(stream >> samples) || samples == 0) fail("samples expects a positive integer");
+            current->samples = samples;
+        } else if (directive == "camera") {
+            glm::vec3 camera;
+            if (!(stream >> camera.x >> camera.y >> camera.z)) fail("camera expects radius azimuth elevation");
+            current->camera = camera;
+        } else {
+            fail(fmt::format("unknown directive '{}'", directive));
+        }
+    }
+
+    script._frameCount = explicitFrameCount.value_or(script._keyframes.empty() ? 1 : script._keyframes.back().frame + 1);
+    spdlog::info("Batch script {}: {} frames at {}x{}, {} keyframes", scriptPath,
+        script._frameCount, script._extent.width, script._extent.height, script._keyframes.size());
+    return script;
+}
+
+BatchFrameState BatchScript::evaluate(uint32_t frame) const {
+    BatchFrameState state;
+
+    // Held properties: the last definition at or before this frame wins
+    auto applyHeld = [&state](const Keyframe& keyframe) {
+        if (keyframe.scene) state.scene = keyframe.scene.value();
+        if (keyframe.material) state.material = keyframe.material.value();
+        if (keyframe.samples) state.samples = keyframe.samples.value();
+    };
+    applyHeld(_defaults);
+    for (const auto& keyframe : _keyframes) {
+        if (keyframe.frame > frame) break;
+        applyHeld(keyframe);
+    }
+
+    // Camera: linear between the surrounding keyframes that set it
+    const Keyframe* previous = _defaults.camera ? &_defaults : nullptr;
+    const Keyframe* next = nullptr;
+    for (const auto& keyframe : _keyframes) {
+        if (!keyframe.camera) continue;
+        if (keyframe.frame <= frame) {
+            previous = &keyframe;
+        } else {
+            next = &keyframe;
+            break;
+        }
+    }
+
+    glm::vec3 camera(state.cameraRadius, state.cameraAzimuth, state.cameraElevation);
+    if (previous && next && previous != &_defaults) {
+        float t = static_cast<float>(frame - previous->frame) / static_cast<float>(next->frame - previous->frame);
+        camera = glm::mix(previous->camera.value(), next->camera.value(), t);
+    } else if (previous) {
+        camera = previous->camera.value();
+    } else if (next) {
+        camera = next->camera.value();
+    }
+    state.cameraRadius = camera.x;
+    state.cameraAzimuth = camera.y;
+    state.cameraElevation = camera.z;
+
+    return state;
+}
+
+std::string BatchScript::getOutputPath(uint32_t frame) const {
+    std::string path = _outputPattern;
+
+    // Only look at the file name, directories may legitimately contain '#'
+    const size_t nameStart = path.find_last_of("/\\") + 1;
+    const size_t first = path.find('#', nameStart);
+    if (first == std::string::npos) {
+        // No placeholder: number the frames before the extension
+        const size_t dot = path.find_last_of('.');
+        return path.substr(0, dot) + fmt::format("_{:04d}", frame) + path.substr(dot);
+    }
+
+    size_t last = first;
+    while (last < path.size() && path[last] == '#') last++;
+    std::string number = std::to_string(frame);
+    if (number.size() < last - first) number.insert(0, last - first - number.size(), '0');
+    return path.substr(0, first) + number + path.substr(last);
+}
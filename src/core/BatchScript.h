@@ -0,0 +1,63 @@
+#pragma once
+#include "stdafx.h"
+#include "scene/QualityPreset.h"
+
+// Keyframe script for offline image sequences. Plain text, one directive per line,
+// '#' after whitespace starts a comment:
+//
+//   output   renders/shot_####.png     # '#' run is replaced by the zero padded frame number
+//   size     1280x720
+//   quality  final                     # draft | interactive | final (default: --quality)
+//   fps      24                        # Scene animation time step per output frame
+//   denoise  off                       # on | off, reference renders stay unfiltered (default: off)
+//   frames   120                       # Optional, defaults to the last keyframe + 1
+//
+//   keyframe 0                         # Properties below apply from this frame on
+//   scene    teapot                    # teapot | spheres                  (held)
+//   material glass                     # Scene material preset             (held)
+//   samples  16                        # Accumulated trace frames / image  (held)
+//   camera   16 0.0 -0.6               # Orbit radius, azimuth, elevation  (interpolated)
+//
+// Directives before the first keyframe are global; scene, material, samples and camera given
+// there act as defaults. A held material is ignored by scenes without material presets.
+struct BatchFrameState {
+    float cameraRadius = 16.0f;
+    float cameraAzimuth = 0.0f;
+    float cameraElevation = -0.6f;
+    std::string scene = "teapot";
+    std::string material;       // Empty = scene default
+    uint32_t samples = 16;
+};
+
+class BatchScript {
+public:
+    static BatchScript load(const std::string& scriptPath);
+
+    uint32_t getFrameCount() const { return _frameCount; }
+    VkExtent2D getExtent() const { return _extent; }
+    std::optional<QualityPreset> getQuality() const { return _quality; }
+    float getFrameTime() const { return 1.0f / _fps; }
+    bool getDenoise() const { return _denoise; }
+
+    BatchFrameState evaluate(uint32_t frame) const;
+    std::string getOutputPath(uint32_t frame) const;
+
+private:
+    struct Keyframe {
+        uint32_t frame = 0;
+        std::optional<glm::vec3> camera;  // radius, azimuth, elevation
+        std::optional<std::string> scene;
+        std::optional<std::string> material;
+        std::optional<uint32_t> samples;
+    };
+
+    std::string _outputPattern = "frame_####.png";
+    VkExtent2D _extent = { 1920, 1080 };
+    std::optional<QualityPreset> _quality;
+    float _fps = 24.0f;
+    bool _denoise = false;
+    uint32_t _frameCount = 0;
+
+    Keyframe _defaults;               // Global section, acts like a keyframe at -infinity
+    std::vector<Keyframe> _keyframes; // Sorted by frame
+};
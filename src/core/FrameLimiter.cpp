@@ -0,0 +1,30 @@
+#include "core/FrameLimiter.h"
+#include "utils/CpuProfiler.h"
+
+
+bool FrameLimiter::isIdle() const {
+    if (_idleFps <= 0.0f) return false;
+    return std::chrono::duration<float>(Clock::now() - _lastInput).count() > _idleTimeoutSeconds;
+}
+
+void FrameLimiter::wait() {
+    // The lower of both caps applies while idle
+    float fps = _targetFps;
+    if (isIdle()) fps = fps > 0.0f ? std::min(fps, _idleFps) : _idleFps;
+    if (fps <= 0.0f) {
+        _lastFrame = Clock::now();
+        return;
+    }
+
+    PROFILE_SCOPE("FrameLimiter::wait");
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    const Clock::time_point deadline = _lastFrame + period;
+
+    // Coarse sleep first (the OS may overshoot), then yield until the deadline
+    if (deadline - SPIN_THRESHOLD > Clock::now()) std::this_thread::sleep_until(deadline - SPIN_THRESHOLD);
+    while (Clock::now() < deadline) std::this_thread::yield();
+
+    // A frame that ran over its period restarts the cadence instead of bursting to catch up
+    const Clock::time_point now = Clock::now();
+    _lastFrame = now - deadline > period ? now : deadline;
+}
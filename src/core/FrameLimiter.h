@@ -0,0 +1,36 @@
+#pragma once
+#include "stdafx.h"
+
+
+// Caps the frame rate on the CPU. The wait runs after present, right before the next frame polls
+// input, so it does not add input latency to the frame that follows. An optional lower idle rate
+// kicks in when no input arrived for a while (saves power on displays left running).
+class FrameLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 0 disables the respective cap
+    void setTargetFps(float fps) { _targetFps = std::max(fps, 0.0f); }
+    float getTargetFps() const { return _targetFps; }
+    void setIdleFps(float fps) { _idleFps = std::max(fps, 0.0f); }
+    float getIdleFps() const { return _idleFps; }
+    void setIdleTimeout(float seconds) { _idleTimeoutSeconds = std::max(seconds, 0.0f); }
+    float getIdleTimeout() const { return _idleTimeoutSeconds; }
+
+    // Any user input leaves idle mode
+    void notifyInput() { _lastInput = Clock::now(); }
+    bool isIdle() const;
+
+    // Sleeps until the next frame is due under the active cap
+    void wait();
+
+private:
+    float _targetFps = 0.0f;
+    float _idleFps = 0.0f;
+    float _idleTimeoutSeconds = 5.0f;
+
+    Clock::time_point _lastInput = Clock::now();
+    Clock::time_point _lastFrame{};
+
+    static constexpr auto SPIN_THRESHOLD = std::chrono::microseconds(1000);  // Sleep overshoot covered by yielding
+};
@@ -0,0 +1,78 @@
+#include "core/FramePacer.h"
+#include "utils/CpuProfiler.h"
+
+
+FramePacer::FramePacer(std::shared_ptr<VulkanContext> ctx, uint32_t depth)
+    : _ctx(std::move(ctx)), _depth(std::clamp<uint32_t>(depth, 1, MAX_FRAMES_IN_FLIGHT))
+{
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(_ctx->device, &semaphoreInfo, nullptr, &_timeline) != VK_SUCCESS) {
+        spdlog::error("Failed to create frame timeline semaphore!");
+        throw std::runtime_error("Failed to create frame timeline semaphore!");
+    }
+
+    spdlog::info("Frames in flight: {}", _depth);
+}
+
+FramePacer::~FramePacer() {
+    waitIdle();
+    vkDestroySemaphore(_ctx->device, _timeline, nullptr);
+}
+
+uint32_t FramePacer::beginFrame() {
+    _frameValue++;
+    if (_frameValue > _depth) {
+        PROFILE_SCOPE("FramePacer::wait");
+        waitForValue(_frameValue - _depth);
+    }
+    return getFrameSlot();
+}
+
+VkTimelineSemaphoreSubmitInfo FramePacer::makeSubmitInfo(const std::vector<uint64_t>& waitValues, uint32_t binarySignalCount) {
+    _waitValues = waitValues;
+    _signalValues.assign(binarySignalCount + 1, 0);
+    _signalValues.back() = _frameValue;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(_waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = _waitValues.empty() ? nullptr : _waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(_signalValues.size());
+    timelineInfo.pSignalSemaphoreValues = _signalValues.data();
+    return timelineInfo;
+}
+
+uint64_t FramePacer::getCompletedValue() const {
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(_ctx->device, _timeline, &value);
+    return value;
+}
+
+void FramePacer::waitForValue(uint64_t value) const {
+    if (value == 0) return;
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &_timeline;
+    waitInfo.pValues = &value;
+    vkWaitSemaphores(_ctx->device, &waitInfo, UINT64_MAX);
+}
+
+void FramePacer::setDepth(uint32_t depth) {
+    depth = std::clamp<uint32_t>(depth, 1, MAX_FRAMES_IN_FLIGHT);
+    if (depth == _depth) return;
+
+    // Slot mapping changes with the depth, so nothing may still be using the old slots
+    waitIdle();
+    _depth = depth;
+    spdlog::info("Frames in flight: {}", _depth);
+}
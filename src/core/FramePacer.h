@@ -0,0 +1,51 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/VulkanContext.h"
+
+
+// Frame pacing on a single timeline semaphore. Frame N (counting from 1) signals value N when its
+// submission completes; before frame N is recorded the CPU waits for value N - depth, which frees
+// the per-frame resources of slot N % depth. depth (1..MAX_FRAMES_IN_FLIGHT) trades input latency
+// for throughput and can be changed at runtime.
+class FramePacer {
+public:
+    FramePacer(std::shared_ptr<VulkanContext> ctx, uint32_t depth = DEFAULT_FRAMES_IN_FLIGHT);
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Waits until the next frame's slot is free and returns that slot
+    uint32_t beginFrame();
+    // The begun frame will not be submitted (e.g. swapchain out of date), hand its value back
+    void cancelFrame() { _frameValue--; }
+
+    // Timeline value the current frame must signal on submit (see makeSubmitInfo)
+    uint64_t getFrameValue() const { return _frameValue; }
+    uint32_t getFrameSlot() const { return static_cast<uint32_t>(_frameValue % _depth); }
+    VkSemaphore getTimelineSemaphore() const { return _timeline; }
+
+    // Fills a timeline submit info that signals the current frame's value as the last signal
+    // semaphore. binarySignalCount binary semaphores come before it in pSignalSemaphores.
+    // waitValues has one entry per wait semaphore (timeline values, 0 for binary semaphores).
+    VkTimelineSemaphoreSubmitInfo makeSubmitInfo(const std::vector<uint64_t>& waitValues, uint32_t binarySignalCount);
+
+    uint64_t getCompletedValue() const;
+    void waitForValue(uint64_t value) const;
+    void waitIdle() const { waitForValue(_frameValue); }   // All submitted frames
+
+    // Drains the frames in flight and switches the slot count
+    void setDepth(uint32_t depth);
+    uint32_t getDepth() const { return _depth; }
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+    VkSemaphore _timeline = VK_NULL_HANDLE;
+    uint32_t _depth;
+    uint64_t _frameValue = 0;   // Value of the frame being recorded (last one handed out by beginFrame)
+
+    // Storage for makeSubmitInfo (binary semaphore entries are ignored by Vulkan)
+    std::vector<uint64_t> _waitValues;
+    std::vector<uint64_t> _signalValues;
+};
@@ -1,24 +1,45 @@
 #include "core/FramePresenter.h"
 #include "vulkan/SwapChain.h"
 #include "scene/RayTracingRenderer.h"
+#include "gui/FontAwesome.h"
+#include "vulkan/GpuProfiler.h"
 
-FramePresenter::FramePresenter(std::shared_ptr<VulkanContext> ctx)
-    : _ctx(std::move(ctx))
+FramePresenter::FramePresenter(std::shared_ptr<VulkanContext> ctx, const LaunchOptions& options)
+    : _ctx(std::move(ctx)), _gpuProfilePath(options.gpuProfilePath), _tracePath(options.tracePath)
 {
-    spdlog::info("Max Frames in flight: {}", MAX_FRAMES_IN_FLIGHT);
+    _pacer = std::make_unique<FramePacer>(_ctx, options.framesInFlight.value_or(DEFAULT_FRAMES_IN_FLIGHT));
 
-    _swapChain = std::make_shared<SwapChain>(_ctx);
-    _renderer = std::make_unique<RayTracingRenderer>(_ctx, _swapChain);
+    _frameLimiter.setTargetFps(options.fpsLimit);
+
+    _swapChain = std::make_shared<SwapChain>(_ctx, options.presentMode.value_or(VK_PRESENT_MODE_MAILBOX_KHR));
+    _renderer = std::make_unique<RayTracingRenderer>(_ctx, _swapChain, options);
     _gui = std::make_unique<GUI>(_ctx, _ctx->window, _swapChain->getSwapChainImageFormat());
 
     createCommandBuffers();
     createSyncObjects();
     createFramebuffers();
+
+    _readbackRing = std::make_unique<ReadbackRing>(_ctx, _swapChain->getSwapChainExtent());
+    _imageEncoder = std::make_unique<ImageEncoder>();
 }
 
 FramePresenter::~FramePresenter() {
     // Wait for any unfinished GPU tasks
     vkDeviceWaitIdle(_ctx->device);
+    _pacer.reset();
+
+    if (GpuProfiler* profiler = _renderer->getGpuProfiler()) {
+        profiler->collectAll();
+        if (!_gpuProfilePath.empty()) profiler->exportFile(_gpuProfilePath);
+        if (!_tracePath.empty()) profiler->writeChromeTrace(_tracePath);
+    } else if (!_tracePath.empty()) {
+        CpuProfiler::writeChromeTrace(_tracePath);
+    }
+
+    // Flush captures still in the ring, the encoder finishes its queue on destruction
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) collectCapture(i);
+    _imageEncoder.reset();
+    _readbackRing.reset();
 
     destroySyncObjects();
     destroyFramebuffers();
@@ -67,27 +88,20 @@ void FramePresenter::destroyFramebuffers() {
 }
 
 void FramePresenter::createSyncObjects() {
-    _imageAvailableSemaphores.resize(_swapChain->getSwapChainImageCount());
+    _imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
     _renderFinishedSemaphores.resize(_swapChain->getSwapChainImageCount());
-    _inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; //Initially signaled
-
-    for (size_t i = 0; i < _swapChain->getSwapChainImageCount(); i++) {
-        if (vkCreateSemaphore(_ctx->device, &semaphoreInfo, nullptr, &_imageAvailableSemaphores[i]) != VK_SUCCESS ||
-            vkCreateSemaphore(_ctx->device, &semaphoreInfo, nullptr, &_renderFinishedSemaphores[i]) != VK_SUCCESS) {
-            spdlog::error("Failed to create semaphores for swap chain image {}!", i);
+    for (auto& semaphore : _imageAvailableSemaphores) {
+        if (vkCreateSemaphore(_ctx->device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+            spdlog::error("Failed to create image available semaphore!");
         }
     }
-
-    for(size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        if (vkCreateFence(_ctx->device, &fenceInfo, nullptr, &_inFlightFences[i]) != VK_SUCCESS) {
-            spdlog::error("Failed to create fences for frame {}!", i);
+    for (auto& semaphore : _renderFinishedSemaphores) {
+        if (vkCreateSemaphore(_ctx->device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+            spdlog::error("Failed to create render finished semaphore!");
         }
     }
 }
@@ -97,11 +111,8 @@ void FramePresenter::destroySyncObjects() {
         vkDestroySemaphore(_ctx->device, sem, nullptr);
     for (auto sem : _renderFinishedSemaphores)
         vkDestroySemaphore(_ctx->device, sem, nullptr);
-    for (auto fence : _inFlightFences)
-        vkDestroyFence(_ctx->device, fence, nullptr);
     _imageAvailableSemaphores.clear();
     _renderFinishedSemaphores.clear();
-    _inFlightFences.clear();
 }
 
 
@@ -109,7 +120,7 @@ void FramePresenter::invalidate() {
     vkDeviceWaitIdle(_ctx->device);
     spdlog::info("Recreating swapchain after window resize.");
 
-    // Destroy semaphores/fences — their count depends on swapchain image count, which may change
+    // Destroy semaphores — their count depends on swapchain image count, which may change
     destroySyncObjects();
 
     // Recreate swapchain with new window dimensions
@@ -118,111 +129,147 @@ void FramePresenter::invalidate() {
 
     createSyncObjects();
 
-    // Reset frame counters
-    _frameCounter = 0;
-    _imageCounter = 0;
-
     // Notify renderer to resize;
     _renderer->onSwapChainRecreated();
 
     // Recreate GUI framebuffers
     destroyFramebuffers();
     createFramebuffers();
+
+    // Readback slots follow the window size (the device is idle, pending captures are complete)
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) collectCapture(i);
+    _readbackRing = std::make_unique<ReadbackRing>(_ctx, _swapChain->getSwapChainExtent());
 }
 
 
 void FramePresenter::present() {
-    // Wait for the previous frame to finish
-    vkWaitForFences(_ctx->device, 1, &_inFlightFences[_frameCounter], VK_TRUE, UINT64_MAX);
+    PROFILE_SCOPE("FramePresenter::present");
+
+    // Change the queue depth between frames (drains the GPU, so every pending capture is ready)
+    if (_pendingFramesInFlight) {
+        _pacer->setDepth(_pendingFramesInFlight.value());
+        _pendingFramesInFlight.reset();
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) collectCapture(i);
+    }
+
+    // Present mode changes need a new swapchain
+    if (_pendingPresentMode) {
+        _swapChain->setPreferredPresentMode(_pendingPresentMode.value());
+        _pendingPresentMode.reset();
+        invalidate();
+    }
+
+    // Wait until the frame that last used this slot has finished (timeline value N - depth)
+    _frameSlot = _pacer->beginFrame();
+
+    // That frame's capture (if any) has landed in host memory, hand it to the encoder
+    collectCapture(_frameSlot);
 
     // Wait for a swap chain image to be available
     uint32_t imageIndex;
-    VkResult result = vkAcquireNextImageKHR(_ctx->device, _swapChain->getSwapChain(), UINT64_MAX, _imageAvailableSemaphores[_imageCounter], VK_NULL_HANDLE, &imageIndex);
+    VkResult result;
+    {
+        PROFILE_SCOPE("vkAcquireNextImageKHR");
+        result = vkAcquireNextImageKHR(_ctx->device, _swapChain->getSwapChain(), UINT64_MAX, _imageAvailableSemaphores[_frameSlot], VK_NULL_HANDLE, &imageIndex);
+    }
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        _pacer->cancelFrame();
         invalidate();
         return;
     } else if (result != VK_SUCCESS) {
         spdlog::error("Failed to acquire swap chain image!");
+        _pacer->cancelFrame();
         return;
     }
 
-    // Reset the fence before drawing
-    vkResetFences(_ctx->device, 1, &_inFlightFences[_frameCounter]);
-    vkResetCommandBuffer(_commandBuffers[_frameCounter], 0);
+    vkResetCommandBuffer(_commandBuffers[_frameSlot], 0);
 
     // Build ImGui frame
-    _gui->beginFrame();
-    _gui->buildUI();
-    _renderer->buildUI();
+    {
+        PROFILE_SCOPE("FramePresenter::buildUI");
+        _gui->beginFrame();
+        _gui->buildUI();
+        _renderer->buildUI();
+        buildUI();
+    }
 
-    // Update Renderer
-    _renderer->update(_frameCounter);
+    // Update Renderer (applies all input received so far)
+    _latencyMonitor.beginFrame();
+    _renderer->setFrameTimeline(_pacer->getTimelineSemaphore(), _pacer->getFrameValue());
+    _renderer->update(_frameSlot);
 
     // Record everything into command buffer
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    vkBeginCommandBuffer(_commandBuffers[_frameCounter], &beginInfo);
+    vkBeginCommandBuffer(_commandBuffers[_frameSlot], &beginInfo);
 
-    VkCommandBuffer cb = _commandBuffers[_frameCounter];
+    VkCommandBuffer cb = _commandBuffers[_frameSlot];
+    GpuProfiler* profiler = _renderer->getGpuProfiler();
 
     _renderer->recordToCommandBuffer(cb, imageIndex);
 
-    // Blit storage image → swapchain, then transition for ImGui render pass
-    VulkanHelper::transitionImageLayout(_ctx, cb,
-        _swapChain->getSwapChainImages()[imageIndex],
-        { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 },
-        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    // The renderer resolved the frame into the swapchain image (GENERAL layout)
+    VkImage swapChainImage = _swapChain->getSwapChainImages()[imageIndex];
+    VkExtent2D dstExtent = _swapChain->getSwapChainExtent();
+    const VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+    // Read back the scene without the GUI, from the renderer's tonemapped output
+    if (_screenshotRequested || _recording) {
+        GpuProfiler::Scope scope(profiler, cb, "Readback");
+        VkImage outputImage = _renderer->getOutputImage();
+        VulkanHelper::transitionImageLayout(_ctx, cb, outputImage, range,
+            VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        _readbackRing->recordCopy(cb, _frameSlot, outputImage, _renderer->getOutputExtent(), nextCapturePath());
+        VulkanHelper::transitionImageLayout(_ctx, cb, outputImage, range,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+        _screenshotRequested = false;
+    }
+
+    // Transition for ImGui render pass
+    VulkanHelper::transitionImageLayout(_ctx, cb, swapChainImage, range,
+        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
-    VulkanHelper::transitionImageLayout(_ctx, cb,
-        _renderer->getOutputImage(),
-        { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 },
-        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    {
+        GpuProfiler::Scope scope(profiler, cb, "GUI");
+        _gui->recordToCommandBuffer(cb, _framebuffers[imageIndex], dstExtent);
+    }
 
-    VkExtent2D srcExtent = _renderer->getOutputExtent();
-    VkExtent2D dstExtent = _swapChain->getSwapChainExtent();
-    VkImageBlit blitRegion{};
-    blitRegion.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
-    blitRegion.srcOffsets[1]  = { (int32_t)srcExtent.width, (int32_t)srcExtent.height, 1 };
-    blitRegion.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
-    blitRegion.dstOffsets[1]  = { (int32_t)dstExtent.width, (int32_t)dstExtent.height, 1 };
-    vkCmdBlitImage(cb,
-        _renderer->getOutputImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-        _swapChain->getSwapChainImages()[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1, &blitRegion, VK_FILTER_LINEAR);
-
-    VulkanHelper::transitionImageLayout(_ctx, cb,
-        _swapChain->getSwapChainImages()[imageIndex],
-        { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 },
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-
-    VulkanHelper::transitionImageLayout(_ctx, cb,
-        _renderer->getOutputImage(),
-        { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 },
-        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
-
-    _gui->recordToCommandBuffer(cb, _framebuffers[imageIndex], dstExtent);
-
-    vkEndCommandBuffer(_commandBuffers[_frameCounter]);
+    vkEndCommandBuffer(_commandBuffers[_frameSlot]);
 
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkSemaphore waitSemaphores[] = {_imageAvailableSemaphores[_imageCounter]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
+    // Swapchain image + work the renderer queued on other queues for this frame
+    std::vector<VkSemaphore> waitSemaphores = {_imageAvailableSemaphores[_frameSlot]};
+    std::vector<VkPipelineStageFlags> waitStages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    std::vector<uint64_t> waitValues = {0};
+    for (const Renderer::SubmitWait& wait : _renderer->takeSubmitWaits()) {
+        waitSemaphores.push_back(wait.semaphore);
+        waitStages.push_back(wait.stageMask);
+        waitValues.push_back(wait.value);
+    }
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
 
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &_commandBuffers[_frameCounter];
+    submitInfo.pCommandBuffers = &_commandBuffers[_frameSlot];
 
-    VkSemaphore signalSemaphores[] = {_renderFinishedSemaphores[_imageCounter]};
-    submitInfo.signalSemaphoreCount = 1;
+    // Binary semaphore for present + this frame's timeline value
+    VkSemaphore signalSemaphores[] = {_renderFinishedSemaphores[imageIndex], _pacer->getTimelineSemaphore()};
+    submitInfo.signalSemaphoreCount = 2;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
-    if (vkQueueSubmit(_ctx->graphicsQueue, 1, &submitInfo, _inFlightFences[_frameCounter]) != VK_SUCCESS) {
+    VkTimelineSemaphoreSubmitInfo timelineInfo = _pacer->makeSubmitInfo(waitValues, 1);
+    submitInfo.pNext = &timelineInfo;
+
+    PROFILE_SCOPE("FramePresenter::submitAndPresent");
+    std::unique_lock<std::mutex> queueLock(_ctx->queueMutex);
+    if (vkQueueSubmit(_ctx->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
         spdlog::error("Failed to submit draw command buffer!");
+        _pacer->cancelFrame();
+        _latencyMonitor.cancelFrame();
         return;
     }
 
@@ -230,7 +277,7 @@ void FramePresenter::present() {
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores;
+    presentInfo.pWaitSemaphores = &_renderFinishedSemaphores[imageIndex];
 
     VkSwapchainKHR swapChains[] = {_swapChain->getSwapChain()};
     presentInfo.swapchainCount = 1;
@@ -239,6 +286,8 @@ void FramePresenter::present() {
     presentInfo.pResults = nullptr; // Optional
 
     result = vkQueuePresentKHR(_ctx->presentQueue, &presentInfo);
+    queueLock.unlock();
+    _latencyMonitor.onPresent();
 
     if(result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
         invalidate();
@@ -246,8 +295,118 @@ void FramePresenter::present() {
         spdlog::error("Failed to present swap chain image!");
     }
 
-    _frameCounter = (_frameCounter + 1) % MAX_FRAMES_IN_FLIGHT;
-    _imageCounter = (_imageCounter + 1) % _swapChain->getSwapChainImageCount();
+    // Hold back the next frame (and its input polling) under the frame rate cap
+    _frameLimiter.wait();
+}
+
+void FramePresenter::buildUI() {
+    // Appended to the renderer's panel
+    ImGui::Begin("Scene Controls");
+    ImGui::Separator();
+    ImGui::Text(ICON_FA_LAYER_GROUP " Frame Pacing");
+    ImGui::Indent(16.0f);
+        int depth = static_cast<int>(_pacer->getDepth());
+        if (ImGui::SliderInt("Frames in Flight", &depth, 1, MAX_FRAMES_IN_FLIGHT)) {
+            // Applied before the next frame begins, when nothing of this frame is recorded yet
+            _pendingFramesInFlight = static_cast<uint32_t>(depth);
+        }
+        ImGui::TextDisabled("Frame %llu, GPU done %llu", (unsigned long long)_pacer->getFrameValue(), (unsigned long long)_pacer->getCompletedValue());
+
+        // Modes the surface does not support are not listed
+        VkPresentModeKHR currentMode = _swapChain->getPresentMode();
+        if (ImGui::BeginCombo("Present Mode", SwapChain::presentModeToString(currentMode))) {
+            for (VkPresentModeKHR mode : _swapChain->getAvailablePresentModes()) {
+                if (ImGui::Selectable(SwapChain::presentModeToString(mode), mode == currentMode) && mode != currentMode) {
+                    _pendingPresentMode = mode;
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        float fpsLimit = _frameLimiter.getTargetFps();
+        if (ImGui::SliderFloat("FPS Limit", &fpsLimit, 0.0f, 240.0f, fpsLimit > 0.0f ? "%.0f" : "Off")) {
+            _frameLimiter.setTargetFps(fpsLimit);
+        }
+        float idleFps = _frameLimiter.getIdleFps();
+        if (ImGui::SliderFloat("Idle FPS", &idleFps, 0.0f, 60.0f, idleFps > 0.0f ? "%.0f" : "Off")) {
+            _frameLimiter.setIdleFps(idleFps);
+        }
+        if (idleFps > 0.0f) {
+            float idleTimeout = _frameLimiter.getIdleTimeout();
+            if (ImGui::SliderFloat("Idle After (s)", &idleTimeout, 1.0f, 60.0f, "%.0f")) {
+                _frameLimiter.setIdleTimeout(idleTimeout);
+            }
+            if (_frameLimiter.isIdle()) ImGui::TextDisabled("Idle");
+        }
+
+        // Input event -> frame queued for present
+        LatencyMonitor::Stats latency = _latencyMonitor.computeStats();
+        if (latency.samples > 0) {
+            ImGui::Text("Input latency: %.1f ms (avg %.1f, max %.1f)", latency.lastMs, latency.averageMs, latency.maxMs);
+            const auto& history = _latencyMonitor.getHistory();
+            std::vector<float> values(history.begin(), history.end());
+            ImGui::PlotLines("##latency", values.data(), static_cast<int>(values.size()), 0, nullptr,
+                0.0f, std::max(latency.maxMs * 1.25f, 1.0f), ImVec2(-1.0f, 40.0f));
+        } else {
+            ImGui::TextDisabled("Input latency: no input yet");
+        }
+    ImGui::Unindent(16.0f);
+
+    ImGui::Separator();
+    ImGui::Text(ICON_FA_MEMORY " GPU Memory");
+    ImGui::Indent(16.0f);
+        constexpr float MiB = 1024.0f * 1024.0f;
+        MemoryAllocator::Stats total = _ctx->allocator->getTotalStats();
+        ImGui::Text("%u allocations in %u blocks, %u dedicated", total.allocationCount, total.blockCount, total.dedicatedCount);
+        ImGui::Text("Blocks: %.1f / %.1f MiB used, %.1f MiB lost to rounding",
+            total.nodeBytes / MiB, total.blockBytes / MiB, total.wastedBytes() / MiB);
+        ImGui::Text("Dedicated: %.1f MiB", total.dedicatedBytes / MiB);
+
+        // Usage is the whole process with VK_EXT_memory_budget, only the allocator's memory without
+        ImGui::TextDisabled(_ctx->allocator->hasMemoryBudget() ? "Heap budgets (VK_EXT_memory_budget)" : "Heap sizes (no VK_EXT_memory_budget)");
+        for (const MemoryAllocator::HeapBudget& heap : _ctx->allocator->getHeapBudgets()) {
+            const std::string overlay = fmt::format("Heap {}{}: {:.0f} / {:.0f} MiB ({:.0f} MiB ours)", heap.heap, heap.deviceLocal ? " (device)" : "",
+                heap.usage / MiB, heap.budget / MiB, heap.allocatorBytes / MiB);
+            const float fraction = heap.budget > 0 ? float(heap.usage) / float(heap.budget) : 0.0f;
+            if (fraction > 1.0f) ImGui::PushStyleColor(ImGuiCol_PlotHistogram, ImVec4(0.9f, 0.25f, 0.2f, 1.0f));
+            ImGui::ProgressBar(std::min(fraction, 1.0f), ImVec2(-1.0f, 0.0f), overlay.c_str());
+            if (fraction > 1.0f) ImGui::PopStyleColor();
+        }
+
+        const auto categoryBytes = _ctx->allocator->getCategoryBytes();
+        for (uint32_t i = 0; i < static_cast<uint32_t>(MemoryCategory::Count); i++) {
+            ImGui::Text("%s: %.1f MiB", toString(static_cast<MemoryCategory>(i)), categoryBytes[i] / MiB);
+        }
+        StagingRing::Stats staging = _ctx->stagingRing->getStats();
+        ImGui::Text("Staging: %.1f / %.1f MiB in flight, %.1f MiB uploaded",
+            staging.inFlightBytes / MiB, staging.capacity / MiB, staging.uploadedBytes / MiB);
+        ImGui::TextDisabled("%u submissions, %u stalls", staging.submissions, staging.stalls);
+        if (ImGui::TreeNode("Per memory type")) {
+            for (const MemoryAllocator::Stats& stats : _ctx->allocator->getStats()) {
+                ImGui::Text("Type %u: %.1f / %.1f MiB, largest free %.1f MiB, %.0f%% fragmented",
+                    stats.memoryType, stats.nodeBytes / MiB, stats.blockBytes / MiB,
+                    stats.largestFreeBytes / MiB, stats.fragmentation() * 100.0f);
+            }
+            ImGui::TreePop();
+        }
+    ImGui::Unindent(16.0f);
+    ImGui::End();
+
+    if (GpuProfiler* profiler = _renderer->getGpuProfiler()) profiler->buildUI();
+}
+
+
+std::string FramePresenter::nextCapturePath() {
+    if (_recording) {
+        return fmt::format("captures/recording_{:03d}/frame_{:05d}.png", _recordingIndex, _recordedFrames++);
+    }
+    return fmt::format("captures/screenshot_{:03d}.png", _screenshotCount++);
+}
+
+void FramePresenter::collectCapture(uint32_t frame) {
+    if (auto image = _readbackRing->collect(frame)) {
+        _imageEncoder->enqueue(std::move(image.value()));
+    }
 }
 
 
@@ -255,6 +414,19 @@ void FramePresenter::handleEvent(SDL_Event* event) {
     // Always forward to ImGui so it can update its input state
     _gui->handleEvent(event);
 
+    // User input is timed until the frame showing its effect is presented
+    switch (event->type) {
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_WHEEL:
+        case SDL_EVENT_KEY_DOWN:
+            _latencyMonitor.onInput(event->common.timestamp);
+            _frameLimiter.notifyInput();
+            break;
+        default:
+            break;
+    }
+
     // Mouse Events
     // Only forward to the scene if ImGui is not consuming the input
     if (!_gui->isCapturingMouse()) {
@@ -281,7 +453,20 @@ void FramePresenter::handleEvent(SDL_Event* event) {
     if (!_gui->isCapturingKeyboard()) {
         switch (event->type) {
             case SDL_EVENT_KEY_DOWN:
-                _renderer->handleKeyDown(event->key.key, event->key.scancode, event->key.mod);
+                if (event->key.key == SDLK_F12 && !event->key.repeat) {
+                    _screenshotRequested = true;
+                } else if (event->key.key == SDLK_F9 && !event->key.repeat) {
+                    _recording = !_recording;
+                    if (_recording) {
+                        _recordedFrames = 0;
+                        spdlog::info("Recording frames to captures/recording_{:03d}/", _recordingIndex);
+                    } else {
+                        spdlog::info("Recording stopped after {} frames ({} still encoding)", _recordedFrames, _imageEncoder->getPendingCount());
+                        _recordingIndex++;
+                    }
+                } else {
+                    _renderer->handleKeyDown(event->key.key, event->key.scancode, event->key.mod);
+                }
                 break;
             default:
                 break;
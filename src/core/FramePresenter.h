@@ -5,11 +5,17 @@
 #include "vulkan/SwapChain.h"
 #include "core/Renderer.h"
 #include "gui/GUI.h"
+#include "core/LaunchOptions.h"
+#include "core/FramePacer.h"
+#include "core/FrameLimiter.h"
+#include "core/LatencyMonitor.h"
+#include "vulkan/ReadbackRing.h"
+#include "utils/ImageEncoder.h"
 
 class FramePresenter {
 
 public:
-    FramePresenter(std::shared_ptr<VulkanContext> ctx);
+    FramePresenter(std::shared_ptr<VulkanContext> ctx, const LaunchOptions& options = LaunchOptions());
     ~FramePresenter();
 
     void present();
@@ -39,14 +45,37 @@ private:
     void destroyFramebuffers();
 
     // Sync objects
+    // Frame pacing runs on the pacer's timeline semaphore; the binary semaphores only connect
+    // acquire -> submit (one per frame slot) and submit -> present (one per swapchain image)
+    std::unique_ptr<FramePacer> _pacer;
     std::vector<VkSemaphore> _imageAvailableSemaphores;
     std::vector<VkSemaphore> _renderFinishedSemaphores;
-    std::vector<VkFence> _inFlightFences;
     void createSyncObjects();
     void destroySyncObjects();
 
-    uint32_t _frameCounter = 0;
-    uint32_t _imageCounter = 0;
+    uint32_t _frameSlot = 0;
+    std::optional<uint32_t> _pendingFramesInFlight;  // Depth change requested from the UI
+    std::optional<VkPresentModeKHR> _pendingPresentMode;  // Applied by recreating the swapchain
+    void buildUI();
+
+    // Frame rate cap (after present) and input-to-present latency
+    FrameLimiter _frameLimiter;
+    LatencyMonitor _latencyMonitor;
+
+    // Frame capture: F12 saves a screenshot, F9 toggles recording every frame to an image sequence
+    std::unique_ptr<ReadbackRing> _readbackRing;
+    std::unique_ptr<ImageEncoder> _imageEncoder;
+    bool _screenshotRequested = false;
+    bool _recording = false;
+    uint32_t _recordingIndex = 0;
+    uint32_t _recordedFrames = 0;
+    uint32_t _screenshotCount = 0;
+    std::string nextCapturePath();
+    void collectCapture(uint32_t frame);
+
+    // Per-frame GPU timings and the Chrome trace exported on exit (empty = no export)
+    std::string _gpuProfilePath;
+    std::string _tracePath;
 
     // Called when the window is resized
     void invalidate();
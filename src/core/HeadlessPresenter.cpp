@@ -0,0 +1,131 @@
+#include "core/HeadlessPresenter.h"
+#include "utils/CpuProfiler.h"
+
+HeadlessPresenter::HeadlessPresenter(std::shared_ptr<VulkanContext> ctx, VkExtent2D extent, const LaunchOptions& options)
+    : _ctx(std::move(ctx)), _gpuProfilePath(options.gpuProfilePath), _tracePath(options.tracePath)
+{
+    spdlog::info("Headless rendering at {}x{}", extent.width, extent.height);
+
+    // sRGB target without images: the renderer tonemaps into its own RGBA8 UNORM display image
+    // with the same encoding a window swapchain gets, the readback copies the bytes as is
+    _target = std::make_shared<OffscreenTarget>(extent, VK_FORMAT_R8G8B8A8_SRGB);
+    _renderer = std::make_unique<RayTracingRenderer>(_ctx, _target, options);
+
+    createCommandBuffers();
+    // Deeper queue than interactive by default: nobody is waiting on input latency
+    _pacer = std::make_unique<FramePacer>(_ctx, options.framesInFlight.value_or(3));
+
+    _readbackRing = std::make_unique<ReadbackRing>(_ctx, extent);
+    _imageEncoder = std::make_unique<ImageEncoder>();
+}
+
+HeadlessPresenter::~HeadlessPresenter() {
+    // Wait for any unfinished GPU tasks
+    vkDeviceWaitIdle(_ctx->device);
+
+    // Hand over captures still sitting in the ring, the encoder drains its queue on destruction
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) collectCapture(i);
+    _imageEncoder.reset();
+    _readbackRing.reset();
+    _pacer.reset();
+}
+
+void HeadlessPresenter::createCommandBuffers() {
+    _commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = _ctx->commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = (uint32_t)_commandBuffers.size();
+
+    if (vkAllocateCommandBuffers(_ctx->device, &allocInfo, _commandBuffers.data()) != VK_SUCCESS) {
+        spdlog::error("Failed to allocate command buffers!");
+        throw std::runtime_error("Failed to allocate command buffers!");
+    }
+}
+
+void HeadlessPresenter::renderFrame(const std::string& capturePath) {
+    PROFILE_SCOPE("HeadlessPresenter::renderFrame");
+
+    // Wait for the previous use of this frame slot to finish, its capture (if any) is ready now
+    const uint32_t slot = _pacer->beginFrame();
+    collectCapture(slot);
+    vkResetCommandBuffer(_commandBuffers[slot], 0);
+
+    // Update Renderer
+    _renderer->setFrameTimeline(_pacer->getTimelineSemaphore(), _pacer->getFrameValue());
+    _renderer->update(slot);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    vkBeginCommandBuffer(_commandBuffers[slot], &beginInfo);
+
+    VkCommandBuffer cb = _commandBuffers[slot];
+    _renderer->recordToCommandBuffer(cb, 0);
+
+    if (!capturePath.empty()) {
+        GpuProfiler::Scope scope(_renderer->getGpuProfiler(), cb, "Readback");
+        const VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        VulkanHelper::transitionImageLayout(_ctx, cb, _renderer->getOutputImage(), range,
+            VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        _readbackRing->recordCopy(cb, slot, _renderer->getOutputImage(), _renderer->getOutputExtent(), capturePath);
+        VulkanHelper::transitionImageLayout(_ctx, cb, _renderer->getOutputImage(), range,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    vkEndCommandBuffer(cb);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cb;
+
+    // Work the renderer queued on other queues for this frame
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<VkPipelineStageFlags> waitStages;
+    std::vector<uint64_t> waitValues;
+    for (const Renderer::SubmitWait& wait : _renderer->takeSubmitWaits()) {
+        waitSemaphores.push_back(wait.semaphore);
+        waitStages.push_back(wait.stageMask);
+        waitValues.push_back(wait.value);
+    }
+    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+
+    VkSemaphore timeline = _pacer->getTimelineSemaphore();
+    VkTimelineSemaphoreSubmitInfo timelineInfo = _pacer->makeSubmitInfo(waitValues, 0);
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &timeline;
+    submitInfo.pNext = &timelineInfo;
+
+    std::lock_guard<std::mutex> queueLock(_ctx->queueMutex);
+    if (vkQueueSubmit(_ctx->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        _pacer->cancelFrame();
+        spdlog::error("Failed to submit headless command buffer!");
+        throw std::runtime_error("Failed to submit headless command buffer!");
+    }
+}
+
+void HeadlessPresenter::collectCapture(uint32_t frame) {
+    if (auto image = _readbackRing->collect(frame)) {
+        _imageEncoder->enqueue(std::move(image.value()));
+    }
+}
+
+void HeadlessPresenter::finish() {
+    _pacer->waitIdle();
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) collectCapture(i);
+    _imageEncoder->waitIdle();
+
+    GpuProfiler* profiler = _renderer->getGpuProfiler();
+    profiler->collectAll();
+    if (!_gpuProfilePath.empty()) profiler->exportFile(_gpuProfilePath);
+    if (!_tracePath.empty()) profiler->writeChromeTrace(_tracePath);
+
+    if (_imageEncoder->getFailedCount() > 0) {
+        spdlog::error("{} captured image(s) could not be written", _imageEncoder->getFailedCount());
+        throw std::runtime_error("Failed to write captured images!");
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/VulkanHelper.h"
+#include "vulkan/RenderTarget.h"
+#include "vulkan/ReadbackRing.h"
+#include "utils/ImageEncoder.h"
+#include "scene/RayTracingRenderer.h"
+#include "core/LaunchOptions.h"
+#include "core/FramePacer.h"
+
+// Drives the renderer without a window: no surface, swapchain or GUI.
+// Frames are traced into the renderer's storage image; captured frames go through the
+// readback ring and are written by the background encoder.
+class HeadlessPresenter {
+
+public:
+    HeadlessPresenter(std::shared_ptr<VulkanContext> ctx, VkExtent2D extent, const LaunchOptions& options = LaunchOptions());
+    ~HeadlessPresenter();
+
+    HeadlessPresenter(const HeadlessPresenter&) = delete;
+    HeadlessPresenter& operator=(const HeadlessPresenter&) = delete;
+
+    // Records and submits one frame. With a capture path the output is also read back and
+    // written there (.ppm or .png) once the frame completes, without waiting for it here.
+    void renderFrame(const std::string& capturePath = {});
+
+    // Waits for every submitted frame and every pending image write, then exports the GPU timings
+    // and the Chrome trace if their paths were given
+    void finish();
+
+    RayTracingRenderer& getRenderer() { return *_renderer; }
+    FramePacer& getPacer() { return *_pacer; }
+    const ImageEncoder& getImageEncoder() const { return *_imageEncoder; }
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+    std::shared_ptr<OffscreenTarget> _target;
+
+    // Renderer
+    std::unique_ptr<RayTracingRenderer> _renderer;
+
+    // Command buffers (one per frame slot), paced by the timeline semaphore alone since nothing is presented
+    std::vector<VkCommandBuffer> _commandBuffers;
+    std::unique_ptr<FramePacer> _pacer;
+    void createCommandBuffers();
+
+    // Frame capture (readback slot per frame in flight + encoder threads)
+    std::unique_ptr<ReadbackRing> _readbackRing;
+    std::unique_ptr<ImageEncoder> _imageEncoder;
+    void collectCapture(uint32_t frame);
+
+    std::string _gpuProfilePath;
+    std::string _tracePath;
+};
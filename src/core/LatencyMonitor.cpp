@@ -0,0 +1,41 @@
+#include "core/LatencyMonitor.h"
+
+
+void LatencyMonitor::onInput(uint64_t timestampNs) {
+    if (!_pendingInputNs || timestampNs < _pendingInputNs.value()) _pendingInputNs = timestampNs;
+}
+
+void LatencyMonitor::beginFrame() {
+    _frameInputNs = _pendingInputNs;
+    _pendingInputNs.reset();
+}
+
+void LatencyMonitor::cancelFrame() {
+    if (_frameInputNs) onInput(_frameInputNs.value());
+    _frameInputNs.reset();
+}
+
+void LatencyMonitor::onPresent() {
+    if (!_frameInputNs) return;
+
+    const uint64_t now = SDL_GetTicksNS();
+    const uint64_t input = std::min(_frameInputNs.value(), now);
+    _frameInputNs.reset();
+
+    _history.push_back(static_cast<float>(now - input) * 1e-6f);
+    if (_history.size() > HISTORY_SIZE) _history.pop_front();
+}
+
+LatencyMonitor::Stats LatencyMonitor::computeStats() const {
+    Stats stats;
+    if (_history.empty()) return stats;
+
+    stats.lastMs = _history.back();
+    stats.samples = _history.size();
+    for (float ms : _history) {
+        stats.averageMs += ms;
+        stats.maxMs = std::max(stats.maxMs, ms);
+    }
+    stats.averageMs /= static_cast<float>(_history.size());
+    return stats;
+}
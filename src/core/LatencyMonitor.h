@@ -0,0 +1,39 @@
+#pragma once
+#include "stdafx.h"
+
+#include <deque>
+
+
+// Input-to-present latency. Input events carry their SDL timestamp (SDL_GetTicksNS clock); the
+// oldest input not consumed yet is attached to the next frame that updates the renderer and the
+// latency is taken once that frame has been queued with vkQueuePresentKHR. The display adds the
+// present mode's queueing on top (up to one refresh for mailbox, one per queued image for FIFO).
+class LatencyMonitor {
+public:
+    static constexpr size_t HISTORY_SIZE = 240;
+
+    void onInput(uint64_t timestampNs);
+
+    // The frame being recorded consumes the pending input
+    void beginFrame();
+    // The frame was not submitted, its input stays pending for the next one
+    void cancelFrame();
+    // The frame was queued for presentation
+    void onPresent();
+
+    struct Stats {
+        float lastMs = 0.0f;
+        float averageMs = 0.0f;
+        float maxMs = 0.0f;
+        size_t samples = 0;
+    };
+    Stats computeStats() const;
+
+    // Oldest first, for plotting
+    const std::deque<float>& getHistory() const { return _history; }
+
+private:
+    std::optional<uint64_t> _pendingInputNs;  // Oldest input no frame has consumed yet
+    std::optional<uint64_t> _frameInputNs;    // Input consumed by the frame being recorded
+    std::deque<float> _history;
+};
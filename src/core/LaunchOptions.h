@@ -0,0 +1,21 @@
+#pragma once
+#include "stdafx.h"
+#include "scene/QualityPreset.h"
+
+// Options parsed from the command line and handed down to the renderer
+struct LaunchOptions {
+    QualityPreset quality = QualityPreset::Final;
+    std::string environmentPath;  // Radiance .hdr environment map (empty = procedural sky)
+    std::optional<uint32_t> framesInFlight;    // 1..MAX_FRAMES_IN_FLIGHT (default: 2 windowed, 3 headless)
+    std::string gpuProfilePath;                // Per-frame GPU pass timings written on exit (.csv or .json)
+    std::string tracePath;                     // Chrome trace (CPU zones + GPU passes) written on exit
+    std::optional<VkPresentModeKHR> presentMode;  // Windowed only (default: mailbox if supported, else FIFO)
+    float fpsLimit = 0.0f;                     // Windowed CPU frame limiter (0 = unlimited)
+
+    // Headless offscreen rendering (no window, no swapchain)
+    bool headless = false;
+    VkExtent2D headlessExtent = { 1920, 1080 };
+    uint32_t frameCount = 1;                   // Frames accumulated before the last one is written
+    std::string outputPath = "render.png";     // .png or .ppm
+    std::string batchScriptPath;               // Keyframe script rendered to an image sequence (implies headless)
+};
@@ -1,19 +1,26 @@
 #pragma once
 #include "stdafx.h"
 #include "vulkan/VulkanContext.h"
-#include "vulkan/SwapChain.h"
+#include "vulkan/RenderTarget.h"
+
+class GpuProfiler;
 
 class Renderer
 {
 public:
-    Renderer(std::shared_ptr<VulkanContext> ctx, std::shared_ptr<SwapChain> swapChain)
-        : _ctx(std::move(ctx)), _swapChain(std::move(swapChain)) {}
+    Renderer(std::shared_ptr<VulkanContext> ctx, std::shared_ptr<RenderTarget> target)
+        : _ctx(std::move(ctx)), _target(std::move(target)) {}
     virtual ~Renderer() = default;
 
+    // Presenter's frame timeline: the frame the next update() prepares signals frameValue on it
+    void setFrameTimeline(VkSemaphore timeline, uint64_t frameValue) { _frameTimeline = timeline; _frameValue = frameValue; }
+
     virtual void update(uint32_t currentImage) { _currentFrame = currentImage; }
+    // Leaves the frame in the target's image imageIndex (GENERAL layout) if the target has images
     virtual void recordToCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) = 0;
     virtual void onSwapChainRecreated() {}
 
+    // Display referred (sRGB encoded) output of the last recorded frame, GENERAL layout
     virtual VkImage getOutputImage() const { return VK_NULL_HANDLE; }
     virtual VkExtent2D getOutputExtent() const { return {}; }
 
@@ -26,8 +33,29 @@ public:
     // Called each frame to build scene-specific ImGui controls
     virtual void buildUI() {}
 
+    // Pass timings of the current frame slot (presenters add their own passes), null if not profiled
+    virtual GpuProfiler* getGpuProfiler() { return nullptr; }
+
+    // Semaphores the frame's graphics submit must wait on, for work update() queued elsewhere
+    // (e.g. TLAS refits on the compute queue). Handed over once per frame.
+    struct SubmitWait {
+        VkSemaphore semaphore;
+        uint64_t value;                 // Timeline value (ignored for binary semaphores)
+        VkPipelineStageFlags stageMask;
+    };
+    virtual std::vector<SubmitWait> takeSubmitWaits() { return {}; }
+
 protected:
     std::shared_ptr<VulkanContext> _ctx;
-    std::shared_ptr<SwapChain> _swapChain;
+    std::shared_ptr<RenderTarget> _target;
     uint32_t _currentFrame = 0;
+
+    VkSemaphore _frameTimeline = VK_NULL_HANDLE;
+    uint64_t _frameValue = 0;
+    // Every frame up to this value has finished on the GPU
+    uint64_t getCompletedFrameValue() const {
+        uint64_t value = 0;
+        if (_frameTimeline != VK_NULL_HANDLE) vkGetSemaphoreCounterValue(_ctx->device, _frameTimeline, &value);
+        return value;
+    }
 };
@@ -27,7 +27,7 @@ Window::~Window()
 }
 
 
-bool Window::initialize(const std::string& title, const uint16_t width, const uint16_t height)
+bool Window::initialize(const std::string& title, const uint16_t width, const uint16_t height, const LaunchOptions& options)
 {
     // Initialize SDL
     if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
@@ -49,7 +49,7 @@ bool Window::initialize(const std::string& title, const uint16_t width, const ui
     _ctx = std::make_shared<VulkanContext>(_window);
 
     // Create the Vulkan renderer
-    _fp = std::make_unique<FramePresenter>(_ctx);
+    _fp = std::make_unique<FramePresenter>(_ctx, options);
 
     // Always on top
     //SDL_SetWindowAlwaysOnTop(_window, true);
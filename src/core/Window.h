@@ -3,6 +3,7 @@
 #include "stdafx.h"
 #include "vulkan/VulkanContext.h"
 #include "core/FramePresenter.h"
+#include "core/LaunchOptions.h"
 
 class Window
 {
@@ -21,6 +22,6 @@ public:
     Window(const Window&) = delete;
     Window& operator=(const Window&) = delete;
 
-    bool initialize(const std::string& title, const uint16_t width, const uint16_t height);
+    bool initialize(const std::string& title, const uint16_t width, const uint16_t height, const LaunchOptions& options = LaunchOptions());
     void startRenderingLoop();
 };
@@ -9,17 +9,15 @@ DeviceMesh::DeviceMesh(std::shared_ptr<VulkanContext> ctx, const HostMesh& mesh,
     createVertexBuffer(mesh);
     createIndexBuffer(mesh);
     createTransformBuffer(transform);
+
+    // All three copies in one submission, the BLAS build that follows on the same queue sees them
+    _ctx->stagingRing->submit();
 }
 
 void DeviceMesh::createVertexBuffer(const HostMesh& mesh)
 {
     VkDeviceSize bufferSize = sizeof(mesh.vertices[0]) * mesh.vertices.size();
 
-    Buffer stagingBuffer(_ctx, bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    stagingBuffer.copyData(mesh.vertices.data(), bufferSize);
-
     _vertexBuffer = std::make_unique<Buffer>(_ctx, bufferSize,
         VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
@@ -27,18 +25,13 @@ void DeviceMesh::createVertexBuffer(const HostMesh& mesh)
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         true);
 
-    VulkanHelper::copyBuffer(_ctx, stagingBuffer.getBuffer(), _vertexBuffer->getBuffer(), bufferSize);
+    _ctx->stagingRing->upload(_vertexBuffer->getBuffer(), 0, mesh.vertices.data(), bufferSize);
 }
 
 void DeviceMesh::createIndexBuffer(const HostMesh& mesh)
 {
     VkDeviceSize bufferSize = sizeof(mesh.indices[0]) * mesh.indices.size();
 
-    Buffer stagingBuffer(_ctx, bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    stagingBuffer.copyData(mesh.indices.data(), bufferSize);
-
     _indexBuffer = std::make_unique<Buffer>(_ctx, bufferSize,
         VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
@@ -47,18 +40,13 @@ void DeviceMesh::createIndexBuffer(const HostMesh& mesh)
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         true);
 
-    VulkanHelper::copyBuffer(_ctx, stagingBuffer.getBuffer(), _indexBuffer->getBuffer(), bufferSize);
+    _ctx->stagingRing->upload(_indexBuffer->getBuffer(), 0, mesh.indices.data(), bufferSize);
 }
 
 void DeviceMesh::createTransformBuffer(const VkTransformMatrixKHR& transform)
 {
     VkDeviceSize bufferSize = sizeof(VkTransformMatrixKHR);
 
-    Buffer stagingBuffer(_ctx, bufferSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    stagingBuffer.copyData(&transform, bufferSize);
-
     _transformBuffer = std::make_unique<Buffer>(_ctx, bufferSize,
         VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
@@ -66,7 +54,7 @@ void DeviceMesh::createTransformBuffer(const VkTransformMatrixKHR& transform)
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         true);
 
-    VulkanHelper::copyBuffer(_ctx, stagingBuffer.getBuffer(), _transformBuffer->getBuffer(), bufferSize);
+    _ctx->stagingRing->upload(_transformBuffer->getBuffer(), 0, &transform, bufferSize);
 }
 
 VkDeviceOrHostAddressConstKHR DeviceMesh::getVertexBufferDeviceAddress() const
@@ -99,3 +87,8 @@ VkDescriptorBufferInfo DeviceMesh::getIndexBufferDescriptorInfo() const
 {
     return _indexBuffer->getDescriptorInfo();
 }
+
+VkDeviceSize DeviceMesh::getMemorySize() const
+{
+    return _vertexBuffer->getMemorySize() + _indexBuffer->getMemorySize() + _transformBuffer->getMemorySize();
+}
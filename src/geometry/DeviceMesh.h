@@ -26,6 +26,8 @@ public:
     VkDescriptorBufferInfo getVertexBufferDescriptorInfo() const;
     VkDescriptorBufferInfo getIndexBufferDescriptorInfo() const;
 
+    VkDeviceSize getMemorySize() const;
+
 private:
     std::shared_ptr<VulkanContext> _ctx;
 
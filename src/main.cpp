@@ -1,11 +1,21 @@
 #include "stdafx.h"
 #include "core/Window.h"
+#include "core/LaunchOptions.h"
+#include "core/HeadlessPresenter.h"
+#include "core/BatchRenderer.h"
+#include "vulkan/SwapChain.h"
+#include "utils/ImageWriter.h"
+#include "utils/CpuProfiler.h"
+
+#include <cstdio>
 
 
 int main(int argc, char* argv[]) {
+    PROFILE_THREAD("Main");
 
     // Parse command line arguments for verbosity
     spdlog::level::level_enum log_level = spdlog::level::info; // default level
+    LaunchOptions options;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "-vvv") {
@@ -14,16 +24,118 @@ int main(int argc, char* argv[]) {
         } else if (arg == "-vv") {
             log_level = spdlog::level::debug;
             spdlog::info("Verbosity level set to DEBUG");
+        } else if (arg == "--quality" && i + 1 < argc) {
+            std::string value = argv[++i];
+            auto preset = Quality::fromString(value);
+            if (!preset) {
+                spdlog::error("Unknown quality preset '{}' (expected draft, interactive or final)", value);
+                return EXIT_FAILURE;
+            }
+            options.quality = preset.value();
+        } else if (arg == "--env" && i + 1 < argc) {
+            options.environmentPath = argv[++i];
+        } else if (arg == "--headless" && i + 1 < argc) {
+            std::string value = argv[++i];
+            unsigned int width = 0, height = 0;
+            if (std::sscanf(value.c_str(), "%ux%u", &width, &height) != 2 || width == 0 || height == 0) {
+                spdlog::error("Invalid headless size '{}' (expected WxH, e.g. 1920x1080)", value);
+                return EXIT_FAILURE;
+            }
+            options.headless = true;
+            options.headlessExtent = { width, height };
+        } else if (arg == "--frames" && i + 1 < argc) {
+            std::string value = argv[++i];
+            unsigned int frames = 0;
+            if (std::sscanf(value.c_str(), "%u", &frames) != 1 || frames == 0) {
+                spdlog::error("Invalid frame count '{}'", value);
+                return EXIT_FAILURE;
+            }
+            options.frameCount = frames;
+        } else if (arg == "--frames-in-flight" && i + 1 < argc) {
+            std::string value = argv[++i];
+            unsigned int depth = 0;
+            if (std::sscanf(value.c_str(), "%u", &depth) != 1 || depth < 1 || depth > MAX_FRAMES_IN_FLIGHT) {
+                spdlog::error("Invalid frames in flight '{}' (expected 1 to {})", value, MAX_FRAMES_IN_FLIGHT);
+                return EXIT_FAILURE;
+            }
+            options.framesInFlight = depth;
+        } else if (arg == "--gpu-profile" && i + 1 < argc) {
+            options.gpuProfilePath = argv[++i];
+            std::string extension = std::filesystem::path(options.gpuProfilePath).extension().string();
+            if (extension != ".csv" && extension != ".json") {
+                spdlog::error("Unsupported GPU profile output '{}' (expected .csv or .json)", options.gpuProfilePath);
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--present-mode" && i + 1 < argc) {
+            std::string value = argv[++i];
+            options.presentMode = SwapChain::presentModeFromString(value);
+            if (!options.presentMode) {
+                spdlog::error("Unknown present mode '{}' (expected fifo, fifo-relaxed, mailbox or immediate)", value);
+                return EXIT_FAILURE;
+            }
+        } else if (arg == "--fps-limit" && i + 1 < argc) {
+            std::string value = argv[++i];
+            float fps = 0.0f;
+            if (std::sscanf(value.c_str(), "%f", &fps) != 1 || fps < 0.0f) {
+                spdlog::error("Invalid FPS limit '{}' (0 = unlimited)", value);
+                return EXIT_FAILURE;
+            }
+            options.fpsLimit = fps;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            options.batchScriptPath = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            options.outputPath = argv[++i];
+            if (!ImageWriter::isSupported(options.outputPath)) {
+                spdlog::error("Unsupported output '{}' (expected .png or .ppm)", options.outputPath);
+                return EXIT_FAILURE;
+            }
         }
     }
     spdlog::set_level(log_level);
 
+    if (!options.batchScriptPath.empty()) {
+        spdlog::info("Starting Vulkan RayTracer v0.1 (batch)");
+        try {
+            BatchScript script = BatchScript::load(options.batchScriptPath);
+            auto ctx = std::make_shared<VulkanContext>(nullptr);
+            BatchRenderer batch(ctx, std::move(script), options);
+            batch.run();
+        } catch (const std::exception& e) {
+            spdlog::error("{}", e.what());
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (options.headless) {
+        spdlog::info("Starting Vulkan RayTracer v0.1 (headless)");
+        try {
+            // No SDL video: the context is created without a window or surface
+            auto ctx = std::make_shared<VulkanContext>(nullptr);
+            HeadlessPresenter presenter(ctx, options.headlessExtent, options);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (uint32_t frame = 0; frame < options.frameCount; frame++) {
+                presenter.renderFrame(frame + 1 == options.frameCount ? options.outputPath : std::string());
+            }
+            presenter.finish();
+            float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            spdlog::info("Rendered {} frame(s) in {:.1f} ms, wrote {}", options.frameCount, elapsedMs, options.outputPath);
+        } catch (const std::exception& e) {
+            spdlog::error("{}", e.what());
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
 
     spdlog::info("Starting Vulkan RayTracer v0.1");
     //Create a window
     try{
         Window window;
-        if (!window.initialize("Vulkan RayTracer v0.1 (by @arminkz)", 1920, 1080)) return EXIT_FAILURE;
+        if (!window.initialize("Vulkan RayTracer v0.1 (by @arminkz)", 1920, 1080, options)) return EXIT_FAILURE;
 
         // Start the rendering loop
         window.startRenderingLoop();
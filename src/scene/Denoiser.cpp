@@ -0,0 +1,93 @@
+#include "scene/Denoiser.h"
+#include "core/AssetPath.h"
+
+
+Denoiser::Denoiser(std::shared_ptr<VulkanContext> ctx, uint32_t maxWidth, uint32_t maxHeight)
+    : _ctx(std::move(ctx))
+{
+    _normalImage = std::make_unique<StorageImage>(_ctx, maxWidth, maxHeight, VK_FORMAT_R16G16B16A16_SFLOAT);
+    _albedoImage = std::make_unique<StorageImage>(_ctx, maxWidth, maxHeight, VK_FORMAT_R8G8B8A8_UNORM);
+    for (auto& image : _pingPong) {
+        image = std::make_unique<StorageImage>(_ctx, maxWidth, maxHeight, VK_FORMAT_R16G16B16A16_SFLOAT);
+    }
+    spdlog::info("Denoiser images created ({}x{}).", maxWidth, maxHeight);
+}
+
+
+void Denoiser::createDescriptorSets(const StorageImage& traceOutput, const StorageImage& temporalOutput, const StorageImage& gBuffer)
+{
+    auto makeSet = [&](const StorageImage& input, const StorageImage& output) {
+        std::vector<Descriptor> descriptors = {
+            Descriptor(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, input.getDescriptorInfo()),
+            Descriptor(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, output.getDescriptorInfo()),
+            Descriptor(2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, gBuffer.getDescriptorInfo()),
+            Descriptor(3, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, _normalImage->getDescriptorInfo()),
+            Descriptor(4, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, _albedoImage->getDescriptorInfo())
+        };
+        return std::make_unique<DescriptorSet>(_ctx, descriptors);
+    };
+
+    _descriptorSets[0] = makeSet(traceOutput, *_pingPong[0]);
+    _descriptorSets[1] = makeSet(temporalOutput, *_pingPong[0]);
+    _descriptorSets[2] = makeSet(*_pingPong[0], *_pingPong[1]);
+    _descriptorSets[3] = makeSet(*_pingPong[1], *_pingPong[0]);
+
+    // Layout never changes, so the pipeline is only built once
+    if (!_pipeline) {
+        ComputePipelineParams params{};
+        params.descriptorSetLayouts = { _descriptorSets[0]->getDescriptorSetLayout() };
+        params.pushConstantSize = sizeof(PushConstants);
+        params.name = "A-Trous Denoiser";
+        _pipeline = std::make_unique<ComputePipeline>(_ctx, AssetPath::getInstance()->get("spv/atrous_comp.spv"), params);
+    }
+}
+
+
+void Denoiser::recordToCommandBuffer(VkCommandBuffer commandBuffer, VkExtent2D extent, bool fromTemporal)
+{
+    const int passCount = std::max(iterations, 1);
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+
+    // Trace / reprojection output -> first filter pass
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline->getPipeline());
+
+    for (int i = 0; i < passCount; i++) {
+        // First pass reads the source, then alternate ping -> pong -> ping ...
+        uint32_t setIndex = (i == 0) ? (fromTemporal ? 1 : 0) : (i % 2 == 1 ? 2 : 3);
+        VkDescriptorSet descriptorSet = _descriptorSets[setIndex]->getDescriptorSet();
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+            _pipeline->getPipelineLayout(), 0, 1, &descriptorSet, 0, nullptr);
+
+        PushConstants pushConstants{};
+        pushConstants.extent = { extent.width, extent.height };
+        pushConstants.stepWidth = 1 << i;
+        pushConstants.flags = (i == 0 ? FLAG_DEMODULATE : 0) | (i == passCount - 1 ? FLAG_REMODULATE : 0);
+        pushConstants.sigmaColor = sigmaColor;
+        pushConstants.sigmaNormal = sigmaNormal;
+        pushConstants.sigmaDepth = sigmaDepth;
+        vkCmdPushConstants(commandBuffer, _pipeline->getPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT,
+            0, sizeof(PushConstants), &pushConstants);
+
+        vkCmdDispatch(commandBuffer, (extent.width + 7) / 8, (extent.height + 7) / 8, 1);
+
+        // Make this pass visible to the next one (and to the tonemap pass after the last one)
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    // Even pass count ends in pong, odd ends in ping
+    _outputIndex = passCount % 2 == 1 ? 0 : 1;
+}
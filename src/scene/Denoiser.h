@@ -0,0 +1,68 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/VulkanContext.h"
+#include "vulkan/ComputePipeline.h"
+#include "vulkan/DescriptorSet.h"
+#include "vulkan/resources/StorageImage.h"
+
+
+// Edge-aware a-trous wavelet denoiser. Runs a few compute iterations with growing step width,
+// guided by the primary hit normal / depth / albedo written by the trace pass, and filters
+// demodulated lighting only (albedo is divided out on the first and re-applied on the last pass).
+class Denoiser
+{
+public:
+    // Must match the push constant block in atrous.comp
+    struct PushConstants {
+        glm::uvec2 extent;
+        int32_t stepWidth;
+        uint32_t flags;
+        float sigmaColor;
+        float sigmaNormal;
+        float sigmaDepth;
+        float pad;
+    };
+
+    static constexpr uint32_t FLAG_DEMODULATE = 1;
+    static constexpr uint32_t FLAG_REMODULATE = 2;
+
+    // Images are allocated at the renderer's trace allocation, each frame uses a top-left sub-rectangle
+    Denoiser(std::shared_ptr<VulkanContext> ctx, uint32_t maxWidth, uint32_t maxHeight);
+    ~Denoiser() = default;
+
+    // Sources: raw trace output and temporally accumulated output (picked per frame)
+    void createDescriptorSets(const StorageImage& traceOutput, const StorageImage& temporalOutput, const StorageImage& gBuffer);
+
+    void recordToCommandBuffer(VkCommandBuffer commandBuffer, VkExtent2D extent, bool fromTemporal);
+
+    const StorageImage& getNormalImage() const { return *_normalImage; }
+    const StorageImage& getAlbedoImage() const { return *_albedoImage; }
+
+    // Image holding the result of the last recorded run
+    const StorageImage& getOutput() const { return *_pingPong[_outputIndex]; }
+    VkImage getOutputImage() const { return getOutput().getImage(); }
+    // Every image getOutput() can return
+    std::vector<const StorageImage*> getOutputCandidates() const { return { _pingPong[0].get(), _pingPong[1].get() }; }
+
+    int iterations = 4;
+    float sigmaColor = 4.0f;
+    float sigmaNormal = 128.0f;
+    float sigmaDepth = 0.05f;
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+
+    // Guides written by raygen
+    std::unique_ptr<StorageImage> _normalImage;
+    std::unique_ptr<StorageImage> _albedoImage;
+
+    // Ping-pong targets (float, demodulated lighting can exceed 1)
+    std::array<std::unique_ptr<StorageImage>, 2> _pingPong;
+
+    // 0: trace output -> ping, 1: temporal output -> ping, 2: ping -> pong, 3: pong -> ping
+    std::array<std::unique_ptr<DescriptorSet>, 4> _descriptorSets;
+    std::unique_ptr<ComputePipeline> _pipeline;
+
+    uint32_t _outputIndex = 0;
+};
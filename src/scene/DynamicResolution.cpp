@@ -0,0 +1,56 @@
+#include "scene/DynamicResolution.h"
+
+
+DynamicResolution::DynamicResolution(const DynamicResolutionParams& params)
+    : _params(params)
+{
+    _scale = glm::clamp(params.initialScale, params.minScale, params.maxScale);
+}
+
+float DynamicResolution::update(float gpuFrameTimeMs) {
+    if (gpuFrameTimeMs <= 0.0f) return _scale;
+
+    // Smooth out per-frame jitter
+    if (_smoothedFrameTimeMs <= 0.0f) _smoothedFrameTimeMs = gpuFrameTimeMs;
+    else _smoothedFrameTimeMs = glm::mix(_smoothedFrameTimeMs, gpuFrameTimeMs, _params.smoothing);
+
+    if (!_enabled) return _scale;
+
+    // Give the measurement time to reflect the last change
+    if (++_framesSinceChange < _params.settleFrames) return _scale;
+
+    float ratio = _params.targetFrameTimeMs / _smoothedFrameTimeMs;
+    if (std::abs(1.0f - ratio) < _params.deadband) return _scale;
+
+    // Pixel count scales with scale^2, so the scale itself moves with sqrt of the time ratio
+    float desired = _scale * std::sqrt(ratio);
+    float next = glm::clamp(desired, _scale - _params.maxStep, _scale + _params.maxStep);
+    next = glm::clamp(next, _params.minScale, _params.maxScale);
+
+    if (next != _scale) {
+        spdlog::debug("Dynamic resolution: {:.2f} ms (budget {:.2f} ms), scale {:.3f} -> {:.3f}",
+            _smoothedFrameTimeMs, _params.targetFrameTimeMs, _scale, next);
+        _scale = next;
+        _framesSinceChange = 0;
+    }
+    return _scale;
+}
+
+void DynamicResolution::setEnabled(bool enabled) {
+    _enabled = enabled;
+    _framesSinceChange = 0;
+}
+
+void DynamicResolution::setScale(float scale) {
+    _scale = glm::clamp(scale, _params.minScale, _params.maxScale);
+    _framesSinceChange = 0;
+}
+
+VkExtent2D DynamicResolution::getScaledExtent(VkExtent2D outputExtent) const {
+    auto scaled = [&](uint32_t size) {
+        uint32_t maxSize = static_cast<uint32_t>(std::ceil(size * _params.maxScale));
+        uint32_t value = static_cast<uint32_t>(std::ceil(size * _scale));
+        return std::clamp(value, 1u, maxSize);
+    };
+    return { scaled(outputExtent.width), scaled(outputExtent.height) };
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "stdafx.h"
+
+
+struct DynamicResolutionParams
+{
+    float targetFrameTimeMs = 16.0f; // GPU time budget for the trace pass
+    float minScale = 0.5f;           // Lowest trace resolution relative to the swapchain
+    float maxScale = 2.0f;           // Highest trace resolution (trace images grow up to this size)
+    float initialScale = 2.0f;
+
+    float smoothing = 0.1f;          // Exponential moving average weight of new samples
+    float deadband = 0.05f;          // Relative frame time error ignored to avoid oscillation
+    float maxStep = 0.1f;            // Max scale change per adjustment
+    uint32_t settleFrames = 8;       // Frames to wait after a change before adjusting again
+};
+
+
+// Adjusts the trace resolution scale so the measured GPU frame time converges to a budget.
+// Cost is assumed to be proportional to the traced pixel count, i.e. scale^2.
+class DynamicResolution
+{
+public:
+    explicit DynamicResolution(const DynamicResolutionParams& params = DynamicResolutionParams());
+
+    // Feed one GPU frame time measurement, returns the scale to use for the next frame
+    float update(float gpuFrameTimeMs);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    // Manual scale (used as-is while the controller is disabled)
+    void setScale(float scale);
+    float getScale() const { return _scale; }
+
+    void setTargetFrameTime(float ms) { _params.targetFrameTimeMs = std::max(ms, 0.1f); }
+    float getTargetFrameTime() const { return _params.targetFrameTimeMs; }
+
+    float getMinScale() const { return _params.minScale; }
+    float getMaxScale() const { return _params.maxScale; }
+    float getSmoothedFrameTime() const { return _smoothedFrameTimeMs; }
+
+    // Trace extent for a given output extent at the current scale (clamped to maxScale)
+    VkExtent2D getScaledExtent(VkExtent2D outputExtent) const;
+
+private:
+    DynamicResolutionParams _params;
+    bool _enabled = false;
+    float _scale;
+    float _smoothedFrameTimeMs = 0.0f;
+    uint32_t _framesSinceChange = 0;
+};
@@ -0,0 +1,75 @@
+#include "scene/EnvironmentMap.h"
+#include "scene/HdrLoader.h"
+#include "utils/AliasTable.h"
+
+#include "glm/gtc/packing.hpp"
+
+
+EnvironmentMap::EnvironmentMap(std::shared_ptr<VulkanContext> ctx)
+    : _ctx(std::move(ctx))
+{
+    EnvironmentHeader header{};
+    createBuffer(header, { EnvironmentTexel{} });
+}
+
+EnvironmentMap::EnvironmentMap(std::shared_ptr<VulkanContext> ctx, const std::string& imagePath)
+    : _ctx(std::move(ctx))
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    HdrImage image = HdrLoader::load(imagePath);
+    _width = image.width;
+    _height = image.height;
+
+    // Quantize to half floats first so the shader recomputes exactly the weights used here
+    const size_t texelCount = static_cast<size_t>(_width) * _height;
+    std::vector<EnvironmentTexel> texels(texelCount);
+    std::vector<float> weights(texelCount);
+    for (uint32_t y = 0; y < _height; y++) {
+        // Equirectangular rows shrink towards the poles
+        const float sinTheta = std::sin((static_cast<float>(y) + 0.5f) / static_cast<float>(_height) * glm::pi<float>());
+
+        for (uint32_t x = 0; x < _width; x++) {
+            const size_t i = static_cast<size_t>(y) * _width + x;
+            const glm::vec3 radiance = glm::clamp(image.pixels[i], glm::vec3(0.0f), glm::vec3(65504.0f)); // half float range
+
+            texels[i].radianceRG = glm::packHalf2x16(glm::vec2(radiance.r, radiance.g));
+            texels[i].radianceB = glm::packHalf2x16(glm::vec2(radiance.b, 0.0f));
+
+            const glm::vec2 rg = glm::unpackHalf2x16(texels[i].radianceRG);
+            const float b = glm::unpackHalf2x16(texels[i].radianceB).x;
+            const float luminance = glm::dot(glm::vec3(rg, b), glm::vec3(0.2126f, 0.7152f, 0.0722f));
+            weights[i] = luminance * sinTheta;
+        }
+    }
+
+    AliasTable aliasTable(weights);
+    for (size_t i = 0; i < texelCount; i++) {
+        texels[i].aliasProbability = aliasTable.getProbability(i);
+        texels[i].alias = aliasTable.getAlias(i);
+    }
+
+    EnvironmentHeader header{};
+    header.width = _width;
+    header.height = _height;
+    header.weightSum = aliasTable.getTotalWeight();
+    createBuffer(header, texels);
+
+    _loaded = header.weightSum > 0.0f;
+    if (!_loaded) spdlog::warn("Environment map {} is black, environment lighting stays disabled", imagePath);
+
+    auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    spdlog::info("Environment map ready ({}x{}, importance table built in {:.1f} ms)", _width, _height, elapsed);
+}
+
+void EnvironmentMap::createBuffer(const EnvironmentHeader& header, const std::vector<EnvironmentTexel>& texels) {
+    const VkDeviceSize texelsSize = sizeof(EnvironmentTexel) * texels.size();
+    // Read by every miss, so it lives in device memory (the frame waits for the staging ring)
+    _buffer = std::make_unique<Buffer>(_ctx,
+        sizeof(EnvironmentHeader) + texelsSize,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    );
+    _ctx->stagingRing->upload(_buffer->getBuffer(), 0, &header, sizeof(EnvironmentHeader));
+    _ctx->stagingRing->upload(_buffer->getBuffer(), sizeof(EnvironmentHeader), texels.data(), texelsSize);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "stdafx.h"
+#include "vulkan/VulkanContext.h"
+#include "vulkan/resources/Buffer.h"
+#include "vulkan/LightData.h"
+
+
+// HDR environment (equirectangular) stored in a storage buffer together with
+// an alias table for importance sampling it from the hit shaders
+class EnvironmentMap {
+public:
+    // Empty placeholder so the descriptor can always be bound
+    EnvironmentMap(std::shared_ptr<VulkanContext> ctx);
+
+    // Loads a Radiance .hdr file
+    EnvironmentMap(std::shared_ptr<VulkanContext> ctx, const std::string& imagePath);
+
+    bool isLoaded() const { return _loaded; }
+    uint32_t getWidth() const { return _width; }
+    uint32_t getHeight() const { return _height; }
+
+    VkDescriptorBufferInfo getDescriptorInfo() const { return _buffer->getDescriptorInfo(); }
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+    std::unique_ptr<Buffer> _buffer;
+    uint32_t _width = 0;
+    uint32_t _height = 0;
+    bool _loaded = false;
+
+    void createBuffer(const EnvironmentHeader& header, const std::vector<EnvironmentTexel>& texels);
+};
@@ -0,0 +1,101 @@
+#include "scene/HdrLoader.h"
+
+#include <cstdio>
+
+
+namespace HdrLoader {
+
+    static glm::vec3 decodeRGBE(const uint8_t* rgbe) {
+        if (rgbe[3] == 0) return glm::vec3(0.0f);
+        float scale = std::ldexp(1.0f, static_cast<int>(rgbe[3]) - (128 + 8));
+        return glm::vec3(rgbe[0], rgbe[1], rgbe[2]) * scale;
+    }
+
+    // Reads one scanline (4 bytes per pixel), handling both flat and new-style RLE encoding
+    static bool readScanline(std::ifstream& file, uint32_t width, std::vector<uint8_t>& scanline) {
+        uint8_t header[4];
+        if (!file.read(reinterpret_cast<char*>(header), 4)) return false;
+
+        const bool isRLE = header[0] == 2 && header[1] == 2 && (header[2] & 0x80) == 0
+                        && width >= 8 && width < 32768;
+        if (!isRLE) {
+            // Flat scanline, the header was already the first pixel
+            memcpy(scanline.data(), header, 4);
+            return static_cast<bool>(file.read(reinterpret_cast<char*>(scanline.data() + 4), (width - 1) * 4));
+        }
+
+        if (((static_cast<uint32_t>(header[2]) << 8) | header[3]) != width) return false;
+
+        // Each of the 4 channels is run-length encoded separately
+        for (uint32_t channel = 0; channel < 4; channel++) {
+            uint32_t x = 0;
+            while (x < width) {
+                int count = file.get();
+                if (count == EOF) return false;
+
+                if (count > 128) {
+                    // Run of a single value
+                    count -= 128;
+                    int value = file.get();
+                    if (value == EOF || x + count > width) return false;
+                    for (int i = 0; i < count; i++) scanline[(x++) * 4 + channel] = static_cast<uint8_t>(value);
+                } else {
+                    // Literal values
+                    if (count == 0 || x + count > width) return false;
+                    for (int i = 0; i < count; i++) {
+                        int value = file.get();
+                        if (value == EOF) return false;
+                        scanline[(x++) * 4 + channel] = static_cast<uint8_t>(value);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    HdrImage load(const std::string& imagePath) {
+        std::ifstream file(imagePath, std::ios::binary);
+        if (!file.is_open()) {
+            spdlog::error("Failed to open HDR image: {}", imagePath);
+            throw std::runtime_error("Failed to open HDR image!");
+        }
+
+        // Header: magic, key=value lines, blank line, then the resolution string
+        std::string line;
+        std::getline(file, line);
+        if (line.rfind("#?", 0) != 0) {
+            spdlog::error("Not a Radiance HDR file: {}", imagePath);
+            throw std::runtime_error("Not a Radiance HDR file!");
+        }
+        while (std::getline(file, line) && !line.empty()) {
+            if (line.rfind("FORMAT=", 0) == 0 && line != "FORMAT=32-bit_rle_rgbe") {
+                spdlog::error("Unsupported HDR pixel format '{}' in {}", line, imagePath);
+                throw std::runtime_error("Unsupported HDR pixel format!");
+            }
+        }
+
+        HdrImage image;
+        std::getline(file, line);
+        char yAxis[3] = {}, xAxis[3] = {};
+        if (sscanf(line.c_str(), "%2s %u %2s %u", yAxis, &image.height, xAxis, &image.width) != 4
+            || std::string(yAxis) != "-Y" || std::string(xAxis) != "+X") {
+            spdlog::error("Unsupported HDR orientation '{}' in {} (expected -Y H +X W)", line, imagePath);
+            throw std::runtime_error("Unsupported HDR orientation!");
+        }
+
+        image.pixels.resize(static_cast<size_t>(image.width) * image.height);
+        std::vector<uint8_t> scanline(static_cast<size_t>(image.width) * 4);
+        for (uint32_t y = 0; y < image.height; y++) {
+            if (!readScanline(file, image.width, scanline)) {
+                spdlog::error("Corrupt HDR scanline {} in {}", y, imagePath);
+                throw std::runtime_error("Corrupt HDR image!");
+            }
+            for (uint32_t x = 0; x < image.width; x++) {
+                image.pixels[static_cast<size_t>(y) * image.width + x] = decodeRGBE(&scanline[x * 4]);
+            }
+        }
+
+        spdlog::info("Loaded HDR image {} ({}x{})", imagePath, image.width, image.height);
+        return image;
+    }
+}
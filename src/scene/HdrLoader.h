@@ -0,0 +1,15 @@
+#pragma once
+#include "stdafx.h"
+
+// Radiance RGBE (.hdr) images, top row first
+struct HdrImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<glm::vec3> pixels;
+};
+
+namespace HdrLoader {
+
+    HdrImage load(const std::string& imagePath);
+
+}
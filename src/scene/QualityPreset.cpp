@@ -0,0 +1,56 @@
+#include "scene/QualityPreset.h"
+
+
+namespace Quality {
+
+    QualitySettings getSettings(QualityPreset preset) {
+        QualitySettings settings{};
+        switch (preset) {
+        case QualityPreset::Draft:
+            // Hard shadows, a single bounce of reflection/refraction
+            settings.maxRecursionDepth = 2;
+            settings.softShadows = VK_FALSE;
+            settings.shadowGridSize = 1;
+            break;
+        case QualityPreset::Interactive:
+            // 2x2 stratified shadow rays, moderate recursion
+            settings.maxRecursionDepth = 4;
+            settings.softShadows = VK_TRUE;
+            settings.shadowGridSize = 2;
+            break;
+        case QualityPreset::Final:
+            // 4x4 stratified shadow rays, deep recursion for glass
+            settings.maxRecursionDepth = 6;
+            settings.softShadows = VK_TRUE;
+            settings.shadowGridSize = 4;
+            break;
+        }
+        return settings;
+    }
+
+    const char* toString(QualityPreset preset) {
+        switch (preset) {
+        case QualityPreset::Draft:       return "draft";
+        case QualityPreset::Interactive: return "interactive";
+        case QualityPreset::Final:       return "final";
+        }
+        return "unknown";
+    }
+
+    std::optional<QualityPreset> fromString(const std::string& name) {
+        if (name == "draft")       return QualityPreset::Draft;
+        if (name == "interactive") return QualityPreset::Interactive;
+        if (name == "final")       return QualityPreset::Final;
+        return std::nullopt;
+    }
+
+    std::vector<VkSpecializationMapEntry> getSpecializationEntries() {
+        return {
+            { 0, offsetof(QualitySettings, maxRecursionDepth), sizeof(uint32_t) },
+            { 1, offsetof(QualitySettings, softShadows),       sizeof(VkBool32) },
+            { 2, offsetof(QualitySettings, shadowGridSize),    sizeof(uint32_t) },
+            { 3, offsetof(QualitySettings, samplerType),       sizeof(uint32_t) },
+            { 4, offsetof(QualitySettings, shadowRays),        sizeof(VkBool32) },
+        };
+    }
+}
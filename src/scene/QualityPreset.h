@@ -0,0 +1,40 @@
+#pragma once
+#include "stdafx.h"
+
+// Preset bundles of the quality knobs exposed by the hit shaders
+enum class QualityPreset : int {
+    Draft = 0,
+    Interactive = 1,
+    Final = 2
+};
+
+// Values fed to the ray tracing pipeline as specialization constants.
+// Field order and sizes must match the constant_id layout in shaders/common/scene.glsl
+// and shaders/common/sampling.glsl.
+struct QualitySettings {
+    uint32_t maxRecursionDepth = 6;   // constant_id = 0
+    VkBool32 softShadows = VK_TRUE;   // constant_id = 1
+    uint32_t shadowGridSize = 4;      // constant_id = 2 (shadow rays per hit = gridSize^2)
+    uint32_t samplerType = 0;         // constant_id = 3 (SamplerType, not part of the presets)
+    VkBool32 shadowRays = VK_TRUE;    // constant_id = 4 (off on devices without recursion headroom)
+
+    bool operator==(const QualitySettings& other) const {
+        return maxRecursionDepth == other.maxRecursionDepth
+            && softShadows == other.softShadows
+            && shadowGridSize == other.shadowGridSize
+            && samplerType == other.samplerType
+            && shadowRays == other.shadowRays;
+    }
+    bool operator!=(const QualitySettings& other) const { return !(*this == other); }
+};
+
+namespace Quality {
+
+    QualitySettings getSettings(QualityPreset preset);
+
+    const char* toString(QualityPreset preset);
+    std::optional<QualityPreset> fromString(const std::string& name);
+
+    // Specialization map entries describing the QualitySettings layout
+    std::vector<VkSpecializationMapEntry> getSpecializationEntries();
+}
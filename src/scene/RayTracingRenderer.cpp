@@ -6,14 +6,26 @@
 #include "vulkan/resources/StorageImage.h"
 #include "vulkan/DescriptorSet.h"
 #include "core/AssetPath.h"
+#include "vulkan/ShaderCompiler.h"
 #include "vulkan/VulkanRT.h"
 #include "scene/content/TeapotScene.h"
 #include "scene/content/SpheresScene.h"
+#include "utils/CpuProfiler.h"
+
+namespace {
+    // Doubling keeps a growing scene from reallocating every few edits (at least one entry to bind)
+    uint32_t grownCapacity(uint32_t capacity, size_t required) {
+        capacity = std::max(capacity, 1u);
+        while (capacity < required) capacity *= 2;
+        return capacity;
+    }
+}
 
-
-RayTracingRenderer::RayTracingRenderer(std::shared_ptr<VulkanContext> ctx, std::shared_ptr<SwapChain> swapChain)
-    : Renderer(std::move(ctx), std::move(swapChain))
+RayTracingRenderer::RayTracingRenderer(std::shared_ptr<VulkanContext> ctx, std::shared_ptr<RenderTarget> target, const LaunchOptions& options)
+    : Renderer(std::move(ctx), std::move(target)), _qualityPreset(options.quality)
 {
+    PROFILE_SCOPE("RayTracingRenderer::RayTracingRenderer");
+
     // Get ray tracing pipeline properties (we need this for SBT creation later)
     _rayTracingPipelineProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_PROPERTIES_KHR;
     VkPhysicalDeviceProperties2 deviceProperties2{};
@@ -29,22 +41,29 @@ RayTracingRenderer::RayTracingRenderer(std::shared_ptr<VulkanContext> ctx, std::
     vkGetPhysicalDeviceFeatures2(_ctx->physicalDevice, &deviceFeatures2);
 
 
-    // Create Storage Image at 2x resolution for supersampling
-    // use same format as swap chain to avoid RGB/BGR mismatch
-    // cant use SRGB format for storage image, so convert to UNORM
-    _storageImage = std::make_unique<StorageImage>(_ctx,
-        _swapChain->getSwapChainExtent().width * _supersampleScale,
-        _swapChain->getSwapChainExtent().height * _supersampleScale,
-        VulkanHelper::convertToUnormFormat(_swapChain->getSwapChainImageFormat()));
-    spdlog::info("Storage image created at {}x resolution ({}x{}).",
-        _supersampleScale,
-        _swapChain->getSwapChainExtent().width * _supersampleScale,
-        _swapChain->getSwapChainExtent().height * _supersampleScale);
+    // Render scale controller (starts at 2x supersampling, dynamic mode is opt-in)
+    _dynamicResolution = std::make_unique<DynamicResolution>();
+    _traceExtent = _dynamicResolution->getScaledExtent(_target->getExtent());
+    _tiledDispatch = std::make_unique<TiledDispatch>();
+
+    // Create Storage Image at the current render scale
+    createStorageImage();
+
+    // GPU pass timer (also feeds the dynamic resolution controller)
+    _profiler = std::make_unique<GpuProfiler>(_ctx);
 
     // Create Uniform Buffers
     createUniformBuffers();
     spdlog::info("Uniform buffers created.");
 
+    // Create Sampler Tables (scene independent)
+    createSamplerTablesBuffer();
+
+    // Load Environment Map (or bind an empty placeholder)
+    _environmentMap = options.environmentPath.empty()
+        ? std::make_unique<EnvironmentMap>(_ctx)
+        : std::make_unique<EnvironmentMap>(_ctx, options.environmentPath);
+
     // Create Camera
     TurnTableCameraParams cameraParams;
     cameraParams.initialElevation = -0.6f;
@@ -58,40 +77,99 @@ RayTracingRenderer::RayTracingRenderer(std::shared_ptr<VulkanContext> ctx, std::
     _sceneContent->onLoad();
     _sceneGraph->clearInstanceRebuildFlag(); // buffer is built right below
 
-    // Create Top Level Acceleration Structure
+    // Create Top Level Acceleration Structures (refits run on the compute queue)
+    _asyncCompute = std::make_unique<AsyncCompute>(_ctx);
     createTLAS();
 
-    // Create Instance Data Buffer
-    createInstanceDataBuffer();
+    // Create Instance Data + Light List Buffers (filled per slot on first use)
+    stageSceneData();
+    createSceneDataBuffers();
 
-    // Create Descriptor Sets (needs TLAS and instance data buffer)
+    // Create Descriptor Sets (needs TLAS and instance data buffers)
     createDescriptorSets();
 
-    // Create Raytracing Pipeline
-    createRayTracingPipeline();
+    // Create Raytracing Pipeline + Shader Binding Tables for the initial quality preset
+    // (built synchronously here, later preset changes are built in the background)
+    _pipelineVariant = createPipelineVariant(_qualityPreset, getRequestedSettings(), _shaderGeneration, _descriptorSets[0]->getDescriptorSetLayout());
+    spdlog::info("Quality preset: {}, sampler: {}", Quality::toString(_pipelineVariant->preset), SamplerTables::toString(_samplerType));
 
-    // Create Shader Binding Tables
-    createShaderBindingTables();
+    // Watch shader sources (no-op unless built with ENABLE_SHADER_HOT_RELOAD)
+    _shaderHotReload = std::make_unique<ShaderHotReload>(ShaderCompiler::getSourceDirectory(), AssetPath::getInstance()->get("spv"));
 }
 
 RayTracingRenderer::~RayTracingRenderer()
 {
+    // Let a pending pipeline build finish before tearing down what it references
+    waitForPendingVariant();
+    _shaderHotReload.reset();
+
     // Wait for any unfinished GPU tasks
     vkDeviceWaitIdle(_ctx->device);
+    _ctx->computeSubmitter->poll();
+}
+
+
+void RayTracingRenderer::createStorageImage() {
+    // Radiance is kept unclamped until the tonemap pass. Allocated at the current render scale,
+    // rounded up to a quarter step so a dynamic resolution climb doesn't reallocate every adjustment.
+    _allocatedScale = std::min(std::ceil(_dynamicResolution->getScale() * 4.0f) / 4.0f, _dynamicResolution->getMaxScale());
+    const uint32_t width  = static_cast<uint32_t>(std::ceil(_target->getExtent().width  * _allocatedScale));
+    const uint32_t height = static_cast<uint32_t>(std::ceil(_target->getExtent().height * _allocatedScale));
+    retire(std::move(_storageImage));
+    _storageImage = std::make_unique<StorageImage>(_ctx, width, height, VK_FORMAT_R16G16B16A16_SFLOAT);
+    spdlog::info("Storage image created at {:.2f}x resolution ({}x{}).", _allocatedScale, width, height);
+
+    // G-buffer + history for temporal reprojection share the storage image size and format
+    auto temporal = std::make_unique<TemporalReprojection>(_ctx, width, height, _storageImage->getFormat());
+    auto denoiser = std::make_unique<Denoiser>(_ctx, width, height);
+
+    // Pass settings survive swapchain recreation and image growth
+    auto tonemapper = std::make_unique<Tonemapper>(_ctx, *_target);
+    if (_temporal) {
+        temporal->alpha = _temporal->alpha;
+        temporal->depthTolerance = _temporal->depthTolerance;
+        temporal->accumulate = _temporal->accumulate;
+    }
+    if (_denoiser) {
+        denoiser->iterations = _denoiser->iterations;
+        denoiser->sigmaColor = _denoiser->sigmaColor;
+        denoiser->sigmaNormal = _denoiser->sigmaNormal;
+        denoiser->sigmaDepth = _denoiser->sigmaDepth;
+    }
+    if (_tonemapper) {
+        tonemapper->exposure = _tonemapper->exposure;
+        tonemapper->tonemapOperator = _tonemapper->tonemapOperator;
+        tonemapper->filter = _tonemapper->filter;
+    }
+    retire(std::move(_temporal));
+    retire(std::move(_denoiser));
+    retire(std::move(_tonemapper));
+    _temporal = std::move(temporal);
+    _denoiser = std::move(denoiser);
+    _tonemapper = std::move(tonemapper);
 }
 
+void RayTracingRenderer::growTraceImages() {
+    // Frames in flight keep using the retired images, each slot's scene set rebinds when it is
+    // next recorded. Reprojection starts over with an empty history.
+    createStorageImage();
+    createPostProcessDescriptorSets();
+    _sceneDescriptorSetStale.fill(true);
+}
+
+const StorageImage& RayTracingRenderer::getHdrOutput() const {
+    if (_denoiserEnabled) return _denoiser->getOutput();
+    return _temporalEnabled ? _temporal->getResolvedImage() : *_storageImage;
+}
 
 void RayTracingRenderer::onSwapChainRecreated() {
 
+    // Background pipeline builds reference the descriptor set layout we are about to replace
+    waitForPendingVariant();
+
     // Recreate storage image
-    _storageImage = std::make_unique<StorageImage>(_ctx,
-        _swapChain->getSwapChainExtent().width * _supersampleScale,
-        _swapChain->getSwapChainExtent().height * _supersampleScale,
-        VulkanHelper::convertToUnormFormat(_swapChain->getSwapChainImageFormat()));
-    spdlog::info("Storage image recreated at {}x resolution ({}x{}).",
-        _supersampleScale,
-        _swapChain->getSwapChainExtent().width * _supersampleScale,
-        _swapChain->getSwapChainExtent().height * _supersampleScale);
+    createStorageImage();
+    _traceExtent = _dynamicResolution->getScaledExtent(_target->getExtent());
 
     // Recreate discriptor sets
     createDescriptorSets();
@@ -99,12 +177,52 @@ void RayTracingRenderer::onSwapChainRecreated() {
 
 
 void RayTracingRenderer::update(uint32_t currentImage) {
+    PROFILE_SCOPE("RayTracingRenderer::update");
+
     // Update any scene-specific data here (e.g., camera, animations)
     Renderer::update(currentImage);
 
+    // Heap budgets change with other processes too, the memory panel shows this frame's
+    _ctx->allocator->updateBudget();
+
+    // A lowered geometry budget applies right away, evicted geometry is freed once the frames
+    // still tracing it have finished
+    if (_geometryBudgetChanged) {
+        _geometryBudgetChanged = false;
+        _sceneGraph->evictGeometry(getGeometryBudgetBytes());
+    }
+    _sceneGraph->releaseRetiredGeometry(getCompletedFrameValue());
+
+    // Recompiled shaders need a new pipeline variant (built in the background like preset changes)
+    if (_shaderHotReload->poll()) {
+        _shaderGeneration++;
+        requestPipelineVariant();
+    }
+
+    // Swap in a freshly built pipeline variant and release retired ones
+    pollPipelineVariant();
+    releaseRetiredResources();
+
+    // Read back the pass timings of the frame that last used this slot, then pick the
+    // trace resolution (or the tiles) for this frame from the last measured trace time
+    _profiler->beginFrame(currentImage, _frameIndex);
+    if (_tiledDispatch->isEnabled()) {
+        _tiledDispatch->update(_profiler->getLastTime("Trace Rays"), _tracedPixels[currentImage]);
+    } else {
+        _dynamicResolution->update(_profiler->getLastTime("Trace Rays"));
+    }
+    _traceExtent = _dynamicResolution->getScaledExtent(_target->getExtent());
+    if (_dynamicResolution->getScale() > _allocatedScale) growTraceImages();
+    _traceTiles = _tiledDispatch->nextTiles(_traceExtent);
+    _tracedPixels[currentImage] = 0;
+    for (const VkRect2D& tile : _traceTiles) {
+        _tracedPixels[currentImage] += static_cast<uint64_t>(tile.extent.width) * tile.extent.height;
+    }
+
     // Advance time
     auto elapsedTime = std::chrono::high_resolution_clock::now() - _lastFrameTime;
     float elapsedSeconds = std::chrono::duration<float, std::chrono::seconds::period>(elapsedTime).count();
+    if (_fixedTimeStep) elapsedSeconds = _fixedTimeStep.value();
     if(!_isPaused) {
         _time += elapsedSeconds;
     }
@@ -118,10 +236,15 @@ void RayTracingRenderer::update(uint32_t currentImage) {
     // Camera matrices
     glm::mat4 view = _camera->getViewMatrix();
     glm::mat4 proj = glm::perspective(glm::radians(45.0f),
-        static_cast<float>(_swapChain->getSwapChainExtent().width) / static_cast<float>(_swapChain->getSwapChainExtent().height),
+        static_cast<float>(_target->getExtent().width) / static_cast<float>(_target->getExtent().height),
         0.1f, 10.0f);
     proj[1][1] *= -1; // Invert Y for Vulkan
 
+    // Keep last frame's camera for reprojection
+    _prevViewProj = _viewProj;
+    _prevCamPosition = _ubo.camPosition;
+    _viewProj = proj * view;
+
 
     // Light position
     float r = 25.0f;
@@ -133,23 +256,35 @@ void RayTracingRenderer::update(uint32_t currentImage) {
     _ubo.lightU = glm::normalize(glm::cross(up, lightDir));
     _ubo.lightV = glm::normalize(glm::cross(lightDir, _ubo.lightU));
 
+    // Environment lighting
+    _ubo.environmentEnabled = (_environmentEnabled && _environmentMap->isLoaded()) ? 1u : 0u;
+    _ubo.environmentIntensity = _environmentIntensity;
+
     // Per-scene animations
     _sceneContent->update(elapsedSeconds);
 
-    // Re-upload instance data if any scene modified the objects (e.g. material change)
+    // Restage instance data if any scene modified the objects (e.g. material change). Each slot
+    // picks it up (growing its buffers if needed) the next time it is recorded.
     if (_sceneGraph->needsInstanceRebuild()) {
         _sceneGraph->clearInstanceRebuildFlag();
-        vkDeviceWaitIdle(_ctx->device);
-        auto instanceDataArray = _sceneGraph->buildInstanceDataArray();
-        _instanceDataBuffer->copyData(instanceDataArray.data(), sizeof(InstanceData) * instanceDataArray.size());
+        stageSceneData();
+        _sceneDataStale.fill(true);
     }
+    uploadSceneData(currentImage);
 
-    updateTLAS();
+    // This frame's TLAS references the geometry of the current objects
+    _sceneGraph->markGeometryInUse(_frameValue);
+    updateTLAS(currentImage);
+    waitForLoadedResources();
+
+    // Only this slot's frames read its descriptor set, and the slot's last frame has finished
+    if (_sceneDescriptorSetStale[currentImage]) createSceneDescriptorSet(currentImage);
 
     // Update uniform buffer
     _ubo.viewInverse = glm::inverse(view);
     _ubo.projInverse = glm::inverse(proj);
     _ubo.camPosition = _camera->getPosition();
+    _ubo.frameIndex = _frameIndex++;
 
     // Copy data to uniform buffer
     _uniformBuffers[currentImage]->copyData(&_ubo, sizeof(UniformData));
@@ -157,64 +292,156 @@ void RayTracingRenderer::update(uint32_t currentImage) {
 
 
 void RayTracingRenderer::recordToCommandBuffer(VkCommandBuffer commandBuffer, uint32_t targetSwapImageIndex) {
+    PROFILE_SCOPE("RayTracingRenderer::recordToCommandBuffer");
 
     // Setup the buffer regions pointing to the shaders in our shader binding tables
     const uint32_t handleSizeAligned = VulkanHelper::alignedSize(_rayTracingPipelineProperties.shaderGroupHandleSize, _rayTracingPipelineProperties.shaderGroupHandleAlignment);
     const uint32_t missShaderCount = 2; // Primary miss and shadow miss
 
+    const PipelineVariant& variant = *_pipelineVariant;
+
     VkStridedDeviceAddressRegionKHR raygenShaderSbtEntry{};
-    raygenShaderSbtEntry.deviceAddress = raygenShaderBindingTable->getDeviceAddress();
+    raygenShaderSbtEntry.deviceAddress = variant.raygenShaderBindingTable->getDeviceAddress();
     raygenShaderSbtEntry.stride = handleSizeAligned;
     raygenShaderSbtEntry.size = handleSizeAligned;
 
     VkStridedDeviceAddressRegionKHR missShaderSbtEntry{};
-    missShaderSbtEntry.deviceAddress = missShaderBindingTable->getDeviceAddress();
+    missShaderSbtEntry.deviceAddress = variant.missShaderBindingTable->getDeviceAddress();
     missShaderSbtEntry.stride = handleSizeAligned;
     missShaderSbtEntry.size = handleSizeAligned * missShaderCount; // Size covers both miss shaders
 
     VkStridedDeviceAddressRegionKHR hitShaderSbtEntry{};
-    hitShaderSbtEntry.deviceAddress = hitShaderBindingTable->getDeviceAddress();
+    hitShaderSbtEntry.deviceAddress = variant.hitShaderBindingTable->getDeviceAddress();
     hitShaderSbtEntry.stride = handleSizeAligned;
-    hitShaderSbtEntry.size = handleSizeAligned;
+    hitShaderSbtEntry.size = handleSizeAligned * variant.pipeline->getHitGroupCount(); // One record per hit group
 
     VkStridedDeviceAddressRegionKHR callableShaderSbtEntry{}; // Not used yet
 
 
     // Dispatch the ray tracing commands
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, _rayTracingPipeline->getPipeline());
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, variant.pipeline->getPipeline());
 
     std::array<VkDescriptorSet, 1> descriptorSets = {
         _descriptorSets[_currentFrame]->getDescriptorSet()  // Per-frame descriptor set
     };
     vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR,
-        _rayTracingPipeline->getPipelineLayout(), 0, 1,
+        variant.pipeline->getPipelineLayout(), 0, 1,
         descriptorSets.data(), 0, nullptr);
 
-    // Trace rays with supersampling
-    vkrt::vkCmdTraceRaysKHR(
-        commandBuffer,
-        &raygenShaderSbtEntry,
-        &missShaderSbtEntry,
-        &hitShaderSbtEntry,
-        &callableShaderSbtEntry,
-        _swapChain->getSwapChainExtent().width * _supersampleScale,
-        _swapChain->getSwapChainExtent().height * _supersampleScale,
-        1
-    );
+    // Trace rays into the top-left sub-rectangle of the storage image at the current render scale,
+    // one launch per tile (a single full-size tile unless tiled dispatch is enabled)
+    _profiler->beginScope(commandBuffer, "Trace Rays");
+    for (const VkRect2D& tile : _traceTiles) {
+        TraceTilePushConstants pushConstants{};
+        pushConstants.offset = { static_cast<uint32_t>(tile.offset.x), static_cast<uint32_t>(tile.offset.y) };
+        pushConstants.imageSize = { _traceExtent.width, _traceExtent.height };
+        vkCmdPushConstants(commandBuffer, variant.pipeline->getPipelineLayout(),
+            VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR,
+            0, sizeof(TraceTilePushConstants), &pushConstants);
+
+        vkrt::vkCmdTraceRaysKHR(
+            commandBuffer,
+            &raygenShaderSbtEntry,
+            &missShaderSbtEntry,
+            &hitShaderSbtEntry,
+            &callableShaderSbtEntry,
+            tile.extent.width,
+            tile.extent.height,
+            1
+        );
+    }
+
+    _profiler->endScope(commandBuffer);
 
+    // Blend with the reprojected previous frame (only where tiles were traced this frame)
+    if (_temporalEnabled) {
+        GpuProfiler::Scope scope(_profiler.get(), commandBuffer, "Temporal");
+        _temporal->recordToCommandBuffer(commandBuffer, _currentFrame, _traceExtent, _prevViewProj, _prevCamPosition, _traceTiles);
+    }
+
+    // Edge-aware spatial filtering of the (accumulated) lighting
+    if (_denoiserEnabled) {
+        GpuProfiler::Scope scope(_profiler.get(), commandBuffer, "Denoise");
+        _denoiser->recordToCommandBuffer(commandBuffer, _traceExtent, _temporalEnabled);
+    }
+
+    // Resolve the HDR result into the target image (downsample / upscale, exposure, tonemap)
+    {
+        GpuProfiler::Scope scope(_profiler.get(), commandBuffer, "Tonemap");
+        _tonemapper->recordToCommandBuffer(commandBuffer, getHdrOutput(), _traceExtent, targetSwapImageIndex);
+    }
 }
 
 
 void RayTracingRenderer::createTLAS() {
-    _tlas = std::make_unique<TLAS>(_ctx, _sceneGraph->buildInstanceList());
+    // Headroom so added objects are rebuilt in place instead of reallocating
+    auto instances = _sceneGraph->buildInstanceList();
+    const uint32_t capacity = grownCapacity(0, instances.size() * 2);
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        _tlas[i] = std::make_unique<TLAS>(_ctx, instances, capacity);
+        _tlasInstances[i] = instances;
+    }
+}
+
+void RayTracingRenderer::updateTLAS(uint32_t slot) {
+    // Skip the refit while nothing moved (static scenes, accumulation samples). Slots that missed
+    // a change catch up the next time they are recorded.
+    auto instances = _sceneGraph->buildInstanceList();
+    const auto& slotInstances = _tlasInstances[slot];
+    if (instances.size() == slotInstances.size()
+        && memcmp(instances.data(), slotInstances.data(), instances.size() * sizeof(VkAccelerationStructureInstanceKHR)) == 0) {
+        return;
+    }
+
+    // Outgrown: only this slot gets a bigger TLAS, the old one is retired until its frames are
+    // done and the slot's descriptor set rebinds. Other slots follow when they are recorded.
+    if (instances.size() > _tlas[slot]->getCapacity()) {
+        const uint32_t capacity = grownCapacity(_tlas[slot]->getCapacity(), instances.size());
+        retire(std::move(_tlas[slot]));
+        _tlas[slot] = std::make_unique<TLAS>(_ctx, instances, capacity);
+        _tlasInstances[slot] = std::move(instances);
+        _sceneDescriptorSetStale[slot] = true;
+        return;
+    }
+
+    // The previous frames are still tracing their own TLAS, so the refit overlaps them. A refit
+    // keeps the instance count, added or removed objects rebuild in place.
+    GpuProfiler* profiler = _ctx->computeQueueTimestamps ? _profiler.get() : nullptr;
+    VkCommandBuffer commandBuffer = _asyncCompute->begin(slot);
+    if (instances.size() == _tlas[slot]->getInstanceCount()) {
+        _tlas[slot]->recordUpdate(commandBuffer, instances, profiler);
+    } else {
+        _tlas[slot]->recordRebuild(commandBuffer, instances, profiler);
+    }
+    const uint64_t refitDone = _asyncCompute->submit(slot);
+    _submitWaits.push_back({ _asyncCompute->getTimelineSemaphore(), refitDone, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR });
+    _tlasInstances[slot] = std::move(instances);
 }
 
-void RayTracingRenderer::updateTLAS() {
-    _tlas->update(_sceneGraph->buildInstanceList());
+void RayTracingRenderer::waitForLoadedResources() {
+    // Finished one time submissions release their command buffers and scratch memory
+    _ctx->graphicsSubmitter->poll();
+    _ctx->computeSubmitter->poll();
+
+    // Uploads queued since the last frame go out in one submission, the trace waits for it
+    const uint64_t uploadsDone = _ctx->stagingRing->submit();
+    if (uploadsDone > _uploadsWaited) {
+        _submitWaits.push_back({ _ctx->stagingRing->getTimelineSemaphore(), uploadsDone, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR });
+        _uploadsWaited = uploadsDone;
+    }
+
+    // Same for acceleration structure builds (one time work on the graphics queue is ordered by its barriers)
+    const uint64_t buildsDone = _ctx->computeSubmitter->getSubmittedValue();
+    if (buildsDone > _buildsWaited) {
+        _submitWaits.push_back({ _ctx->computeSubmitter->getTimelineSemaphore(), buildsDone, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR });
+        _buildsWaited = buildsDone;
+    }
 }
 
 void RayTracingRenderer::switchScene(std::unique_ptr<SceneContent> newScene)
 {
+    PROFILE_SCOPE("RayTracingRenderer::switchScene");
+    waitForPendingVariant();
     vkDeviceWaitIdle(_ctx->device);
 
     // Unload old scene
@@ -224,11 +451,17 @@ void RayTracingRenderer::switchScene(std::unique_ptr<SceneContent> newScene)
     // Load new scene
     newScene->onLoad();
     _sceneGraph->clearInstanceRebuildFlag(); // buffer is rebuilt below
-    _tlas.reset();
+
+    // Templates only the old scene used are the first to go (the GPU is idle here, so they are
+    // freed right away)
+    _sceneGraph->evictGeometry(getGeometryBudgetBytes());
+    _sceneGraph->releaseRetiredGeometry(getCompletedFrameValue());
+
+    for (auto& tlas : _tlas) tlas.reset();
 
     createTLAS();
-    _instanceDataBuffer.reset();
-    createInstanceDataBuffer();
+    stageSceneData();
+    createSceneDataBuffers();
     createDescriptorSets();
 
     // Update pointer
@@ -236,37 +469,172 @@ void RayTracingRenderer::switchScene(std::unique_ptr<SceneContent> newScene)
     spdlog::info("Scene switched successfully.");
 }
 
-void RayTracingRenderer::createInstanceDataBuffer() {
-    auto instanceDataArray = _sceneGraph->buildInstanceDataArray();
-    const VkDeviceSize bufferSize = sizeof(InstanceData) * instanceDataArray.size();
-    _instanceDataBuffer = std::make_unique<Buffer>(_ctx,
-        bufferSize,
-        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+void RayTracingRenderer::setCameraOrbit(float radius, float azimuth, float elevation) {
+    _camera->setRadius(radius);
+    _camera->setAzimuth(azimuth);
+    _camera->setElevation(elevation);
+}
+
+bool RayTracingRenderer::setScene(const std::string& name) {
+    if (name == "teapot") {
+        _sceneCombo = 0;
+        switchScene(std::make_unique<TeapotScene>(_ctx, *_sceneGraph));
+    } else if (name == "spheres") {
+        _sceneCombo = 1;
+        switchScene(std::make_unique<SpheresScene>(_ctx, *_sceneGraph));
+    } else {
+        spdlog::warn("Unknown scene '{}' (expected teapot or spheres)", name);
+        return false;
+    }
+    _temporal->resetHistory();
+    return true;
+}
+
+bool RayTracingRenderer::setMaterialPreset(const std::string& name) {
+    if (!_sceneContent->setMaterialPreset(name)) {
+        spdlog::warn("Material preset '{}' is not available in the current scene", name);
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> RayTracingRenderer::getMaterialPresets() const {
+    return _sceneContent->getMaterialPresets();
+}
+
+void RayTracingRenderer::setAccumulationSample(uint32_t sampleIndex) {
+    if (sampleIndex == 0) _temporal->resetHistory();
+    _temporal->accumulate = true;
+    _temporal->alpha = 1.0f / static_cast<float>(sampleIndex + 1);
+}
+
+void RayTracingRenderer::stageSceneData() {
+    _instanceData = _sceneGraph->buildInstanceDataArray();
+    _emissiveTriangles = _sceneGraph->buildEmissiveTriangleArray();
+    _ubo.emissiveTriangleCount = static_cast<uint32_t>(_emissiveTriangles.size());
+    spdlog::info("Light list: {} emissive triangles.", _emissiveTriangles.size());
+}
+
+void RayTracingRenderer::createSceneDataBuffers() {
+    // Nothing is in flight here, the old buffers go right away
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        _instanceDataBuffers[i].reset();
+        _emissiveTriangleBuffers[i].reset();
+        _instanceCapacity[i] = 0;
+        _emissiveTriangleCapacity[i] = 0;
+        growSceneDataBuffers(i);
+    }
+    _sceneDataStale.fill(true);
+    spdlog::info("Instance data buffers created with {} instances.", _instanceData.size());
+}
+
+void RayTracingRenderer::growSceneDataBuffers(uint32_t slot) {
+    if (!_instanceDataBuffers[slot] || _instanceData.size() > _instanceCapacity[slot]) {
+        _instanceCapacity[slot] = grownCapacity(_instanceCapacity[slot], _instanceData.size());
+        retire(std::move(_instanceDataBuffers[slot]));
+        _instanceDataBuffers[slot] = std::make_unique<Buffer>(_ctx,
+            sizeof(InstanceData) * _instanceCapacity[slot],
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        _sceneDescriptorSetStale[slot] = true;
+    }
+    if (!_emissiveTriangleBuffers[slot] || _emissiveTriangles.size() > _emissiveTriangleCapacity[slot]) {
+        _emissiveTriangleCapacity[slot] = grownCapacity(_emissiveTriangleCapacity[slot], _emissiveTriangles.size());
+        retire(std::move(_emissiveTriangleBuffers[slot]));
+        _emissiveTriangleBuffers[slot] = std::make_unique<Buffer>(_ctx,
+            sizeof(EmissiveTriangle) * _emissiveTriangleCapacity[slot],
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        _sceneDescriptorSetStale[slot] = true;
+    }
+}
+
+void RayTracingRenderer::uploadSceneData(uint32_t frame) {
+    if (!_sceneDataStale[frame]) return;
+
+    if (_instanceData.size() > _instanceCapacity[frame] || _emissiveTriangles.size() > _emissiveTriangleCapacity[frame]) {
+        growSceneDataBuffers(frame);
+        spdlog::debug("Slot {} scene buffers grown to {} instances, {} emissive triangles.",
+            frame, _instanceCapacity[frame], _emissiveTriangleCapacity[frame]);
+    }
+
+    if (!_instanceData.empty()) {
+        _instanceDataBuffers[frame]->copyData(_instanceData.data(), sizeof(InstanceData) * _instanceData.size());
+    }
+    if (!_emissiveTriangles.empty()) {
+        _emissiveTriangleBuffers[frame]->copyData(_emissiveTriangles.data(), sizeof(EmissiveTriangle) * _emissiveTriangles.size());
+    }
+    _sceneDataStale[frame] = false;
+}
+
+void RayTracingRenderer::createSamplerTablesBuffer() {
+    std::vector<uint8_t> tables = SamplerTables::buildBuffer();
+    _samplerTablesBuffer = std::make_unique<Buffer>(_ctx,
+        tables.size(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
     );
-    _instanceDataBuffer->copyData(instanceDataArray.data(), bufferSize);
-    spdlog::info("Instance data buffer created with {} instances.", instanceDataArray.size());
+    _ctx->stagingRing->upload(_samplerTablesBuffer->getBuffer(), 0, tables.data(), tables.size());
+    spdlog::info("Sampler tables buffer created ({} bytes).", tables.size());
 }
 
 void RayTracingRenderer::createDescriptorSets() {
 
-    // Create one descriptor set per frame in flight
-    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        std::vector<Descriptor> descriptors = {
-            // Bare minimum required descriptors for ray tracing
-            Descriptor(0, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, 1, _tlas->getDescriptorInfo()),
-            Descriptor(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_RAYGEN_BIT_KHR, 1, _storageImage->getDescriptorInfo()),
-            Descriptor(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, 1, _uniformBuffers[i]->getDescriptorInfo()),
-
-            // Instance data buffer (contains per-instance material and buffer addresses)
-            Descriptor(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR | VK_SHADER_STAGE_ANY_HIT_BIT_KHR, 1, _instanceDataBuffer->getDescriptorInfo())
-        };
-        _descriptorSets[i] = std::make_unique<DescriptorSet>(_ctx, descriptors);
+    // Create one descriptor set per frame in flight (callers have idled the device, so the old
+    // sets go right away instead of being retired)
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        _descriptorSets[i].reset();
+        createSceneDescriptorSet(i);
     }
+    createPostProcessDescriptorSets();
 
     spdlog::info("Descriptor sets created successfully.");
 }
 
+void RayTracingRenderer::createPostProcessDescriptorSets() {
+    // Reprojection pass reads the trace output (also drops the history)
+    _temporal->createDescriptorSets(*_storageImage, _uniformBuffers);
+    _denoiser->createDescriptorSets(*_storageImage, _temporal->getResolvedImage(), _temporal->getGBuffer());
+
+    std::vector<const StorageImage*> hdrSources = _denoiser->getOutputCandidates();
+    hdrSources.push_back(_storageImage.get());
+    hdrSources.push_back(&_temporal->getResolvedImage());
+    _tonemapper->createDescriptorSets(hdrSources);
+}
+
+void RayTracingRenderer::createSceneDescriptorSet(uint32_t slot) {
+    std::vector<Descriptor> descriptors = {
+        // Bare minimum required descriptors for ray tracing
+        Descriptor(0, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, 1, _tlas[slot]->getDescriptorInfo()),
+        Descriptor(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_RAYGEN_BIT_KHR, 1, _storageImage->getDescriptorInfo()),
+        Descriptor(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR | VK_SHADER_STAGE_MISS_BIT_KHR, 1, _uniformBuffers[slot]->getDescriptorInfo()),
+
+        // Instance data buffer (contains per-instance material and buffer addresses)
+        Descriptor(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR | VK_SHADER_STAGE_ANY_HIT_BIT_KHR, 1, _instanceDataBuffers[slot]->getDescriptorInfo()),
+
+        // Primary hit distance + instance id for temporal reprojection
+        Descriptor(4, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_RAYGEN_BIT_KHR, 1, _temporal->getGBuffer().getDescriptorInfo()),
+
+        // Denoiser guides (primary hit normal and albedo)
+        Descriptor(5, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_RAYGEN_BIT_KHR, 1, _denoiser->getNormalImage().getDescriptorInfo()),
+        Descriptor(6, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_RAYGEN_BIT_KHR, 1, _denoiser->getAlbedoImage().getDescriptorInfo()),
+
+        // Low discrepancy sampler tables
+        Descriptor(7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, 1, _samplerTablesBuffer->getDescriptorInfo()),
+
+        // Emissive triangles for light sampling
+        Descriptor(8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, 1, _emissiveTriangleBuffers[slot]->getDescriptorInfo()),
+
+        // Environment map + importance sampling table
+        Descriptor(9, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR | VK_SHADER_STAGE_MISS_BIT_KHR, 1, _environmentMap->getDescriptorInfo())
+    };
+    retire(std::move(_descriptorSets[slot]));
+    _descriptorSets[slot] = std::make_unique<DescriptorSet>(_ctx, descriptors);
+    _sceneDescriptorSetStale[slot] = false;
+}
+
 void RayTracingRenderer::createUniformBuffers() {
 
     // Create one uniform buffer per frame in flight
@@ -279,13 +647,38 @@ void RayTracingRenderer::createUniformBuffers() {
     }
 }
 
-void RayTracingRenderer::createRayTracingPipeline() {
+std::unique_ptr<RayTracingRenderer::PipelineVariant> RayTracingRenderer::createPipelineVariant(QualityPreset preset, const QualitySettings& quality, uint32_t shaderGeneration, VkDescriptorSetLayout sceneDSL) const {
 
-    VkDescriptorSetLayout sceneDSL = _descriptorSets[0]->getDescriptorSetLayout();
+    auto variant = std::make_unique<PipelineVariant>();
+    variant->preset = preset;
+    variant->quality = quality;
+    variant->shaderGeneration = shaderGeneration;
 
     RayTracingPipelineParams pipelineParams{};
     pipelineParams.descriptorSetLayouts = { sceneDSL };
-    pipelineParams.name = "RayTracingPipeline";
+    pipelineParams.pushConstantSize = sizeof(TraceTilePushConstants);
+    pipelineParams.pushConstantStages = VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+    pipelineParams.name = fmt::format("RayTracingPipeline depth={} shadows={}x{}",
+        quality.maxRecursionDepth, quality.shadowGridSize, quality.shadowGridSize);
+
+    // Trace nesting: the primary ray (level 1) hits at payload depth 0, hits below
+    // maxRecursionDepth trace bounces one level deeper, and every hit (the deepest one at payload
+    // depth maxRecursionDepth, level maxRecursionDepth + 1) casts shadow rays one more level down.
+    // Devices with a lower limit get fewer bounces so the shaders never trace past it, and a
+    // device that only allows primary rays (maxRayRecursionDepth == 1) skips shadow rays too.
+    const uint32_t deviceMaxDepth = _rayTracingPipelineProperties.maxRayRecursionDepth;
+    QualitySettings specialized = quality;
+    specialized.maxRecursionDepth = std::min(quality.maxRecursionDepth, deviceMaxDepth > 2 ? deviceMaxDepth - 2 : 0u);
+    specialized.shadowRays = deviceMaxDepth >= specialized.maxRecursionDepth + 2 ? VK_TRUE : VK_FALSE;
+    pipelineParams.maxRecursionDepth = std::min(specialized.maxRecursionDepth + 2, deviceMaxDepth);
+    if (!specialized.shadowRays) {
+        spdlog::warn("Device ray recursion depth {} is too shallow for shadow rays, direct light is unshadowed", deviceMaxDepth);
+    }
+
+    // Quality knobs are baked in through specialization constants
+    pipelineParams.specializationEntries = Quality::getSpecializationEntries();
+    pipelineParams.specializationData.resize(sizeof(QualitySettings));
+    memcpy(pipelineParams.specializationData.data(), &specialized, sizeof(QualitySettings));
 
     // Setup miss shaders: primary miss (index 0) and shadow miss (index 1)
     std::vector<std::string> missShaderPaths = {
@@ -293,25 +686,36 @@ void RayTracingRenderer::createRayTracingPipeline() {
         AssetPath::getInstance()->get("spv/shadow_rmiss.spv")
     };
 
-    _rayTracingPipeline = std::make_unique<RayTracingPipeline>(_ctx,
+    // Setup hit groups, one per material class in HitGroup order (selected by the instance SBT offset)
+    std::vector<std::string> closestHitShaderPaths(static_cast<size_t>(HitGroup::Count));
+    closestHitShaderPaths[static_cast<size_t>(HitGroup::Emissive)]   = AssetPath::getInstance()->get("spv/emissive_rchit.spv");
+    closestHitShaderPaths[static_cast<size_t>(HitGroup::PBR)]        = AssetPath::getInstance()->get("spv/pbr_rchit.spv");
+    closestHitShaderPaths[static_cast<size_t>(HitGroup::Dielectric)] = AssetPath::getInstance()->get("spv/dielectric_rchit.spv");
+    closestHitShaderPaths[static_cast<size_t>(HitGroup::Checker)]    = AssetPath::getInstance()->get("spv/checker_rchit.spv");
+
+    variant->pipeline = std::make_unique<RayTracingPipeline>(_ctx,
         AssetPath::getInstance()->get("spv/raygen_rgen.spv"),
         missShaderPaths,
-        AssetPath::getInstance()->get("spv/closesthit_rchit.spv"),
+        closestHitShaderPaths,
         AssetPath::getInstance()->get("spv/shadow_rahit.spv"),
         pipelineParams);
+
+    createShaderBindingTables(*variant);
+
+    return variant;
 }
 
-void RayTracingRenderer::createShaderBindingTables() {
+void RayTracingRenderer::createShaderBindingTables(PipelineVariant& variant) const {
     const uint32_t handleSize = _rayTracingPipelineProperties.shaderGroupHandleSize;
     const uint32_t handleSizeAligned = VulkanHelper::alignedSize(handleSize, _rayTracingPipelineProperties.shaderGroupHandleAlignment);
-    const uint32_t groupCount = _rayTracingPipeline->getShaderGroups().size();
+    const uint32_t groupCount = variant.pipeline->getShaderGroups().size();
     const uint32_t sbtSize = groupCount * handleSizeAligned;
 
     // Get shader group handles
     std::vector<uint8_t> shaderHandleStorage(sbtSize);
     if (vkrt::vkGetRayTracingShaderGroupHandlesKHR(
             _ctx->device,
-            _rayTracingPipeline->getPipeline(),
+            variant.pipeline->getPipeline(),
             0,
             groupCount,
             sbtSize,
@@ -325,27 +729,108 @@ void RayTracingRenderer::createShaderBindingTables() {
 	const VkMemoryPropertyFlags memoryPropsFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
 
     // Raygen shader (group 0)
-    raygenShaderBindingTable = std::make_unique<Buffer>(_ctx, handleSizeAligned, bufferUsageFlags, memoryPropsFlags, true);
-    raygenShaderBindingTable->copyData(shaderHandleStorage.data() + 0*handleSizeAligned, handleSize);
+    variant.raygenShaderBindingTable = std::make_unique<Buffer>(_ctx, handleSizeAligned, bufferUsageFlags, memoryPropsFlags, true);
+    variant.raygenShaderBindingTable->copyData(shaderHandleStorage.data() + 0*handleSizeAligned, handleSize);
 
     // Miss shaders (groups 1 and 2: primary miss and shadow miss)
     const uint32_t missShaderCount = 2;
-    missShaderBindingTable = std::make_unique<Buffer>(_ctx, missShaderCount * handleSizeAligned, bufferUsageFlags, memoryPropsFlags, true);
+    variant.missShaderBindingTable = std::make_unique<Buffer>(_ctx, missShaderCount * handleSizeAligned, bufferUsageFlags, memoryPropsFlags, true);
 
     // Copy each miss shader handle individually with proper alignment
     for (uint32_t i = 0; i < missShaderCount; i++) {
-        missShaderBindingTable->copyData(
+        variant.missShaderBindingTable->copyData(
             shaderHandleStorage.data() + (1 + i) * handleSizeAligned,
             handleSize,
             i * handleSizeAligned
         );
     }
 
-    // Hit shader (group 3)
-    hitShaderBindingTable = std::make_unique<Buffer>(_ctx, handleSizeAligned, bufferUsageFlags, memoryPropsFlags, true);
-    hitShaderBindingTable->copyData(shaderHandleStorage.data() + 3*handleSizeAligned, handleSize);
+    // Hit groups (groups 3 .. 3 + hitGroupCount - 1), record i is selected by instance SBT offset i
+    const uint32_t hitGroupCount = variant.pipeline->getHitGroupCount();
+    variant.hitShaderBindingTable = std::make_unique<Buffer>(_ctx, hitGroupCount * handleSizeAligned, bufferUsageFlags, memoryPropsFlags, true);
+    for (uint32_t i = 0; i < hitGroupCount; i++) {
+        variant.hitShaderBindingTable->copyData(
+            shaderHandleStorage.data() + (1 + missShaderCount + i) * handleSizeAligned,
+            handleSize,
+            i * handleSizeAligned
+        );
+    }
 
-    spdlog::info("Shader binding tables created successfully 1 raygen, {} miss shaders, 1 hit shader", missShaderCount);
+    spdlog::info("Shader binding tables created successfully 1 raygen, {} miss shaders, {} hit groups", missShaderCount, hitGroupCount);
+}
+
+QualitySettings RayTracingRenderer::getRequestedSettings() const {
+    QualitySettings quality = Quality::getSettings(_qualityPreset);
+    quality.samplerType = static_cast<uint32_t>(_samplerType);
+    return quality;
+}
+
+void RayTracingRenderer::requestPipelineVariant() {
+    // Only one background build at a time, the latest request wins
+    if (_pendingVariant.valid()) {
+        _variantRequestQueued = true;
+        return;
+    }
+
+    QualityPreset preset = _qualityPreset;
+    QualitySettings quality = getRequestedSettings();
+    uint32_t shaderGeneration = _shaderGeneration;
+    if (_pipelineVariant && _pipelineVariant->quality == quality && _pipelineVariant->shaderGeneration == shaderGeneration) return;
+
+    spdlog::info("Building pipeline variant (quality '{}', sampler '{}') in the background...",
+        Quality::toString(_qualityPreset), SamplerTables::toString(_samplerType));
+    VkDescriptorSetLayout sceneDSL = _descriptorSets[0]->getDescriptorSetLayout();
+    _pendingVariant = std::async(std::launch::async, [this, preset, quality, shaderGeneration, sceneDSL]() {
+        return createPipelineVariant(preset, quality, shaderGeneration, sceneDSL);
+    });
+}
+
+void RayTracingRenderer::pollPipelineVariant() {
+    // Release variants that no frame in flight can reference anymore
+    for (auto& retired : _retiredVariants) retired.framesLeft--;
+    _retiredVariants.erase(
+        std::remove_if(_retiredVariants.begin(), _retiredVariants.end(),
+            [](const RetiredVariant& retired) { return retired.framesLeft == 0; }),
+        _retiredVariants.end());
+
+    if (!_pendingVariant.valid()) return;
+    if (_pendingVariant.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+    try {
+        std::unique_ptr<PipelineVariant> variant = _pendingVariant.get();
+        _retiredVariants.push_back({ std::move(_pipelineVariant), MAX_FRAMES_IN_FLIGHT });
+        _pipelineVariant = std::move(variant);
+        spdlog::info("Swapped in pipeline variant (quality '{}', sampler '{}').",
+            Quality::toString(_pipelineVariant->preset), SamplerTables::toString(static_cast<SamplerType>(_pipelineVariant->quality.samplerType)));
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to build pipeline variant: {}", e.what());
+        // Fall back to what is actually running unless a newer request is already waiting
+        if (!_variantRequestQueued) {
+            _qualityPreset = _pipelineVariant->preset;
+            _samplerType = static_cast<SamplerType>(_pipelineVariant->quality.samplerType);
+        }
+    }
+
+    // Kick off the most recent request that arrived while we were busy
+    if (_variantRequestQueued) {
+        _variantRequestQueued = false;
+        requestPipelineVariant();
+    }
+}
+
+void RayTracingRenderer::waitForPendingVariant() {
+    if (_pendingVariant.valid()) _pendingVariant.wait();
+}
+
+void RayTracingRenderer::releaseRetiredResources() {
+    // A background build may have been handed the set layout of a retired descriptor set
+    if (_pendingVariant.valid() || _retiredResources.empty()) return;
+
+    const uint64_t completed = getCompletedFrameValue();
+    _retiredResources.erase(
+        std::remove_if(_retiredResources.begin(), _retiredResources.end(),
+            [completed](const RetiredResource& retired) { return retired.frameValue <= completed; }),
+        _retiredResources.end());
 }
 
 
@@ -366,6 +851,174 @@ void RayTracingRenderer::buildUI() {
 
     ImGui::Separator();
 
+    // Render resolution
+    ImGui::Text(ICON_FA_EXPAND " Resolution");
+    ImGui::Indent(16.0f);
+        bool dynamicResolution = _dynamicResolution->isEnabled();
+        if (ImGui::Checkbox("Dynamic Resolution", &dynamicResolution)) {
+            _dynamicResolution->setEnabled(dynamicResolution && _profiler->isSupported());
+            if (_dynamicResolution->isEnabled()) _tiledDispatch->setEnabled(false);
+        }
+        if (dynamicResolution) {
+            float budget = _dynamicResolution->getTargetFrameTime();
+            if (ImGui::SliderFloat("Budget (ms)", &budget, 2.0f, 50.0f, "%.1f")) {
+                _dynamicResolution->setTargetFrameTime(budget);
+            }
+        } else {
+            float scale = _dynamicResolution->getScale();
+            if (ImGui::SliderFloat("Scale", &scale, _dynamicResolution->getMinScale(), _dynamicResolution->getMaxScale(), "%.2fx")) {
+                _dynamicResolution->setScale(scale);
+            }
+        }
+        ImGui::Text("%ux%u @ %.2fx  (trace %.2f ms)",
+            _traceExtent.width, _traceExtent.height, _dynamicResolution->getScale(), _dynamicResolution->getSmoothedFrameTime());
+    ImGui::Unindent(16.0f);
+
+    ImGui::Separator();
+
+    // Tiled dispatch
+    ImGui::Text(ICON_FA_TH " Tiled Dispatch");
+    ImGui::Indent(16.0f);
+        bool tiled = _tiledDispatch->isEnabled();
+        if (ImGui::Checkbox("Progressive Tiles", &tiled)) {
+            _tiledDispatch->setEnabled(tiled && _profiler->isSupported());
+            if (_tiledDispatch->isEnabled()) _dynamicResolution->setEnabled(false);
+        }
+        if (tiled) {
+            float budget = _tiledDispatch->getBudget();
+            if (ImGui::SliderFloat("Trace Budget (ms)", &budget, 1.0f, 50.0f, "%.1f")) {
+                _tiledDispatch->setBudget(budget);
+            }
+            int tileSize = static_cast<int>(_tiledDispatch->getTileSize());
+            if (ImGui::SliderInt("Tile Size", &tileSize, 32, 512)) {
+                _tiledDispatch->setTileSize(static_cast<uint32_t>(tileSize));
+            }
+            int order = static_cast<int>(_tiledDispatch->getOrder());
+            const char* orders[] = {
+                TiledDispatch::toString(TileOrder::Scanline),
+                TiledDispatch::toString(TileOrder::CenterOut),
+                TiledDispatch::toString(TileOrder::Random)
+            };
+            if (ImGui::Combo("Order", &order, orders, 3)) {
+                _tiledDispatch->setOrder(static_cast<TileOrder>(order));
+            }
+            ImGui::ProgressBar(_tiledDispatch->getProgress(), ImVec2(-1.0f, 0.0f),
+                fmt::format("{}/{} tiles", _tiledDispatch->getLastTileCount(), _tiledDispatch->getTileCount()).c_str());
+            ImGui::Text("Passes: %u  (%.2f ms/MPix)", _tiledDispatch->getCompletedPasses(), _tiledDispatch->getSmoothedTimePerMegapixel());
+        }
+    ImGui::Unindent(16.0f);
+
+    ImGui::Separator();
+
+    // Temporal reprojection
+    ImGui::Text(ICON_FA_HISTORY " Temporal");
+    ImGui::Indent(16.0f);
+        if (ImGui::Checkbox("Reproject History", &_temporalEnabled)) {
+            _temporal->resetHistory();
+        }
+        if (_temporalEnabled) {
+            ImGui::SliderFloat("Blend", &_temporal->alpha, 0.02f, 1.0f, "%.2f");
+            ImGui::SliderFloat("Depth Tolerance", &_temporal->depthTolerance, 0.001f, 0.2f, "%.3f");
+        }
+    ImGui::Unindent(16.0f);
+
+    ImGui::Separator();
+
+    // Spatial denoiser
+    ImGui::Text(ICON_FA_MAGIC " Denoiser");
+    ImGui::Indent(16.0f);
+        ImGui::Checkbox("A-Trous Filter", &_denoiserEnabled);
+        if (_denoiserEnabled) {
+            ImGui::SliderInt("Iterations", &_denoiser->iterations, 1, 5);
+            ImGui::SliderFloat("Color Sigma", &_denoiser->sigmaColor, 0.1f, 20.0f, "%.2f");
+            ImGui::SliderFloat("Normal Sigma", &_denoiser->sigmaNormal, 1.0f, 256.0f, "%.0f");
+            ImGui::SliderFloat("Depth Sigma", &_denoiser->sigmaDepth, 0.001f, 0.5f, "%.3f");
+        }
+    ImGui::Unindent(16.0f);
+
+    ImGui::Separator();
+
+    // Exposure + tonemapping
+    ImGui::Text(ICON_FA_SUN " Tonemapping");
+    ImGui::Indent(16.0f);
+        ImGui::SliderFloat("Exposure (EV)", &_tonemapper->exposure, -6.0f, 6.0f, "%.1f");
+        int tonemapOperator = static_cast<int>(_tonemapper->tonemapOperator);
+        const char* operators[] = {
+            Tonemapper::toString(TonemapOperator::Clamp),
+            Tonemapper::toString(TonemapOperator::Reinhard),
+            Tonemapper::toString(TonemapOperator::Aces)
+        };
+        if (ImGui::Combo("Operator", &tonemapOperator, operators, 3)) {
+            _tonemapper->tonemapOperator = static_cast<TonemapOperator>(tonemapOperator);
+        }
+        int filter = static_cast<int>(_tonemapper->filter);
+        const char* filters[] = {
+            Tonemapper::toString(ReconstructionFilter::Box),
+            Tonemapper::toString(ReconstructionFilter::Gaussian),
+            Tonemapper::toString(ReconstructionFilter::Mitchell)
+        };
+        if (ImGui::Combo("Filter", &filter, filters, 3)) {
+            _tonemapper->filter = static_cast<ReconstructionFilter>(filter);
+        }
+    ImGui::Unindent(16.0f);
+
+    ImGui::Separator();
+
+    // Environment map
+    if (_environmentMap->isLoaded()) {
+        ImGui::Text(ICON_FA_GLOBE " Environment");
+        ImGui::Indent(16.0f);
+            ImGui::Checkbox("HDR Environment", &_environmentEnabled);
+            if (_environmentEnabled) {
+                ImGui::SliderFloat("Intensity", &_environmentIntensity, 0.0f, 4.0f, "%.2f");
+            }
+            ImGui::TextDisabled("%ux%u", _environmentMap->getWidth(), _environmentMap->getHeight());
+        ImGui::Unindent(16.0f);
+
+        ImGui::Separator();
+    }
+
+    // Quality preset selector
+    ImGui::Text(ICON_FA_SLIDERS_H " Quality");
+    ImGui::Indent(16.0f);
+        const char* presets[] = { "Draft", "Interactive", "Final" };
+        int qualityCombo = static_cast<int>(_pipelineVariant->preset);
+        if (ImGui::Combo("##quality", &qualityCombo, presets, 3)) {
+            _qualityPreset = static_cast<QualityPreset>(qualityCombo);
+            requestPipelineVariant();
+        }
+        const char* samplers[] = { "Sobol (Owen)", "R2", "Blue Noise" };
+        int samplerCombo = static_cast<int>(_samplerType);
+        if (ImGui::Combo("Sampler", &samplerCombo, samplers, 3)) {
+            _samplerType = static_cast<SamplerType>(samplerCombo);
+            requestPipelineVariant();
+        }
+        if (_pendingVariant.valid()) {
+            ImGui::SameLine();
+            ImGui::TextDisabled(ICON_FA_SPINNER " building...");
+        }
+    ImGui::Unindent(16.0f);
+
+    ImGui::Separator();
+
+    // Shader hot reload status + compile errors
+    if (_shaderHotReload->isActive()) {
+        ImGui::Text(ICON_FA_CODE " Shaders");
+        ImGui::Indent(16.0f);
+            if (_shaderHotReload->isCompiling()) {
+                ImGui::TextDisabled(ICON_FA_SPINNER " compiling...");
+            } else if (!_shaderHotReload->getErrorLog().empty()) {
+                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
+                ImGui::TextWrapped("%s", _shaderHotReload->getErrorLog().c_str());
+                ImGui::PopStyleColor();
+            } else {
+                ImGui::TextDisabled("Watching for changes (%u reloads)", _shaderHotReload->getReloadCount());
+            }
+        ImGui::Unindent(16.0f);
+
+        ImGui::Separator();
+    }
+
     // Scene selector
     ImGui::Text(ICON_FA_FILM " Scene");
     ImGui::Indent(16.0f);
@@ -374,6 +1027,13 @@ void RayTracingRenderer::buildUI() {
             if (_sceneCombo == 0) switchScene(std::make_unique<TeapotScene>(_ctx, *_sceneGraph));
             else                  switchScene(std::make_unique<SpheresScene>(_ctx, *_sceneGraph));
         }
+
+        // Applied once the slider is let go, eviction needs an idle GPU
+        ImGui::SliderInt("Geometry Budget (MiB)", &_geometryBudgetMiB, 16, 4096);
+        if (ImGui::IsItemDeactivatedAfterEdit()) _geometryBudgetChanged = true;
+        const SceneGraph::GeometryResidency residency = _sceneGraph->getGeometryResidency();
+        ImGui::Text("%u / %u templates resident (%.1f MiB)", residency.residentCount, residency.templateCount,
+            residency.residentBytes / (1024.0 * 1024.0));
     ImGui::Unindent(16.0f);
 
     // Scene-specific controls
@@ -11,12 +11,26 @@
 #include "vulkan/DescriptorSet.h"
 #include "scene/TurnTableCamera.h"
 #include "scene/SceneContent.h"
+#include "scene/QualityPreset.h"
+#include "scene/DynamicResolution.h"
+#include "scene/TiledDispatch.h"
+#include "scene/TemporalReprojection.h"
+#include "scene/Denoiser.h"
+#include "scene/Tonemapper.h"
+#include "scene/SamplerTables.h"
+#include "scene/EnvironmentMap.h"
+#include "vulkan/ShaderHotReload.h"
+#include "vulkan/GpuProfiler.h"
+#include "vulkan/AsyncCompute.h"
+#include "core/LaunchOptions.h"
+
+#include <future>
 
 
 class RayTracingRenderer : public Renderer
 {
 public:
-    RayTracingRenderer(std::shared_ptr<VulkanContext> ctx, std::shared_ptr<SwapChain> swapChain);
+    RayTracingRenderer(std::shared_ptr<VulkanContext> ctx, std::shared_ptr<RenderTarget> target, const LaunchOptions& options = LaunchOptions());
     ~RayTracingRenderer();
 
     void update(uint32_t currentImage) override;
@@ -28,31 +42,46 @@ public:
     void handleMouseWheel(float dy) override;
     void handleKeyDown(int key, int scancode, int mods) override;
 
-    VkImage getOutputImage() const override { return _storageImage->getImage(); }
-    VkExtent2D getOutputExtent() const override {
-        return { _swapChain->getSwapChainExtent().width  * _supersampleScale,
-                 _swapChain->getSwapChainExtent().height * _supersampleScale };
-    }
+    VkImage getOutputImage() const override { return _tonemapper->getOutputImage(); }
+    VkExtent2D getOutputExtent() const override { return _tonemapper->getExtent(); }
 
     void buildUI() override;
 
+    GpuProfiler* getGpuProfiler() override { return _profiler.get(); }
+    std::vector<SubmitWait> takeSubmitWaits() override { return std::exchange(_submitWaits, {}); }
+
+    // Offline control (batch rendering): scripted camera, scene and time instead of input + wall clock
+    void setCameraOrbit(float radius, float azimuth, float elevation);
+    bool setScene(const std::string& name);             // "teapot" or "spheres"
+    bool setMaterialPreset(const std::string& name);    // Forwarded to the active scene content
+    std::vector<std::string> getMaterialPresets() const;
+    void setFixedTimeStep(std::optional<float> dt) { _fixedTimeStep = dt; }
+    // Sample 0 drops the temporal history, later samples blend in as a running mean (unclamped)
+    void setAccumulationSample(uint32_t sampleIndex);
+    void setDenoiserEnabled(bool enabled) { _denoiserEnabled = enabled; }
+
 private:
 
     // Physical Device Properties / Features
     VkPhysicalDeviceRayTracingPipelinePropertiesKHR _rayTracingPipelineProperties{};
     VkPhysicalDeviceAccelerationStructureFeaturesKHR _accelerationStructureFeatures{};
 
-    // Storage Image
+    // Storage Image (HDR, allocated at the current render scale and grown when the scale rises
+    // past it, traced into a sub-rectangle)
     std::unique_ptr<StorageImage> _storageImage;
+    float _allocatedScale = 0.0f;
+    void createStorageImage();
+    void growTraceImages();
+    const StorageImage& getHdrOutput() const;   // Last HDR pass of the frame (trace, temporal or denoiser)
 
     // Uniform Buffer
     struct UniformData {
 		glm::mat4 viewInverse;
 		glm::mat4 projInverse;
-        glm::vec3 camPosition; float pad0;
-        glm::vec3 lightPosition; float pad1;
-        glm::vec3 lightU; float pad2;
-        glm::vec3 lightV; float pad3;
+        glm::vec3 camPosition; uint32_t frameIndex;
+        glm::vec3 lightPosition; uint32_t emissiveTriangleCount;
+        glm::vec3 lightU; float environmentIntensity;
+        glm::vec3 lightV; uint32_t environmentEnabled;
 	} _ubo;
     std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> _uniformBuffers;
     void createUniformBuffers();
@@ -60,19 +89,92 @@ private:
     // Scene Descriptor Set
     std::array<std::unique_ptr<DescriptorSet>, MAX_FRAMES_IN_FLIGHT> _descriptorSets;
     void createDescriptorSets();
+    void createSceneDescriptorSet(uint32_t slot);   // Binds the slot's TLAS and scene buffers
+    void createPostProcessDescriptorSets();          // Reprojection, denoiser and tonemap inputs
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> _sceneDescriptorSetStale{};  // Slot resources were replaced
+
+    // Ray Tracing Pipeline + SBT, specialized for one set of quality settings
+    struct PipelineVariant {
+        QualityPreset preset = QualityPreset::Final;
+        QualitySettings quality;
+        uint32_t shaderGeneration = 0;  // Bumped by every shader hot reload
+        std::unique_ptr<RayTracingPipeline> pipeline;
+        std::unique_ptr<Buffer> raygenShaderBindingTable;
+        std::unique_ptr<Buffer> missShaderBindingTable;
+        std::unique_ptr<Buffer> hitShaderBindingTable;
+    };
+    std::unique_ptr<PipelineVariant> _pipelineVariant;
+    std::unique_ptr<PipelineVariant> createPipelineVariant(QualityPreset preset, const QualitySettings& quality, uint32_t shaderGeneration, VkDescriptorSetLayout sceneDSL) const;
+    void createShaderBindingTables(PipelineVariant& variant) const;
+
+    // Requested quality preset + sampler (variants are built on a worker thread and swapped in
+    // when ready, the active ones are the variant's)
+    QualityPreset _qualityPreset = QualityPreset::Final;
+    SamplerType _samplerType = SamplerType::SobolOwen;
+    bool _variantRequestQueued = false;
+    std::future<std::unique_ptr<PipelineVariant>> _pendingVariant;
+    QualitySettings getRequestedSettings() const;
+    void requestPipelineVariant();
+    void pollPipelineVariant();
+    void waitForPendingVariant();
+
+    // Shader hot reload (recompiled SPIR-V triggers a new variant, active only with glslang)
+    std::unique_ptr<ShaderHotReload> _shaderHotReload;
+    uint32_t _shaderGeneration = 0;
+
+    // Variants replaced while frames in flight may still reference them
+    struct RetiredVariant {
+        std::unique_ptr<PipelineVariant> variant;
+        uint32_t framesLeft;
+    };
+    std::vector<RetiredVariant> _retiredVariants;
+
+    // Per slot resources replaced while frames in flight may still reference them, released once
+    // the frame being recorded when they were replaced has finished (held while a variant build
+    // may still use a retired set layout)
+    struct RetiredResource {
+        std::shared_ptr<void> resource;
+        uint64_t frameValue;
+    };
+    std::vector<RetiredResource> _retiredResources;
+    template <typename T>
+    void retire(std::unique_ptr<T> resource) {
+        if (resource) _retiredResources.push_back({ std::shared_ptr<T>(std::move(resource)), _frameValue });
+    }
+    void releaseRetiredResources();
+
+    // Temporal reprojection (history reuse across frames)
+    std::unique_ptr<TemporalReprojection> _temporal;
+    bool _temporalEnabled = true;
+    uint32_t _frameIndex = 0;
+    glm::mat4 _viewProj = glm::mat4(1.0f);
+    glm::mat4 _prevViewProj = glm::mat4(1.0f);
+    glm::vec3 _prevCamPosition = glm::vec3(0.0f);
 
-    // Ray Tracing Pipeline
-    std::unique_ptr<RayTracingPipeline> _rayTracingPipeline;
-    void createRayTracingPipeline();
+    // Spatial denoiser (runs after temporal reprojection)
+    std::unique_ptr<Denoiser> _denoiser;
+    bool _denoiserEnabled = true;
 
-    // SBT
-    std::unique_ptr<Buffer> raygenShaderBindingTable;
-    std::unique_ptr<Buffer> missShaderBindingTable;
-    std::unique_ptr<Buffer> hitShaderBindingTable;
-    void createShaderBindingTables();
+    // Resolve (reconstruction filter) + exposure + tonemap into the render target
+    std::unique_ptr<Tonemapper> _tonemapper;
 
-    // Super Sampling Anti-Aliasing (SSAA)
-    const uint32_t _supersampleScale = 2;
+    // Render scale: > 1 supersamples (SSAA), < 1 traces below native and upscales in the tonemap pass
+    std::unique_ptr<DynamicResolution> _dynamicResolution;
+    VkExtent2D _traceExtent{};
+
+    // Tiled dispatch: traces a time budgeted part of the image per frame (exclusive with dynamic resolution)
+    std::unique_ptr<TiledDispatch> _tiledDispatch;
+    std::vector<VkRect2D> _traceTiles;                                 // Tiles recorded this frame
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> _tracedPixels{};        // Per slot, matched with its trace time
+
+    // Must match the push constant block in common/tile.glsl
+    struct TraceTilePushConstants {
+        glm::uvec2 offset;
+        glm::uvec2 imageSize;
+    };
+
+    // GPU pass timings (the trace pass time drives the dynamic resolution controller)
+    std::unique_ptr<GpuProfiler> _profiler;
 
     // Camera
     std::unique_ptr<TurnTableCamera> _camera;
@@ -81,6 +183,7 @@ private:
     // Time
     float _time = 0.0f;
     bool _isPaused = false;
+    std::optional<float> _fixedTimeStep;  // Replaces the wall clock delta when set
     TimePoint _lastFrameTime = std::chrono::high_resolution_clock::now();
 
     // Scene graph (geometry templates + scene objects)
@@ -91,14 +194,49 @@ private:
     int _sceneCombo = 0;
     void switchScene(std::unique_ptr<SceneContent> newScene);
 
-    // Top Level Acceleration Structure (TLAS)
-    std::unique_ptr<TLAS> _tlas;
+    // Geometry templates no object uses are evicted (least recently used first) while the
+    // resident ones take more than this. Applied on scene switches and when lowered in the UI.
+    int _geometryBudgetMiB = 256;
+    bool _geometryBudgetChanged = false;
+    VkDeviceSize getGeometryBudgetBytes() const { return static_cast<VkDeviceSize>(_geometryBudgetMiB) << 20; }
+
+    // Top Level Acceleration Structure (TLAS), one per frame slot. A slot's TLAS is refit on the
+    // compute queue when the slot is recorded, the frame's graphics submit waits for the refit.
+    std::array<std::unique_ptr<TLAS>, MAX_FRAMES_IN_FLIGHT> _tlas;
+    std::array<std::vector<VkAccelerationStructureInstanceKHR>, MAX_FRAMES_IN_FLIGHT> _tlasInstances;  // Instances of each slot's last build/refit
+    std::unique_ptr<AsyncCompute> _asyncCompute;
+    std::vector<SubmitWait> _submitWaits;
+    uint64_t _uploadsWaited = 0;  // Last staging ring value a frame waited for
+    uint64_t _buildsWaited = 0;   // Last computeSubmitter value a frame waited for
     void createTLAS();
-    void updateTLAS();
-
-    // Instance Data Buffer
-    std::unique_ptr<Buffer> _instanceDataBuffer;
-    void createInstanceDataBuffer();
+    void updateTLAS(uint32_t slot);
+    // Makes this frame wait for uploads and acceleration structure builds queued since the last one
+    void waitForLoadedResources();
+
+    // Instance data + emissive triangles (light list + alias table for next event estimation).
+    // One buffer of each per frame slot: scene edits are staged on the host and written to a slot
+    // when it is next recorded, so the GPU never reads a buffer that is being overwritten. A slot
+    // that outgrows its buffers replaces them (doubling the capacity) when it is recorded.
+    std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> _instanceDataBuffers;
+    std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT> _emissiveTriangleBuffers;
+    std::vector<InstanceData> _instanceData;
+    std::vector<EmissiveTriangle> _emissiveTriangles;
+    std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> _instanceCapacity{};
+    std::array<uint32_t, MAX_FRAMES_IN_FLIGHT> _emissiveTriangleCapacity{};
+    std::array<bool, MAX_FRAMES_IN_FLIGHT> _sceneDataStale{};
+    void stageSceneData();
+    void createSceneDataBuffers();      // All slots sized for the staged data (device idle)
+    void growSceneDataBuffers(uint32_t slot);
+    void uploadSceneData(uint32_t frame);
+
+    // HDR environment map (importance sampled, replaces the procedural sky and ambient term)
+    std::unique_ptr<EnvironmentMap> _environmentMap;
+    bool _environmentEnabled = true;
+    float _environmentIntensity = 1.0f;
+
+    // Sobol direction numbers + blue noise tile for the low discrepancy samplers
+    std::unique_ptr<Buffer> _samplerTablesBuffer;
+    void createSamplerTablesBuffer();
 
     // Misc
     void saveSceneState(const std::string& filename);
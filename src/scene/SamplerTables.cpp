@@ -0,0 +1,150 @@
+#include "scene/SamplerTables.h"
+
+#include <limits>
+
+
+namespace SamplerTables {
+
+    std::vector<float> generateBlueNoise(uint32_t size, uint32_t seed, float sigma) {
+        const uint32_t n = size * size;
+
+        // Gaussian energy kernel indexed by toroidal offset
+        std::vector<float> kernel(n);
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                float dx = static_cast<float>(std::min(x, size - x));
+                float dy = static_cast<float>(std::min(y, size - y));
+                kernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.0f * sigma * sigma));
+            }
+        }
+
+        auto splat = [&](std::vector<float>& energy, uint32_t index, float sign) {
+            const uint32_t px = index % size;
+            const uint32_t py = index / size;
+            for (uint32_t y = 0; y < size; y++) {
+                const uint32_t dy = (y + size - py) % size;
+                for (uint32_t x = 0; x < size; x++) {
+                    const uint32_t dx = (x + size - px) % size;
+                    energy[y * size + x] += sign * kernel[dy * size + dx];
+                }
+            }
+        };
+
+        // Tightest cluster = highest energy among set pixels, largest void = lowest energy among empty pixels
+        auto tightestCluster = [&](const std::vector<uint8_t>& pattern, const std::vector<float>& energy, uint8_t value) {
+            uint32_t best = 0;
+            float bestEnergy = -std::numeric_limits<float>::max();
+            for (uint32_t i = 0; i < n; i++) {
+                if (pattern[i] == value && energy[i] > bestEnergy) { bestEnergy = energy[i]; best = i; }
+            }
+            return best;
+        };
+        auto largestVoid = [&](const std::vector<uint8_t>& pattern, const std::vector<float>& energy) {
+            uint32_t best = 0;
+            float bestEnergy = std::numeric_limits<float>::max();
+            for (uint32_t i = 0; i < n; i++) {
+                if (pattern[i] == 0 && energy[i] < bestEnergy) { bestEnergy = energy[i]; best = i; }
+            }
+            return best;
+        };
+
+        // Initial binary pattern: ~10% random points
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32_t> pick(0, n - 1);
+        std::vector<uint8_t> pattern(n, 0);
+        std::vector<float> energy(n, 0.0f);
+        uint32_t onesCount = 0;
+        while (onesCount < std::max(n / 10, 1u)) {
+            uint32_t i = pick(rng);
+            if (pattern[i]) continue;
+            pattern[i] = 1;
+            splat(energy, i, 1.0f);
+            onesCount++;
+        }
+
+        // Relax into a blue noise pattern: move points from the tightest cluster into the largest void
+        for (uint32_t iteration = 0; iteration < n; iteration++) {
+            uint32_t cluster = tightestCluster(pattern, energy, 1);
+            pattern[cluster] = 0;
+            splat(energy, cluster, -1.0f);
+
+            uint32_t hole = largestVoid(pattern, energy);
+            pattern[hole] = 1;
+            splat(energy, hole, 1.0f);
+
+            if (hole == cluster) break;
+        }
+
+        std::vector<uint32_t> ranks(n, 0);
+
+        // Phase 1: rank the initial points by removing the tightest clusters
+        {
+            std::vector<uint8_t> p = pattern;
+            std::vector<float> e = energy;
+            for (int32_t rank = static_cast<int32_t>(onesCount) - 1; rank >= 0; rank--) {
+                uint32_t cluster = tightestCluster(p, e, 1);
+                p[cluster] = 0;
+                splat(e, cluster, -1.0f);
+                ranks[cluster] = static_cast<uint32_t>(rank);
+            }
+        }
+
+        // Phase 2: fill the largest voids up to half of the pixels
+        uint32_t rank = onesCount;
+        for (; rank < n / 2; rank++) {
+            uint32_t hole = largestVoid(pattern, energy);
+            pattern[hole] = 1;
+            splat(energy, hole, 1.0f);
+            ranks[hole] = rank;
+        }
+
+        // Phase 3: the empty pixels are now the minority, fill their tightest clusters
+        std::vector<float> emptyEnergy(n, 0.0f);
+        for (uint32_t i = 0; i < n; i++) {
+            if (pattern[i] == 0) splat(emptyEnergy, i, 1.0f);
+        }
+        for (; rank < n; rank++) {
+            uint32_t cluster = tightestCluster(pattern, emptyEnergy, 0);
+            pattern[cluster] = 1;
+            splat(emptyEnergy, cluster, -1.0f);
+            ranks[cluster] = rank;
+        }
+
+        std::vector<float> result(n);
+        for (uint32_t i = 0; i < n; i++) {
+            result[i] = (static_cast<float>(ranks[i]) + 0.5f) / static_cast<float>(n);
+        }
+        return result;
+    }
+
+
+    std::vector<uint8_t> buildBuffer() {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        std::vector<float> blueNoiseX = generateBlueNoise(BLUE_NOISE_SIZE, 0x1234u);
+        std::vector<float> blueNoiseY = generateBlueNoise(BLUE_NOISE_SIZE, 0xabcdu);
+
+        std::vector<glm::vec2> blueNoise(blueNoiseX.size());
+        for (size_t i = 0; i < blueNoise.size(); i++) {
+            blueNoise[i] = glm::vec2(blueNoiseX[i], blueNoiseY[i]);
+        }
+
+        std::vector<uint8_t> buffer(blueNoise.size() * sizeof(glm::vec2));
+        memcpy(buffer.data(), blueNoise.data(), buffer.size());
+
+        auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        spdlog::info("Sampler tables generated ({}x{} blue noise) in {:.1f} ms",
+            BLUE_NOISE_SIZE, BLUE_NOISE_SIZE, elapsed);
+        return buffer;
+    }
+
+
+    const char* toString(SamplerType type) {
+        switch (type) {
+        case SamplerType::SobolOwen: return "Sobol (Owen)";
+        case SamplerType::R2:        return "R2";
+        case SamplerType::BlueNoise: return "Blue Noise";
+        }
+        return "unknown";
+    }
+}
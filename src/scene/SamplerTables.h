@@ -0,0 +1,27 @@
+#pragma once
+#include "stdafx.h"
+
+
+// Sample sequence used by the hit shaders (specialization constant, see shaders/common/sampling.glsl)
+enum class SamplerType : uint32_t {
+    SobolOwen = 0,  // Sobol (0,2)-sequence with hash-based Owen scrambling
+    R2 = 1,         // Roberts' R2 / R4 additive recurrence with per-pixel rotation
+    BlueNoise = 2   // Void-and-cluster blue noise tile, rotated per frame
+};
+
+
+// CPU-side generation of the lookup tables consumed by sampling.glsl
+namespace SamplerTables {
+
+    // Must match the constant in shaders/common/sampling.glsl (the Sobol direction numbers are
+    // constant data in the shader)
+    constexpr uint32_t BLUE_NOISE_SIZE = 64;
+
+    // Blue noise rank map in [0, 1) using Ulichney's void-and-cluster method (toroidal)
+    std::vector<float> generateBlueNoise(uint32_t size, uint32_t seed, float sigma = 1.5f);
+
+    // Packed SSBO contents: a 2-channel blue noise tile
+    std::vector<uint8_t> buildBuffer();
+
+    const char* toString(SamplerType type);
+}
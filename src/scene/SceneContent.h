@@ -23,6 +23,11 @@ public:
     // Build ImGui controls specific to this scene
     virtual void buildUI() {}
 
+    // Apply a named material preset (scripted rendering); false if the scene has no such preset
+    virtual bool setMaterialPreset(const std::string& name) { return false; }
+    // Names accepted by setMaterialPreset, empty if the scene has no presets
+    virtual std::vector<std::string> getMaterialPresets() const { return {}; }
+
 protected:
     std::shared_ptr<VulkanContext> _ctx;
     SceneGraph* _graph;
@@ -4,6 +4,8 @@
 #include "geometry/HostMesh.h"
 #include "geometry/MeshFactory.h"
 #include "geometry/ObjLoader.h"
+#include "utils/AliasTable.h"
+#include "utils/CpuProfiler.h"
 
 
 SceneGraph::SceneGraph(std::shared_ptr<VulkanContext> ctx)
@@ -13,68 +15,138 @@ SceneGraph::SceneGraph(std::shared_ptr<VulkanContext> ctx)
 }
 
 void SceneGraph::createGeometryTemplates() {
-    // Identity transform for geometry templates (actual transforms are in TLAS instances)
-    VkTransformMatrixKHR identityTransform = VulkanHelper::convertToVkTransform(glm::mat4(1.0f));
+    PROFILE_SCOPE("SceneGraph::createGeometryTemplates");
 
     // Plane (or large quad)
     HostMesh planeMesh = MeshFactory::createQuadMesh(1000.0f, 1000.0f, glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.0f), true);
-    _geometryTemplates["plane"].dmesh = std::make_unique<DeviceMesh>(_ctx, planeMesh, identityTransform);
-    _geometryTemplates["plane"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["plane"].dmesh);
+    addGeometryTemplate("plane", planeMesh);
 
     // Sphere
     HostMesh sphereMesh = MeshFactory::createSphereMesh(0.5f, 64, 32);
-    _geometryTemplates["sphere"].dmesh = std::make_unique<DeviceMesh>(_ctx, sphereMesh, identityTransform);
-    _geometryTemplates["sphere"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["sphere"].dmesh);
+    addGeometryTemplate("sphere", sphereMesh);
 
     // Box
     HostMesh boxMesh = MeshFactory::createBoxMesh(1.0f, 1.0f, 1.0f);
-    _geometryTemplates["box"].dmesh = std::make_unique<DeviceMesh>(_ctx, boxMesh, identityTransform);
-    _geometryTemplates["box"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["box"].dmesh);
+    addGeometryTemplate("box", boxMesh);
 
     // Pyramid
     HostMesh pyramidMesh = MeshFactory::createPyramidMesh(1.0f, 1.0f, 1.0f);
-    _geometryTemplates["pyramid"].dmesh = std::make_unique<DeviceMesh>(_ctx, pyramidMesh, identityTransform);
-    _geometryTemplates["pyramid"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["pyramid"].dmesh);
+    addGeometryTemplate("pyramid", pyramidMesh);
 
     // Doughnut
     HostMesh doughnutMesh = MeshFactory::createDoughnutMesh(0.35f, 0.5f, 64, 32);
-    _geometryTemplates["doughnut"].dmesh = std::make_unique<DeviceMesh>(_ctx, doughnutMesh, identityTransform);
-    _geometryTemplates["doughnut"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["doughnut"].dmesh);
+    addGeometryTemplate("doughnut", doughnutMesh);
 
     // Cone
     HostMesh coneMesh = MeshFactory::createConeMesh(0.5f, 1.0f, 32, true);
-    _geometryTemplates["cone"].dmesh = std::make_unique<DeviceMesh>(_ctx, coneMesh, identityTransform);
-    _geometryTemplates["cone"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["cone"].dmesh);
+    addGeometryTemplate("cone", coneMesh);
 
     // Cylinder
     HostMesh cylinderMesh = MeshFactory::createCylinderMesh(0.5f, 1.f, 32, true);
-    _geometryTemplates["cylinder"].dmesh = std::make_unique<DeviceMesh>(_ctx, cylinderMesh, identityTransform);
-    _geometryTemplates["cylinder"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["cylinder"].dmesh);
+    addGeometryTemplate("cylinder", cylinderMesh);
 
     // Extruded Hexagon
     HostMesh extrudedHexagonMesh = MeshFactory::createPrismMesh(0.7f, 0.2f, 6, true);
-    _geometryTemplates["extruded_hexagon"].dmesh = std::make_unique<DeviceMesh>(_ctx, extrudedHexagonMesh, identityTransform);
-    _geometryTemplates["extruded_hexagon"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["extruded_hexagon"].dmesh);
+    addGeometryTemplate("extruded_hexagon", extrudedHexagonMesh);
 
     // Icosahedron
     HostMesh icosahedronMesh = MeshFactory::createIcosahedronMesh(0.5f);
-    _geometryTemplates["icosahedron"].dmesh = std::make_unique<DeviceMesh>(_ctx, icosahedronMesh, identityTransform);
-    _geometryTemplates["icosahedron"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["icosahedron"].dmesh);
+    addGeometryTemplate("icosahedron", icosahedronMesh);
 
     // Rhombus
     HostMesh rhombusMesh = MeshFactory::createRhombusMesh(0.7f, 1.0f);
-    _geometryTemplates["rhombus"].dmesh = std::make_unique<DeviceMesh>(_ctx, rhombusMesh, identityTransform);
-    _geometryTemplates["rhombus"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["rhombus"].dmesh);
+    addGeometryTemplate("rhombus", rhombusMesh);
 
     // Teapot
     HostMesh teapotMesh = ObjLoader::load(AssetPath::getInstance()->get("mesh/teapot.obj"));
-    _geometryTemplates["teapot"].dmesh = std::make_unique<DeviceMesh>(_ctx, teapotMesh, identityTransform);
-    _geometryTemplates["teapot"].blas = std::make_unique<BLAS>(_ctx, *_geometryTemplates["teapot"].dmesh);
+    addGeometryTemplate("teapot", teapotMesh);
 
     // Put more geometry templates here as needed
 }
 
+void SceneGraph::addGeometryTemplate(const std::string& name, const HostMesh& mesh) {
+    GeometryTemplate& geom = _geometryTemplates[name];
+    geom.hmesh = mesh;
+    makeResident(geom);
+}
+
+void SceneGraph::makeResident(GeometryTemplate& geom) {
+    // Identity transform for geometry templates (actual transforms are in TLAS instances)
+    VkTransformMatrixKHR identityTransform = VulkanHelper::convertToVkTransform(glm::mat4(1.0f));
+
+    geom.dmesh = std::make_unique<DeviceMesh>(_ctx, geom.hmesh, identityTransform);
+    geom.blas = std::make_unique<BLAS>(_ctx, *geom.dmesh);
+}
+
+void SceneGraph::addObject(const SceneObject& obj) {
+    GeometryTemplate& geom = _geometryTemplates.at(obj.geometryType);
+    if (!geom.isResident()) {
+        PROFILE_SCOPE("SceneGraph::makeResident");
+        makeResident(geom);
+        spdlog::info("Geometry template '{}' uploaded again after eviction", obj.geometryType);
+    }
+    geom.lastUsed = ++_useClock;
+
+    _sceneObjects.push_back(obj);
+    _instanceDataDirty = true;
+}
+
+SceneGraph::GeometryResidency SceneGraph::getGeometryResidency() const {
+    GeometryResidency residency;
+    for (const auto& [name, geom] : _geometryTemplates) {
+        residency.templateCount++;
+        if (!geom.isResident()) continue;
+        residency.residentCount++;
+        residency.residentBytes += geom.getMemorySize();
+    }
+    return residency;
+}
+
+void SceneGraph::markGeometryInUse(uint64_t frameValue) {
+    for (const auto& obj : _sceneObjects) {
+        _geometryTemplates.at(obj.geometryType).lastFrameValue = frameValue;
+    }
+}
+
+uint32_t SceneGraph::evictGeometry(VkDeviceSize budgetBytes) {
+    PROFILE_SCOPE("SceneGraph::evictGeometry");
+    VkDeviceSize residentBytes = getGeometryResidency().residentBytes;
+    if (residentBytes <= budgetBytes) return 0;
+
+    std::set<std::string> referenced;
+    for (const auto& obj : _sceneObjects) referenced.insert(obj.geometryType);
+
+    // Oldest first
+    std::vector<std::pair<uint64_t, GeometryTemplate*>> candidates;
+    for (auto& [name, geom] : _geometryTemplates) {
+        if (geom.isResident() && referenced.count(name) == 0) candidates.push_back({ geom.lastUsed, &geom });
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    uint32_t evicted = 0;
+    for (auto& [lastUsed, geom] : candidates) {
+        if (residentBytes <= budgetBytes) break;
+        residentBytes -= geom->getMemorySize();
+        _retiredGeometry.push_back({ std::move(geom->dmesh), std::move(geom->blas), geom->lastFrameValue });
+        evicted++;
+    }
+
+    if (residentBytes > budgetBytes) {
+        spdlog::warn("Geometry in use ({} MiB) exceeds the budget of {} MiB", residentBytes >> 20, budgetBytes >> 20);
+    }
+    spdlog::info("Evicted {} geometry templates, {} MiB resident", evicted, residentBytes >> 20);
+    return evicted;
+}
+
+void SceneGraph::releaseRetiredGeometry(uint64_t completedFrameValue) {
+    _retiredGeometry.erase(
+        std::remove_if(_retiredGeometry.begin(), _retiredGeometry.end(),
+            [completedFrameValue](const RetiredGeometry& retired) { return retired.frameValue <= completedFrameValue; }),
+        _retiredGeometry.end());
+}
+
 std::vector<VkAccelerationStructureInstanceKHR> SceneGraph::buildInstanceList() const {
+    PROFILE_SCOPE("SceneGraph::buildInstanceList");
     std::vector<VkAccelerationStructureInstanceKHR> instances;
     instances.reserve(_sceneObjects.size());
 
@@ -86,7 +158,7 @@ std::vector<VkAccelerationStructureInstanceKHR> SceneGraph::buildInstanceList()
         instance.transform = VulkanHelper::convertToVkTransform(obj.transform);
         instance.instanceCustomIndex = static_cast<uint32_t>(i);
         instance.mask = 0xFF;
-        instance.instanceShaderBindingTableRecordOffset = 0;
+        instance.instanceShaderBindingTableRecordOffset = static_cast<uint32_t>(getHitGroup(obj));
         instance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
         instance.accelerationStructureReference = geom.blas->getDeviceAddress();
 
@@ -96,6 +168,13 @@ std::vector<VkAccelerationStructureInstanceKHR> SceneGraph::buildInstanceList()
     return instances;
 }
 
+HitGroup SceneGraph::getHitGroup(const SceneObject& obj) {
+    if (obj.materialType == 1)   return HitGroup::Emissive;
+    if (obj.materialType == 999) return HitGroup::Checker;
+    if (obj.transparency > 0.0f) return HitGroup::Dielectric;
+    return HitGroup::PBR;
+}
+
 std::vector<InstanceData> SceneGraph::buildInstanceDataArray() const {
     std::vector<InstanceData> result;
     result.reserve(_sceneObjects.size());
@@ -114,9 +193,49 @@ std::vector<InstanceData> SceneGraph::buildInstanceDataArray() const {
         instanceData.transparency = obj.transparency;
         instanceData.ior = obj.ior;
         instanceData.absorbance = obj.absorbance;
+        instanceData.emissionStrength = obj.emissionStrength;
 
         result.push_back(instanceData);
     }
 
     return result;
 }
+
+std::vector<EmissiveTriangle> SceneGraph::buildEmissiveTriangleArray() const {
+    std::vector<EmissiveTriangle> result;
+    std::vector<float> powers;
+
+    for (const auto& obj : _sceneObjects) {
+        if (getHitGroup(obj) != HitGroup::Emissive) continue;
+
+        const HostMesh& mesh = _geometryTemplates.at(obj.geometryType).hmesh;
+        const glm::vec3 emission = obj.color * obj.emissionStrength;
+        const float luminance = glm::dot(emission, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            EmissiveTriangle tri{};
+            tri.p0 = glm::vec3(obj.transform * glm::vec4(mesh.vertices[mesh.indices[i + 0]].pos, 1.0f));
+            tri.p1 = glm::vec3(obj.transform * glm::vec4(mesh.vertices[mesh.indices[i + 1]].pos, 1.0f));
+            tri.p2 = glm::vec3(obj.transform * glm::vec4(mesh.vertices[mesh.indices[i + 2]].pos, 1.0f));
+            tri.emission = emission;
+            tri.area = 0.5f * glm::length(glm::cross(tri.p1 - tri.p0, tri.p2 - tri.p0));
+
+            // Emitted power of a lambertian emitter: L * A * pi
+            const float power = luminance * tri.area * glm::pi<float>();
+            if (power <= 0.0f) continue;
+
+            result.push_back(tri);
+            powers.push_back(power);
+        }
+    }
+
+    if (result.empty()) return result;
+
+    AliasTable aliasTable(powers);
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i].pdf = aliasTable.getPdf(i);
+        result[i].aliasProbability = aliasTable.getProbability(i);
+        result[i].alias = aliasTable.getAlias(i);
+    }
+    return result;
+}
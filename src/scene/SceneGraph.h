@@ -4,13 +4,31 @@
 #include "vulkan/resources/BLAS.h"
 #include "geometry/DeviceMesh.h"
 #include "vulkan/InstanceData.h"
+#include "vulkan/LightData.h"
+#include "geometry/HostMesh.h"
+
+
+// Hit groups in shader binding table order, picked per instance through the SBT record offset
+enum class HitGroup : uint32_t {
+    Emissive = 0,
+    PBR = 1,
+    Dielectric = 2,
+    Checker = 3,
+    Count
+};
 
 
 class SceneGraph {
 public:
     struct GeometryTemplate {
-        std::unique_ptr<DeviceMesh> dmesh;
+        HostMesh hmesh;                     // Kept on CPU to build the emissive light list and to upload it again after eviction
+        std::unique_ptr<DeviceMesh> dmesh;  // Null while evicted (blas too)
         std::unique_ptr<BLAS> blas;
+        uint64_t lastUsed = 0;              // Use clock of the last addObject with this template
+        uint64_t lastFrameValue = 0;        // Frame timeline value of the last frame that referenced it
+
+        bool isResident() const { return dmesh != nullptr; }
+        VkDeviceSize getMemorySize() const { return isResident() ? dmesh->getMemorySize() + blas->getMemorySize() : 0; }
     };
 
     struct SceneObject {
@@ -23,13 +41,15 @@ public:
         float transparency = 0.0f;   // 0 = opaque, 1 = fully transparent
         float ior = 1.5f;            // Index of refraction (1.5 for glass)
         glm::vec3 absorbance;
+        float emissionStrength = 1.0f; // Radiance scale for emissive materials
     };
 
     SceneGraph(std::shared_ptr<VulkanContext> ctx);
 
     // Scene object management — called by SceneContent subclasses
     const std::vector<SceneObject>& getObjects() const { return _sceneObjects; }
-    void addObject(const SceneObject& obj) { _sceneObjects.push_back(obj); _instanceDataDirty = true; }
+    // Uploads the geometry template again if it was evicted
+    void addObject(const SceneObject& obj);
     void clearObjects() { _sceneObjects.clear(); _instanceDataDirty = true; }
 
     // True when objects changed and the GPU instance data buffer must be re-uploaded
@@ -38,12 +58,45 @@ public:
     std::vector<VkAccelerationStructureInstanceKHR> buildInstanceList() const;
     std::vector<InstanceData> buildInstanceDataArray() const;
 
+    // World space triangles of all emissive objects with an alias table over their power
+    std::vector<EmissiveTriangle> buildEmissiveTriangleArray() const;
+
+    struct GeometryResidency {
+        uint32_t templateCount = 0;
+        uint32_t residentCount = 0;
+        VkDeviceSize residentBytes = 0;   // Meshes and BLASes of the resident templates
+    };
+    GeometryResidency getGeometryResidency() const;
+
+    // Tags the templates the current objects use as referenced by the frame signaling frameValue
+    void markGeometryInUse(uint64_t frameValue);
+
+    // Evicts the least recently used templates no object references until the resident ones fit
+    // in budgetBytes (templates in use are never evicted). Their meshes and BLASes are freed by
+    // releaseRetiredGeometry once the last frame that referenced them has finished, so frames in
+    // flight keep tracing. Returns the number of templates evicted.
+    uint32_t evictGeometry(VkDeviceSize budgetBytes);
+    void releaseRetiredGeometry(uint64_t completedFrameValue);
+
+    // Hit group used to shade an object (derived from its material)
+    static HitGroup getHitGroup(const SceneObject& obj);
+
 private:
     bool _instanceDataDirty = false;
     std::shared_ptr<VulkanContext> _ctx;
 
     std::unordered_map<std::string, GeometryTemplate> _geometryTemplates;
     std::vector<SceneObject> _sceneObjects;
+    uint64_t _useClock = 0;
+
+    struct RetiredGeometry {
+        std::unique_ptr<DeviceMesh> dmesh;
+        std::unique_ptr<BLAS> blas;
+        uint64_t frameValue;                // Freed once this frame has finished
+    };
+    std::vector<RetiredGeometry> _retiredGeometry;
 
     void createGeometryTemplates();
+    void addGeometryTemplate(const std::string& name, const HostMesh& mesh);
+    void makeResident(GeometryTemplate& geom);
 };
@@ -0,0 +1,108 @@
+#include "scene/TemporalReprojection.h"
+#include "core/AssetPath.h"
+
+
+TemporalReprojection::TemporalReprojection(std::shared_ptr<VulkanContext> ctx, uint32_t maxWidth, uint32_t maxHeight, VkFormat colorFormat)
+    : _ctx(std::move(ctx))
+{
+    _gBuffer        = std::make_unique<StorageImage>(_ctx, maxWidth, maxHeight, VK_FORMAT_R32G32_SFLOAT);
+    _historyGBuffer = std::make_unique<StorageImage>(_ctx, maxWidth, maxHeight, VK_FORMAT_R32G32_SFLOAT, VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    _historyColor   = std::make_unique<StorageImage>(_ctx, maxWidth, maxHeight, colorFormat, VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+    _resolvedColor  = std::make_unique<StorageImage>(_ctx, maxWidth, maxHeight, colorFormat);
+    spdlog::info("Temporal reprojection images created ({}x{}).", maxWidth, maxHeight);
+}
+
+
+void TemporalReprojection::createDescriptorSets(const StorageImage& currentColor,
+    const std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT>& uniformBuffers)
+{
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        std::vector<Descriptor> descriptors = {
+            Descriptor(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, currentColor.getDescriptorInfo()),
+            Descriptor(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, _gBuffer->getDescriptorInfo()),
+            Descriptor(2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, _historyColor->getDescriptorInfo()),
+            Descriptor(3, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, _historyGBuffer->getDescriptorInfo()),
+            Descriptor(4, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, _resolvedColor->getDescriptorInfo()),
+            Descriptor(5, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, 1, uniformBuffers[i]->getDescriptorInfo())
+        };
+        _descriptorSets[i] = std::make_unique<DescriptorSet>(_ctx, descriptors);
+    }
+
+    // Layout never changes, so the pipeline is only built once
+    if (!_pipeline) {
+        ComputePipelineParams params{};
+        params.descriptorSetLayouts = { _descriptorSets[0]->getDescriptorSetLayout() };
+        params.pushConstantSize = sizeof(PushConstants);
+        params.name = "TemporalReprojection";
+        _pipeline = std::make_unique<ComputePipeline>(_ctx, AssetPath::getInstance()->get("spv/reproject_comp.spv"), params);
+    }
+
+    _historyValid = false;
+}
+
+
+void TemporalReprojection::recordToCommandBuffer(VkCommandBuffer commandBuffer, uint32_t currentFrame, VkExtent2D extent,
+    const glm::mat4& prevViewProj, const glm::vec3& prevCamPosition, const std::vector<VkRect2D>& regions)
+{
+    // Trace output (color + G-buffer) -> reprojection reads
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    PushConstants pushConstants{};
+    pushConstants.prevViewProj = prevViewProj;
+    pushConstants.prevCamPosition = glm::vec4(prevCamPosition, 1.0f);
+    pushConstants.extent = { extent.width, extent.height };
+    pushConstants.prevExtent = { _historyExtent.width, _historyExtent.height };
+    pushConstants.alpha = alpha;
+    pushConstants.depthTolerance = depthTolerance;
+    pushConstants.historyValid = _historyValid ? 1u : 0u;
+    pushConstants.accumulate = accumulate ? 1u : 0u;
+
+    VkDescriptorSet descriptorSet = _descriptorSets[currentFrame]->getDescriptorSet();
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline->getPipeline());
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        _pipeline->getPipelineLayout(), 0, 1, &descriptorSet, 0, nullptr);
+
+    const std::vector<VkRect2D> fullFrame = { VkRect2D{ { 0, 0 }, extent } };
+    for (const VkRect2D& rect : regions.empty() ? fullFrame : regions) {
+        pushConstants.region = { static_cast<uint32_t>(rect.offset.x), static_cast<uint32_t>(rect.offset.y), rect.extent.width, rect.extent.height };
+        vkCmdPushConstants(commandBuffer, _pipeline->getPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT,
+            0, sizeof(PushConstants), &pushConstants);
+        vkCmdDispatch(commandBuffer, (rect.extent.width + 7) / 8, (rect.extent.height + 7) / 8, 1);
+    }
+
+    // Reprojection done -> overwrite history with this frame
+    barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    VkImageCopy region{};
+    region.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.extent = { extent.width, extent.height, 1 };
+    vkCmdCopyImage(commandBuffer,
+        _resolvedColor->getImage(), VK_IMAGE_LAYOUT_GENERAL,
+        _historyColor->getImage(), VK_IMAGE_LAYOUT_GENERAL,
+        1, &region);
+    vkCmdCopyImage(commandBuffer,
+        _gBuffer->getImage(), VK_IMAGE_LAYOUT_GENERAL,
+        _historyGBuffer->getImage(), VK_IMAGE_LAYOUT_GENERAL,
+        1, &region);
+
+    // History copies -> next frame's reprojection
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    _historyExtent = extent;
+    _historyValid = true;
+}
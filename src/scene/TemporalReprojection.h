@@ -0,0 +1,67 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/VulkanContext.h"
+#include "vulkan/ComputePipeline.h"
+#include "vulkan/DescriptorSet.h"
+#include "vulkan/resources/Buffer.h"
+#include "vulkan/resources/StorageImage.h"
+
+
+// Reuses the previous frame's result: the raygen shader writes primary hit distance + instance id
+// into a G-buffer, a compute pass reprojects the history into the current view, rejects it on
+// disocclusion and blends it with the newly traced frame.
+class TemporalReprojection
+{
+public:
+    // Must match the push constant block in reproject.comp
+    struct PushConstants {
+        glm::mat4 prevViewProj;
+        glm::vec4 prevCamPosition;
+        glm::uvec2 extent;
+        glm::uvec2 prevExtent;
+        float alpha;
+        float depthTolerance;
+        uint32_t historyValid;
+        uint32_t accumulate;
+        glm::uvec4 region;
+    };
+
+    // Images are allocated at the renderer's trace allocation, each frame uses a top-left sub-rectangle
+    TemporalReprojection(std::shared_ptr<VulkanContext> ctx, uint32_t maxWidth, uint32_t maxHeight, VkFormat colorFormat);
+    ~TemporalReprojection() = default;
+
+    void createDescriptorSets(const StorageImage& currentColor,
+        const std::array<std::unique_ptr<Buffer>, MAX_FRAMES_IN_FLIGHT>& uniformBuffers);
+
+    // Records reprojection + history update, expects the trace pass to be recorded right before.
+    // Only the given regions are blended (all of extent if empty), the rest of the resolved image
+    // keeps its previous result so tiles that were not traced this frame are not blended again.
+    void recordToCommandBuffer(VkCommandBuffer commandBuffer, uint32_t currentFrame, VkExtent2D extent,
+        const glm::mat4& prevViewProj, const glm::vec3& prevCamPosition, const std::vector<VkRect2D>& regions = {});
+
+    // Drop the history (camera cut, scene switch, toggled on)
+    void resetHistory() { _historyValid = false; }
+
+    const StorageImage& getGBuffer() const { return *_gBuffer; }
+    const StorageImage& getResolvedImage() const { return *_resolvedColor; }
+    VkImage getOutputImage() const { return _resolvedColor->getImage(); }
+
+    float alpha = 0.1f;           // Weight of the current frame (lower = more history)
+    float depthTolerance = 0.05f; // Relative hit distance mismatch before history is rejected
+    bool accumulate = false;      // Static camera: blend with the same pixel's history, no clamp or rejection
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+
+    std::unique_ptr<StorageImage> _gBuffer;
+    std::unique_ptr<StorageImage> _historyColor;
+    std::unique_ptr<StorageImage> _historyGBuffer;
+    std::unique_ptr<StorageImage> _resolvedColor;
+
+    std::array<std::unique_ptr<DescriptorSet>, MAX_FRAMES_IN_FLIGHT> _descriptorSets;
+    std::unique_ptr<ComputePipeline> _pipeline;
+
+    VkExtent2D _historyExtent{};
+    bool _historyValid = false;
+};
@@ -0,0 +1,118 @@
+#include "scene/TiledDispatch.h"
+
+
+TiledDispatch::TiledDispatch(const TiledDispatchParams& params)
+    : _params(params)
+{
+    _params.tileSize = std::max(_params.tileSize, 8u);
+}
+
+void TiledDispatch::update(float traceTimeMs, uint64_t pixelCount) {
+    if (traceTimeMs <= 0.0f || pixelCount == 0) return;
+
+    float msPerPixel = traceTimeMs / static_cast<float>(pixelCount);
+    if (_msPerPixel <= 0.0f) _msPerPixel = msPerPixel;
+    else _msPerPixel = glm::mix(_msPerPixel, msPerPixel, _params.smoothing);
+}
+
+std::vector<VkRect2D> TiledDispatch::nextTiles(VkExtent2D extent) {
+    if (!_enabled) {
+        _lastTileCount = 1;
+        return { VkRect2D{ { 0, 0 }, extent } };
+    }
+
+    if (extent.width != _extent.width || extent.height != _extent.height || _tiles.empty()) {
+        buildTiles(extent);
+    }
+
+    // Pixels that fit into the budget at the measured cost. Until the first measurement arrives
+    // only one tile is traced, growth is capped so a stale estimate cannot blow the budget.
+    uint64_t pixelBudget = 0;
+    if (_msPerPixel > 0.0f) {
+        pixelBudget = static_cast<uint64_t>(_params.budgetMs / _msPerPixel);
+        if (_lastPixelCount > 0) {
+            pixelBudget = std::min(pixelBudget, static_cast<uint64_t>(_lastPixelCount * _params.maxGrowth));
+        }
+    }
+
+    std::vector<VkRect2D> tiles;
+    uint64_t pixels = 0;
+    do {
+        const VkRect2D& tile = _tiles[_nextTile];
+        tiles.push_back(tile);
+        pixels += static_cast<uint64_t>(tile.extent.width) * tile.extent.height;
+
+        if (++_nextTile == _tiles.size()) {
+            _nextTile = 0;
+            _completedPasses++;
+        }
+    } while (tiles.size() < _tiles.size() && pixels + static_cast<uint64_t>(_tiles[_nextTile].extent.width) * _tiles[_nextTile].extent.height <= pixelBudget);
+
+    _lastTileCount = static_cast<uint32_t>(tiles.size());
+    _lastPixelCount = pixels;
+    return tiles;
+}
+
+void TiledDispatch::setEnabled(bool enabled) {
+    _enabled = enabled;
+    _tiles.clear();
+    _lastPixelCount = 0;
+}
+
+void TiledDispatch::setTileSize(uint32_t size) {
+    _params.tileSize = std::max(size, 8u);
+    _tiles.clear();
+}
+
+void TiledDispatch::setOrder(TileOrder order) {
+    _params.order = order;
+    _tiles.clear();
+}
+
+float TiledDispatch::getProgress() const {
+    if (_tiles.empty()) return 0.0f;
+    return static_cast<float>(_nextTile) / static_cast<float>(_tiles.size());
+}
+
+const char* TiledDispatch::toString(TileOrder order) {
+    switch (order) {
+        case TileOrder::Scanline:  return "Scanline";
+        case TileOrder::CenterOut: return "Center Out";
+        case TileOrder::Random:    return "Random";
+    }
+    return "Unknown";
+}
+
+void TiledDispatch::buildTiles(VkExtent2D extent) {
+    _extent = extent;
+    _tiles.clear();
+    _nextTile = 0;
+
+    const uint32_t size = _params.tileSize;
+    for (uint32_t y = 0; y < extent.height; y += size) {
+        for (uint32_t x = 0; x < extent.width; x += size) {
+            VkRect2D tile{};
+            tile.offset = { static_cast<int32_t>(x), static_cast<int32_t>(y) };
+            tile.extent = { std::min(size, extent.width - x), std::min(size, extent.height - y) };
+            _tiles.push_back(tile);
+        }
+    }
+
+    if (_params.order == TileOrder::CenterOut) {
+        const glm::vec2 center = glm::vec2(extent.width, extent.height) * 0.5f;
+        auto distance = [&center](const VkRect2D& tile) {
+            glm::vec2 tileCenter = glm::vec2(tile.offset.x, tile.offset.y) + glm::vec2(tile.extent.width, tile.extent.height) * 0.5f;
+            return glm::dot(tileCenter - center, tileCenter - center);
+        };
+        std::stable_sort(_tiles.begin(), _tiles.end(), [&distance](const VkRect2D& a, const VkRect2D& b) {
+            return distance(a) < distance(b);
+        });
+    } else if (_params.order == TileOrder::Random) {
+        // Fixed seed, the same extent always refines in the same order
+        std::mt19937 rng(1337u);
+        std::shuffle(_tiles.begin(), _tiles.end(), rng);
+    }
+
+    spdlog::debug("Tiled dispatch: {}x{} split into {} tiles of {}px ({})",
+        extent.width, extent.height, _tiles.size(), size, toString(_params.order));
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "stdafx.h"
+
+
+enum class TileOrder : int
+{
+    Scanline = 0,   // Rows top to bottom
+    CenterOut = 1,  // Closest to the image center first
+    Random = 2      // Fixed shuffle, spreads the refinement over the whole image
+};
+
+struct TiledDispatchParams
+{
+    uint32_t tileSize = 256;            // Tile edge in pixels (edge tiles are clipped)
+    float budgetMs = 8.0f;              // GPU trace time per frame
+    TileOrder order = TileOrder::CenterOut;
+
+    float smoothing = 0.2f;             // Exponential moving average weight of new cost samples
+    float maxGrowth = 2.0f;             // Max factor the traced pixel count may grow per frame
+};
+
+
+// Splits the trace extent into tiles and hands out as many per frame as fit into a GPU time
+// budget, continuing where the previous frame stopped. Untraced tiles keep their last result,
+// so a heavy frame is refined over several submits instead of stalling one.
+// Cost is assumed to be proportional to the traced pixel count.
+class TiledDispatch
+{
+public:
+    explicit TiledDispatch(const TiledDispatchParams& params = TiledDispatchParams());
+
+    // Feed the measured trace time of a frame that traced pixelCount pixels
+    void update(float traceTimeMs, uint64_t pixelCount);
+
+    // Tiles to trace this frame. Returns the whole extent as a single tile while disabled.
+    std::vector<VkRect2D> nextTiles(VkExtent2D extent);
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    void setTileSize(uint32_t size);
+    uint32_t getTileSize() const { return _params.tileSize; }
+    void setOrder(TileOrder order);
+    TileOrder getOrder() const { return _params.order; }
+    void setBudget(float ms) { _params.budgetMs = std::max(ms, 0.1f); }
+    float getBudget() const { return _params.budgetMs; }
+
+    // Fraction of the current pass over the image that has been traced
+    float getProgress() const;
+    uint32_t getCompletedPasses() const { return _completedPasses; }
+    uint32_t getTileCount() const { return static_cast<uint32_t>(_tiles.size()); }
+    uint32_t getLastTileCount() const { return _lastTileCount; }
+    float getSmoothedTimePerMegapixel() const { return _msPerPixel * 1e6f; }
+
+    static const char* toString(TileOrder order);
+
+private:
+    TiledDispatchParams _params;
+    bool _enabled = false;
+
+    std::vector<VkRect2D> _tiles;       // In trace order
+    VkExtent2D _extent{};
+    size_t _nextTile = 0;
+    uint32_t _completedPasses = 0;
+    uint32_t _lastTileCount = 0;
+    uint64_t _lastPixelCount = 0;
+
+    float _msPerPixel = 0.0f;
+
+    void buildTiles(VkExtent2D extent);
+};
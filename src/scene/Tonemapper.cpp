@@ -0,0 +1,165 @@
+#include "scene/Tonemapper.h"
+#include "core/AssetPath.h"
+
+
+Tonemapper::Tonemapper(std::shared_ptr<VulkanContext> ctx, const RenderTarget& target)
+    : _ctx(std::move(ctx)), _extent(target.getExtent()),
+      _targetImages(target.getImages()), _targetViews(target.getStorageViews())
+{
+    // sRGB formats can't be storage images, the shader encodes and the bytes are copied as is
+    if (_targetViews.empty()) {
+        _displayImage = std::make_unique<StorageImage>(_ctx, _extent.width, _extent.height,
+            VulkanHelper::convertToUnormFormat(target.getFormat()));
+        _outputImage = _displayImage->getImage();
+    }
+    spdlog::info("Tonemapper writes {} ({}x{}).", writesTargetDirectly() ? "target images" : "display image", _extent.width, _extent.height);
+}
+
+Tonemapper::~Tonemapper()
+{
+    // Sets go back to the pool before it is destroyed
+    _descriptorSets.clear();
+    if (_descriptorPool) vkDestroyDescriptorPool(_ctx->device, _descriptorPool, nullptr);
+}
+
+
+void Tonemapper::createDescriptorPool(uint32_t setCount)
+{
+    // Old sets are released before the pool is replaced, so no contingency is needed here
+    if (_descriptorPool) vkDestroyDescriptorPool(_ctx->device, _descriptorPool, nullptr);
+
+    VkDescriptorPoolSize poolSize = { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, setCount * 2 };  // Source + output per set
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = setCount;
+    if (vkCreateDescriptorPool(_ctx->device, &poolInfo, nullptr, &_descriptorPool) != VK_SUCCESS) {
+        spdlog::error("Failed to create tonemapper descriptor pool!");
+        throw std::runtime_error("Failed to create tonemapper descriptor pool!");
+    }
+}
+
+
+void Tonemapper::createDescriptorSets(const std::vector<const StorageImage*>& sources)
+{
+    std::vector<VkDescriptorImageInfo> outputs;
+    if (writesTargetDirectly()) {
+        for (VkImageView view : _targetViews) outputs.push_back({ VK_NULL_HANDLE, view, VK_IMAGE_LAYOUT_GENERAL });
+    } else {
+        outputs.push_back(_displayImage->getDescriptorInfo());
+    }
+
+    _sources = sources;
+    _descriptorSets.clear();
+    createDescriptorPool(static_cast<uint32_t>(_sources.size() * outputs.size()));
+    for (const StorageImage* source : _sources) {
+        auto& sets = _descriptorSets.emplace_back();
+        for (const VkDescriptorImageInfo& output : outputs) {
+            std::vector<Descriptor> descriptors = {
+                Descriptor(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, source->getDescriptorInfo()),
+                Descriptor(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1, output)
+            };
+            sets.push_back(std::make_unique<DescriptorSet>(_ctx, descriptors, _descriptorPool));
+        }
+    }
+
+    // Layout never changes, so the pipeline is only built once
+    if (!_pipeline) {
+        ComputePipelineParams params{};
+        params.descriptorSetLayouts = { _descriptorSets[0][0]->getDescriptorSetLayout() };
+        params.pushConstantSize = sizeof(PushConstants);
+        params.name = "Tonemapper";
+        _pipeline = std::make_unique<ComputePipeline>(_ctx, AssetPath::getInstance()->get("spv/tonemap_comp.spv"), params);
+    }
+}
+
+
+void Tonemapper::recordToCommandBuffer(VkCommandBuffer commandBuffer, const StorageImage& source, VkExtent2D sourceExtent, uint32_t imageIndex)
+{
+    auto it = std::find(_sources.begin(), _sources.end(), &source);
+    if (it == _sources.end()) {
+        spdlog::error("Tonemapper source has no descriptor set!");
+        throw std::runtime_error("Tonemapper source has no descriptor set!");
+    }
+    const size_t sourceIndex = static_cast<size_t>(it - _sources.begin());
+    const VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+    // HDR passes -> resolve reads (also orders the display image after last frame's copy)
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    // The previous contents of a swapchain image are never needed
+    if (writesTargetDirectly()) {
+        _outputImage = _targetImages[imageIndex];
+        VulkanHelper::transitionImageLayout(_ctx, commandBuffer, _outputImage, range,
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    PushConstants pushConstants{};
+    pushConstants.srcExtent = { sourceExtent.width, sourceExtent.height };
+    pushConstants.dstExtent = { _extent.width, _extent.height };
+    pushConstants.exposure = std::exp2(exposure);
+    pushConstants.tonemapper = static_cast<uint32_t>(tonemapOperator);
+    pushConstants.filter = static_cast<uint32_t>(filter);
+
+    VkDescriptorSet descriptorSet = _descriptorSets[sourceIndex][writesTargetDirectly() ? imageIndex : 0]->getDescriptorSet();
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline->getPipeline());
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        _pipeline->getPipelineLayout(), 0, 1, &descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, _pipeline->getPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(PushConstants), &pushConstants);
+    vkCmdDispatch(commandBuffer, (_extent.width + 7) / 8, (_extent.height + 7) / 8, 1);
+
+    // Without storage views the target image gets a raw copy of the display image (same texel size)
+    if (!writesTargetDirectly() && imageIndex < _targetImages.size()) {
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+        VkImage targetImage = _targetImages[imageIndex];
+        VulkanHelper::transitionImageLayout(_ctx, commandBuffer, targetImage, range,
+            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        VkImageCopy region{};
+        region.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        region.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        region.extent = { _extent.width, _extent.height, 1 };
+        vkCmdCopyImage(commandBuffer,
+            _displayImage->getImage(), VK_IMAGE_LAYOUT_GENERAL,
+            targetImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &region);
+
+        VulkanHelper::transitionImageLayout(_ctx, commandBuffer, targetImage, range,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+    }
+}
+
+
+const char* Tonemapper::toString(TonemapOperator op) {
+    switch (op) {
+        case TonemapOperator::Clamp:    return "Clamp";
+        case TonemapOperator::Reinhard: return "Reinhard";
+        case TonemapOperator::Aces:     return "ACES";
+        default:                        return "Unknown";
+    }
+}
+
+const char* Tonemapper::toString(ReconstructionFilter filter) {
+    switch (filter) {
+        case ReconstructionFilter::Box:      return "Box";
+        case ReconstructionFilter::Gaussian: return "Gaussian";
+        case ReconstructionFilter::Mitchell: return "Mitchell";
+        default:                             return "Unknown";
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/VulkanContext.h"
+#include "vulkan/ComputePipeline.h"
+#include "vulkan/DescriptorSet.h"
+#include "vulkan/RenderTarget.h"
+#include "vulkan/resources/StorageImage.h"
+
+
+enum class TonemapOperator : uint32_t {
+    Clamp = 0,
+    Reinhard = 1,
+    Aces = 2
+};
+
+enum class ReconstructionFilter : uint32_t {
+    Box = 0,
+    Gaussian = 1,
+    Mitchell = 2
+};
+
+
+// Final pass of the HDR pipeline: one compute dispatch reads the HDR output once, reconstructs
+// every display pixel with a filter scaled to the render scale (SSAA resolve or upscale), applies
+// exposure and the tonemap curve and writes sRGB encoded color. Targets with storage capable
+// images are written directly, otherwise the result goes to a display image and is copied over.
+class Tonemapper
+{
+public:
+    // Must match the push constant block in tonemap.comp
+    struct PushConstants {
+        glm::uvec2 srcExtent;
+        glm::uvec2 dstExtent;
+        float exposure;
+        uint32_t tonemapper;
+        uint32_t filter;
+        float pad;
+    };
+
+    Tonemapper(std::shared_ptr<VulkanContext> ctx, const RenderTarget& target);
+    ~Tonemapper();
+
+    // Every HDR image that may be passed to recordToCommandBuffer as the source
+    void createDescriptorSets(const std::vector<const StorageImage*>& sources);
+
+    // Resolves the top-left sourceExtent of source into target image imageIndex (left in GENERAL layout)
+    void recordToCommandBuffer(VkCommandBuffer commandBuffer, const StorageImage& source, VkExtent2D sourceExtent, uint32_t imageIndex);
+
+    // Image holding the result of the last recorded run (GENERAL layout, target extent)
+    VkImage getOutputImage() const { return _outputImage; }
+    VkExtent2D getExtent() const { return _extent; }
+    bool writesTargetDirectly() const { return !_targetViews.empty(); }
+
+    float exposure = 0.0f;    // EV stops
+    TonemapOperator tonemapOperator = TonemapOperator::Aces;
+    ReconstructionFilter filter = ReconstructionFilter::Mitchell;
+
+    static const char* toString(TonemapOperator op);
+    static const char* toString(ReconstructionFilter filter);
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+    VkExtent2D _extent;
+
+    std::vector<VkImage> _targetImages;
+    std::vector<VkImageView> _targetViews;        // Storage views, empty if the target can't be written
+    std::unique_ptr<StorageImage> _displayImage;  // Written instead when there are no storage views
+
+    // One set per source and output image. Their number follows the swapchain image count, so
+    // they come from an own pool sized when the sets are created instead of ctx->descriptorPool.
+    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+    std::vector<const StorageImage*> _sources;
+    std::vector<std::vector<std::unique_ptr<DescriptorSet>>> _descriptorSets;
+    std::unique_ptr<ComputePipeline> _pipeline;
+
+    VkImage _outputImage = VK_NULL_HANDLE;
+
+    void createDescriptorPool(uint32_t setCount);
+};
@@ -85,6 +85,7 @@ void SpheresScene::onLoad()
         obj.transform    = glm::translate(glm::mat4(1.0f), glm::vec3(-2.0f, 0.5f, 2.0f));
         obj.materialType = 1; // emissive
         obj.color        = glm::vec3(1.0f, 0.8f, 0.4f);
+        obj.emissionStrength = 3.0f;
         obj.metallic     = 0.0f;
         obj.roughness    = 1.0f;
         obj.transparency = 0.0f;
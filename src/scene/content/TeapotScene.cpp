@@ -3,6 +3,21 @@
 #include "gui/FontAwesome.h"
 #include <imgui.h>
 
+namespace {
+    // Order matches applyMaterial; name is used by scripts, label by the UI
+    struct MaterialPreset {
+        const char* name;
+        const char* label;
+    };
+    constexpr MaterialPreset MATERIAL_PRESETS[] = {
+        { "metallic", "Metallic" },
+        { "diffuse",  "Diffuse" },
+        { "glass",    "Glass" },
+        { "marble",   "Marble" },
+    };
+    constexpr int MATERIAL_PRESET_COUNT = static_cast<int>(std::size(MATERIAL_PRESETS));
+}
+
 void TeapotScene::onLoad()
 {
     populate(*_graph);
@@ -71,15 +86,41 @@ void TeapotScene::applyMaterial(SceneGraph::SceneObject& obj) const
     }
 }
 
+void TeapotScene::selectMaterial(int index)
+{
+    _materialCombo = index;
+    _graph->clearObjects();
+    populate(*_graph);
+}
+
+bool TeapotScene::setMaterialPreset(const std::string& name)
+{
+    for (int i = 0; i < MATERIAL_PRESET_COUNT; i++) {
+        if (name == MATERIAL_PRESETS[i].name) {
+            selectMaterial(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> TeapotScene::getMaterialPresets() const
+{
+    std::vector<std::string> names;
+    for (const MaterialPreset& preset : MATERIAL_PRESETS) names.push_back(preset.name);
+    return names;
+}
+
 void TeapotScene::buildUI()
 {
     ImGui::Separator();
     ImGui::Text(ICON_FA_PAINT_BRUSH " Material");
     ImGui::Indent(16.0f);
-        const char* materials[] = { "Metallic", "Diffuse", "Glass", "Marble" };
-        if (ImGui::Combo("##teapot_material", &_materialCombo, materials, 4)) {
-            _graph->clearObjects();
-            populate(*_graph);
+        const char* labels[MATERIAL_PRESET_COUNT];
+        for (int i = 0; i < MATERIAL_PRESET_COUNT; i++) labels[i] = MATERIAL_PRESETS[i].label;
+        int selected = _materialCombo;
+        if (ImGui::Combo("##teapot_material", &selected, labels, MATERIAL_PRESET_COUNT)) {
+            selectMaterial(selected);
         }
     ImGui::Unindent(16.0f);
 }
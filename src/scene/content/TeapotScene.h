@@ -9,10 +9,13 @@ public:
 
     void onLoad() override;
     void buildUI() override;
+    bool setMaterialPreset(const std::string& name) override;  // metallic, diffuse, glass, marble
+    std::vector<std::string> getMaterialPresets() const override;
 
 private:
-    int _materialCombo = 0;  // 0=Metallic  1=Diffuse  2=Glass  3=Marble
+    int _materialCombo = 0;  // Index into the preset table: 0=Metallic  1=Diffuse  2=Glass  3=Marble
 
     void populate(SceneGraph& graph);
+    void selectMaterial(int index);   // Shared by the UI combo and setMaterialPreset
     void applyMaterial(SceneGraph::SceneObject& obj) const;
 };
@@ -57,4 +57,5 @@
 using TimePoint = std::chrono::high_resolution_clock::time_point;
 
 // [Global constants]
-const int MAX_FRAMES_IN_FLIGHT = 2;
\ No newline at end of file
+const int MAX_FRAMES_IN_FLIGHT = 4;       // Upper bound, per-frame resources are allocated for this many
+const int DEFAULT_FRAMES_IN_FLIGHT = 2;   // Runtime depth used unless configured (see FramePacer)
\ No newline at end of file
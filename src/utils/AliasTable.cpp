@@ -0,0 +1,62 @@
+#include "utils/AliasTable.h"
+
+
+AliasTable::AliasTable(const std::vector<float>& weights)
+{
+    const size_t n = weights.size();
+    if (n == 0) {
+        spdlog::error("AliasTable: cannot build a table from an empty distribution");
+        throw std::runtime_error("AliasTable: empty distribution!");
+    }
+
+    double total = 0.0;
+    for (float w : weights) {
+        if (w < 0.0f || !std::isfinite(w)) {
+            spdlog::error("AliasTable: invalid weight {}", w);
+            throw std::runtime_error("AliasTable: invalid weight!");
+        }
+        total += w;
+    }
+    _totalWeight = static_cast<float>(total);
+
+    _probability.resize(n);
+    _alias.resize(n);
+    _pdf.resize(n);
+
+    // All-zero distribution degrades to uniform
+    if (total <= 0.0) {
+        for (size_t i = 0; i < n; i++) {
+            _probability[i] = 1.0f;
+            _alias[i] = static_cast<uint32_t>(i);
+            _pdf[i] = 1.0f / static_cast<float>(n);
+        }
+        return;
+    }
+
+    // Scale so the average bucket holds exactly 1
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small, large;
+    small.reserve(n);
+    large.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        _pdf[i] = static_cast<float>(weights[i] / total);
+        scaled[i] = weights[i] * static_cast<double>(n) / total;
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+
+    // Fill each under-full bucket with mass from an over-full one
+    while (!small.empty() && !large.empty()) {
+        uint32_t s = small.back(); small.pop_back();
+        uint32_t l = large.back(); large.pop_back();
+
+        _probability[s] = static_cast<float>(scaled[s]);
+        _alias[s] = l;
+
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        (scaled[l] < 1.0 ? small : large).push_back(l);
+    }
+
+    // Leftovers are full up to rounding error
+    for (uint32_t i : large) { _probability[i] = 1.0f; _alias[i] = i; }
+    for (uint32_t i : small) { _probability[i] = 1.0f; _alias[i] = i; }
+}
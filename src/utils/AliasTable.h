@@ -0,0 +1,23 @@
+#pragma once
+#include "stdafx.h"
+
+// Walker / Vose alias table: O(1) sampling of a discrete distribution.
+// To sample: pick a bucket i uniformly, keep it with getProbability(i), otherwise take getAlias(i).
+class AliasTable {
+public:
+    AliasTable() = default;
+    explicit AliasTable(const std::vector<float>& weights);
+
+    size_t size() const { return _probability.size(); }
+    float getTotalWeight() const { return _totalWeight; }
+
+    float getProbability(size_t i) const { return _probability[i]; } // Chance to keep bucket i
+    uint32_t getAlias(size_t i) const { return _alias[i]; }          // Fallback entry of bucket i
+    float getPdf(size_t i) const { return _pdf[i]; }                 // weight[i] / totalWeight
+
+private:
+    std::vector<float> _probability;
+    std::vector<uint32_t> _alias;
+    std::vector<float> _pdf;
+    float _totalWeight = 0.0f;
+};
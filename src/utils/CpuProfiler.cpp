@@ -0,0 +1,146 @@
+#include "utils/CpuProfiler.h"
+
+#include <limits>
+
+
+namespace {
+    std::string escapeJson(const std::string& text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+}
+
+
+std::mutex& CpuProfiler::getRegistryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<std::shared_ptr<CpuProfiler::ThreadBuffer>>& CpuProfiler::getRegistry() {
+    static std::vector<std::shared_ptr<ThreadBuffer>> registry;
+    return registry;
+}
+
+CpuProfiler::ThreadBuffer& CpuProfiler::getThreadBuffer() {
+    // Registered once per thread, after that the hot path only touches the thread local pointer
+    thread_local ThreadBuffer* buffer = [] {
+        auto created = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(getRegistryMutex());
+        auto& registry = getRegistry();
+        created->threadId = static_cast<uint32_t>(registry.size() + 1);
+        created->threadName = fmt::format("Thread {}", created->threadId);
+        registry.push_back(created);
+        return created.get();
+    }();
+    return *buffer;
+}
+
+void CpuProfiler::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(getRegistryMutex());
+    buffer.threadName = name;
+}
+
+void CpuProfiler::record(const char* name, int64_t startNs, int64_t endNs) {
+    ThreadBuffer& buffer = getThreadBuffer();
+    const uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[index % RING_SIZE];
+    // Mark the slot as being written before touching the fields
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.endNs.store(endNs, std::memory_order_relaxed);
+    slot.sequence.store(2 * (index + 1), std::memory_order_release);
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+
+bool CpuProfiler::writeChromeTrace(const std::string& path, const std::vector<ExternalEvent>& externalEvents) {
+    // Snapshot the rings. The owning threads keep recording, so an entry is kept only if its slot
+    // held that exact entry both before and after the fields were copied.
+    struct ThreadSnapshot {
+        uint32_t threadId;
+        std::string threadName;
+        std::vector<Event> events;
+    };
+    std::vector<ThreadSnapshot> threads;
+    {
+        std::lock_guard<std::mutex> lock(getRegistryMutex());
+        for (const auto& buffer : getRegistry()) {
+            ThreadSnapshot snapshot{ buffer->threadId, buffer->threadName, {} };
+            const uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+            const uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+            snapshot.events.reserve(static_cast<size_t>(end - begin));
+            for (uint64_t i = begin; i < end; i++) {
+                const Slot& slot = buffer->slots[i % RING_SIZE];
+                const uint64_t expected = 2 * (i + 1);
+                if (slot.sequence.load(std::memory_order_acquire) != expected) continue;
+                Event event{
+                    slot.name.load(std::memory_order_relaxed),
+                    slot.startNs.load(std::memory_order_relaxed),
+                    slot.endNs.load(std::memory_order_relaxed) };
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != expected) continue;
+                snapshot.events.push_back(event);
+            }
+            threads.push_back(std::move(snapshot));
+        }
+    }
+
+    // Timestamps relative to the earliest event keep the microsecond values short
+    int64_t origin = std::numeric_limits<int64_t>::max();
+    size_t eventCount = externalEvents.size();
+    for (const auto& thread : threads) {
+        for (const Event& event : thread.events) origin = std::min(origin, event.startNs);
+        eventCount += thread.events.size();
+    }
+    for (const auto& event : externalEvents) origin = std::min(origin, event.startNs);
+    if (eventCount == 0) origin = 0;
+
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent, error);
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        spdlog::warn("Failed to open {} for writing", path);
+        return false;
+    }
+
+    auto toMicroseconds = [origin](int64_t ns) { return static_cast<double>(ns - origin) * 1e-3; };
+    bool first = true;
+    auto separator = [&first]() { const char* s = first ? "\n" : ",\n"; first = false; return s; };
+
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (const auto& thread : threads) {
+        file << separator() << fmt::format(R"({{"name": "thread_name", "ph": "M", "pid": 1, "tid": {}, "args": {{"name": "{}"}}}})",
+            thread.threadId, escapeJson(thread.threadName));
+        for (const Event& event : thread.events) {
+            file << separator() << fmt::format(R"({{"name": "{}", "cat": "cpu", "ph": "X", "pid": 1, "tid": {}, "ts": {:.3f}, "dur": {:.3f}}})",
+                escapeJson(event.name), thread.threadId, toMicroseconds(event.startNs), static_cast<double>(event.endNs - event.startNs) * 1e-3);
+        }
+    }
+
+    // External timelines get their own rows after the CPU threads
+    std::vector<std::string> tracks;
+    for (const auto& event : externalEvents) {
+        auto it = std::find(tracks.begin(), tracks.end(), event.track);
+        size_t trackIndex = static_cast<size_t>(it - tracks.begin());
+        if (it == tracks.end()) {
+            tracks.push_back(event.track);
+            file << separator() << fmt::format(R"({{"name": "thread_name", "ph": "M", "pid": 1, "tid": {}, "args": {{"name": "{}"}}}})",
+                1000 + trackIndex, escapeJson(event.track));
+        }
+        file << separator() << fmt::format(R"({{"name": "{}", "cat": "{}", "ph": "X", "pid": 1, "tid": {}, "ts": {:.3f}, "dur": {:.3f}}})",
+            escapeJson(event.name), escapeJson(event.track), 1000 + trackIndex, toMicroseconds(event.startNs), static_cast<double>(event.endNs - event.startNs) * 1e-3);
+    }
+    file << "\n]}\n";
+
+    spdlog::info("Wrote Chrome trace with {} events to {}", eventCount, path);
+    return true;
+}
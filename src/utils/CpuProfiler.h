@@ -0,0 +1,92 @@
+#pragma once
+#include "stdafx.h"
+
+#include <atomic>
+#include <mutex>
+
+
+// Scoped CPU zones recorded into per-thread ring buffers. Recording a zone touches only the
+// calling thread's ring (no locks, no allocation); the rings are merged when a Chrome trace
+// (chrome://tracing, Perfetto) is written. Zones are compiled out unless CPU_PROFILER is
+// defined (CMake option ENABLE_CPU_PROFILER, Debug and RelWithDebInfo builds only).
+class CpuProfiler {
+public:
+    static constexpr size_t RING_SIZE = 1 << 15;   // Zones kept per thread (1 MiB), oldest are overwritten
+
+    // Nanoseconds on the steady clock, the time base of every trace event
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Name shown for the calling thread's track
+    static void setThreadName(const std::string& name);
+
+    // Name must outlive the profiler (string literal or __func__)
+    static void record(const char* name, int64_t startNs, int64_t endNs);
+
+    class Zone {
+    public:
+        explicit Zone(const char* name) : _name(name), _start(now()) {}
+        ~Zone() { record(_name, _start, now()); }
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+    private:
+        const char* _name;
+        int64_t _start;
+    };
+
+    // Events from another timeline (e.g. GPU passes), already converted to the steady clock
+    struct ExternalEvent {
+        std::string name;
+        std::string track;    // One trace row per track name
+        int64_t startNs;
+        int64_t endNs;
+    };
+
+    // Writes every recorded zone plus the external events as Chrome trace_event JSON
+    static bool writeChromeTrace(const std::string& path, const std::vector<ExternalEvent>& externalEvents = {});
+
+private:
+    struct Event {
+        const char* name;
+        int64_t startNs;
+        int64_t endNs;
+    };
+
+    // Ring entry published seqlock style: sequence is odd while the owning thread writes it and
+    // 2 * (index + 1) once event index is complete. Fields are relaxed atomics so the trace writer
+    // may read a slot concurrently with the owner and discard it if the sequence changed.
+    struct Slot {
+        std::atomic<uint64_t> sequence{ 0 };
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<int64_t> startNs{ 0 };
+        std::atomic<int64_t> endNs{ 0 };
+    };
+
+    // Written only by its thread; writeIndex bounds the entries the trace writer looks at
+    struct ThreadBuffer {
+        uint32_t threadId = 0;
+        std::string threadName;
+        std::unique_ptr<Slot[]> slots = std::make_unique<Slot[]>(RING_SIZE);
+        std::atomic<uint64_t> writeIndex{ 0 };
+    };
+
+    static ThreadBuffer& getThreadBuffer();
+
+    // Buffers outlive their threads so zones of finished workers still show up
+    static std::mutex& getRegistryMutex();
+    static std::vector<std::shared_ptr<ThreadBuffer>>& getRegistry();
+};
+
+#ifdef CPU_PROFILER
+    #define PROFILE_CONCAT_INNER(a, b) a##b
+    #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+    #define PROFILE_SCOPE(name) CpuProfiler::Zone PROFILE_CONCAT(_profileZone, __LINE__)(name)
+    #define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+    #define PROFILE_THREAD(name) CpuProfiler::setThreadName(name)
+#else
+    #define PROFILE_SCOPE(name) ((void)0)
+    #define PROFILE_FUNCTION() ((void)0)
+    #define PROFILE_THREAD(name) ((void)0)
+#endif
@@ -0,0 +1,92 @@
+#include "utils/ImageEncoder.h"
+#include "utils/ImageWriter.h"
+#include "utils/CpuProfiler.h"
+
+
+ImageEncoder::ImageEncoder(uint32_t threadCount, uint32_t maxQueued) {
+    if (threadCount == 0) {
+        // Leave most cores to the render thread and the driver
+        threadCount = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    }
+    // Every queued image holds a full frame of pixels, keep just enough to cover write jitter
+    _maxQueued = maxQueued != 0 ? maxQueued : threadCount * 2;
+
+    _workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        _workers.emplace_back(&ImageEncoder::workerLoop, this);
+    }
+    spdlog::debug("Image encoder started with {} thread(s)", threadCount);
+}
+
+ImageEncoder::~ImageEncoder() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _workAvailable.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+void ImageEncoder::enqueue(CapturedImage image) {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_queue.size() >= _maxQueued) {
+            if (!_warnedFull) {
+                spdlog::warn("Image encoder queue is full ({} images), captures now wait for the disk", _maxQueued);
+                _warnedFull = true;
+            }
+            PROFILE_SCOPE("ImageEncoder::enqueue wait");
+            _spaceAvailable.wait(lock, [this] { return _queue.size() < _maxQueued; });
+        }
+        _queue.push_back(std::move(image));
+    }
+    _workAvailable.notify_one();
+}
+
+void ImageEncoder::waitIdle() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this] { return _queue.empty() && _busyWorkers == 0; });
+}
+
+uint32_t ImageEncoder::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<uint32_t>(_queue.size()) + _busyWorkers;
+}
+
+void ImageEncoder::workerLoop() {
+    PROFILE_THREAD("Image Encoder");
+    for (;;) {
+        CapturedImage image;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            // Drain the queue before honoring a stop request
+            _workAvailable.wait(lock, [this] { return _stopping || !_queue.empty(); });
+            if (_queue.empty()) return;
+            image = std::move(_queue.front());
+            _queue.pop_front();
+            _busyWorkers++;
+        }
+        _spaceAvailable.notify_one();
+
+        try {
+            PROFILE_SCOPE("ImageEncoder::write");
+            std::filesystem::path parent = std::filesystem::path(image.path).parent_path();
+            if (!parent.empty()) std::filesystem::create_directories(parent);
+            ImageWriter::write(image.path, image.width, image.height, image.rgba.data());
+            spdlog::debug("Wrote {}x{} image to {}", image.width, image.height, image.path);
+            _writtenCount++;
+        } catch (const std::exception& e) {
+            // Keep the worker alive, a single bad path should not stop a recording
+            spdlog::warn("Failed to write captured image {}: {}", image.path, e.what());
+            _failedCount++;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _busyWorkers--;
+            if (_queue.empty() && _busyWorkers == 0) _idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "stdafx.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+
+// Pixels read back from the GPU, waiting to be written to disk
+struct CapturedImage {
+    std::string path;            // Output file, format follows the extension (see ImageWriter)
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba;   // Tightly packed RGBA8, top row first
+};
+
+// Small worker pool that encodes and writes captured images off the render thread.
+// enqueue() does not block on disk or compression while the workers keep up. Once maxQueued
+// images are waiting it blocks the caller, so a slow disk throttles the recording instead of
+// growing the queue without bound.
+class ImageEncoder {
+public:
+    // 0 threads = pick from the hardware thread count, 0 maxQueued = two images per thread
+    explicit ImageEncoder(uint32_t threadCount = 0, uint32_t maxQueued = 0);
+    ~ImageEncoder();                                   // Finishes every queued image
+
+    ImageEncoder(const ImageEncoder&) = delete;
+    ImageEncoder& operator=(const ImageEncoder&) = delete;
+
+    // Blocks while the queue is full
+    void enqueue(CapturedImage image);
+
+    // Blocks until the queue is empty and no worker is busy
+    void waitIdle();
+
+    uint32_t getPendingCount() const;
+    uint32_t getWrittenCount() const { return _writtenCount; }
+    uint32_t getFailedCount() const { return _failedCount; }
+
+private:
+    std::vector<std::thread> _workers;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _idle;
+    std::condition_variable _spaceAvailable;
+    std::deque<CapturedImage> _queue;
+    uint32_t _maxQueued = 0;
+    uint32_t _busyWorkers = 0;
+    bool _stopping = false;
+    bool _warnedFull = false;
+
+    std::atomic<uint32_t> _writtenCount{ 0 };
+    std::atomic<uint32_t> _failedCount{ 0 };
+
+    void workerLoop();
+};
@@ -0,0 +1,153 @@
+#include "utils/ImageWriter.h"
+
+
+namespace ImageWriter {
+
+    static std::string getExtension(const std::string& imagePath) {
+        std::string extension = std::filesystem::path(imagePath).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension;
+    }
+
+    bool isSupported(const std::string& imagePath) {
+        const std::string extension = getExtension(imagePath);
+        return extension == ".ppm" || extension == ".png";
+    }
+
+    // ------- PPM ------- //
+
+    static void writePpm(std::ofstream& file, uint32_t width, uint32_t height, const uint8_t* rgba) {
+        const std::string header = fmt::format("P6\n{} {}\n255\n", width, height);
+        file.write(header.data(), header.size());
+
+        std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+        for (uint32_t y = 0; y < height; y++) {
+            const uint8_t* src = rgba + static_cast<size_t>(y) * width * 4;
+            for (uint32_t x = 0; x < width; x++) {
+                row[x * 3 + 0] = src[x * 4 + 0];
+                row[x * 3 + 1] = src[x * 4 + 1];
+                row[x * 3 + 2] = src[x * 4 + 2];
+            }
+            file.write(reinterpret_cast<const char*>(row.data()), row.size());
+        }
+    }
+
+    // ------- PNG ------- //
+
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size) {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++)
+                    c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++)
+            crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    static void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static void writeChunk(std::ofstream& file, const char type[4], const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> chunk;
+        chunk.reserve(data.size() + 12);
+        appendBigEndian(chunk, static_cast<uint32_t>(data.size()));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        // CRC covers type + data
+        appendBigEndian(chunk, crc32(0, chunk.data() + 4, data.size() + 4));
+        file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    }
+
+    static void writePng(std::ofstream& file, uint32_t width, uint32_t height, const uint8_t* rgba) {
+        static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+        file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+        std::vector<uint8_t> ihdr;
+        appendBigEndian(ihdr, width);
+        appendBigEndian(ihdr, height);
+        ihdr.push_back(8);  // Bit depth
+        ihdr.push_back(2);  // Color type: RGB
+        ihdr.push_back(0);  // Compression: deflate
+        ihdr.push_back(0);  // Filter method
+        ihdr.push_back(0);  // No interlace
+        writeChunk(file, "IHDR", ihdr);
+
+        // Raw scanlines, each prefixed with filter type 0 (none)
+        const size_t rowSize = static_cast<size_t>(width) * 3 + 1;
+        std::vector<uint8_t> raw(rowSize * height);
+        for (uint32_t y = 0; y < height; y++) {
+            uint8_t* dst = raw.data() + y * rowSize;
+            const uint8_t* src = rgba + static_cast<size_t>(y) * width * 4;
+            dst[0] = 0;
+            for (uint32_t x = 0; x < width; x++) {
+                dst[1 + x * 3 + 0] = src[x * 4 + 0];
+                dst[1 + x * 3 + 1] = src[x * 4 + 1];
+                dst[1 + x * 3 + 2] = src[x * 4 + 2];
+            }
+        }
+
+        // zlib stream made of stored (uncompressed) deflate blocks, speed over size
+        constexpr size_t maxBlockSize = 65535;
+        std::vector<uint8_t> idat;
+        idat.reserve(raw.size() + (raw.size() / maxBlockSize + 1) * 5 + 6);
+        idat.push_back(0x78);
+        idat.push_back(0x01);
+        for (size_t offset = 0; ; offset += maxBlockSize) {
+            const size_t blockSize = std::min(maxBlockSize, raw.size() - offset);
+            const bool last = offset + blockSize >= raw.size();
+            idat.push_back(last ? 1 : 0);
+            idat.push_back(static_cast<uint8_t>(blockSize));
+            idat.push_back(static_cast<uint8_t>(blockSize >> 8));
+            idat.push_back(static_cast<uint8_t>(~blockSize));
+            idat.push_back(static_cast<uint8_t>(~blockSize >> 8));
+            idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+            if (last) break;
+        }
+
+        uint32_t a = 1, b = 0;
+        for (uint8_t value : raw) {
+            a = (a + value) % 65521;
+            b = (b + a) % 65521;
+        }
+        appendBigEndian(idat, (b << 16) | a);
+        writeChunk(file, "IDAT", idat);
+
+        writeChunk(file, "IEND", {});
+    }
+
+    void write(const std::string& imagePath, uint32_t width, uint32_t height, const uint8_t* rgba) {
+        const std::string extension = getExtension(imagePath);
+        if (!isSupported(imagePath)) {
+            spdlog::error("Unsupported image format '{}' for {} (expected .ppm or .png)", extension, imagePath);
+            throw std::runtime_error("Unsupported image format!");
+        }
+
+        std::ofstream file(imagePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            spdlog::error("Failed to open {} for writing", imagePath);
+            throw std::runtime_error("Failed to open image for writing!");
+        }
+
+        if (extension == ".png") writePng(file, width, height, rgba);
+        else writePpm(file, width, height, rgba);
+
+        if (!file.good()) {
+            spdlog::error("Failed to write image {}", imagePath);
+            throw std::runtime_error("Failed to write image!");
+        }
+    }
+
+}
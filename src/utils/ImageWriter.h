@@ -0,0 +1,13 @@
+#pragma once
+#include "stdafx.h"
+
+// Minimal 8-bit image output for offscreen renders, dependency free.
+// Format follows the file extension: .ppm (binary P6) or .png (uncompressed deflate).
+namespace ImageWriter {
+
+    bool isSupported(const std::string& imagePath);
+
+    // rgba: width * height tightly packed RGBA8 pixels, top row first (alpha is dropped)
+    void write(const std::string& imagePath, uint32_t width, uint32_t height, const uint8_t* rgba);
+
+}
@@ -0,0 +1,94 @@
+#include "vulkan/AsyncCompute.h"
+#include "utils/CpuProfiler.h"
+
+
+AsyncCompute::AsyncCompute(std::shared_ptr<VulkanContext> ctx)
+    : _ctx(std::move(ctx))
+{
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(_ctx->device, &semaphoreInfo, nullptr, &_timeline) != VK_SUCCESS) {
+        spdlog::error("Failed to create async compute timeline semaphore!");
+        throw std::runtime_error("Failed to create async compute timeline semaphore!");
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = _ctx->computeCommandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
+    if (vkAllocateCommandBuffers(_ctx->device, &allocInfo, _commandBuffers.data()) != VK_SUCCESS) {
+        spdlog::error("Failed to allocate async compute command buffers!");
+        throw std::runtime_error("Failed to allocate async compute command buffers!");
+    }
+}
+
+AsyncCompute::~AsyncCompute() {
+    waitIdle();
+    vkFreeCommandBuffers(_ctx->device, _ctx->computeCommandPool, MAX_FRAMES_IN_FLIGHT, _commandBuffers.data());
+    vkDestroySemaphore(_ctx->device, _timeline, nullptr);
+}
+
+VkCommandBuffer AsyncCompute::begin(uint32_t slot) {
+    // Normally retired already: the graphics frame that waited for it has completed
+    waitForValue(_slotValues[slot]);
+
+    VkCommandBuffer commandBuffer = _commandBuffers[slot];
+    vkResetCommandBuffer(commandBuffer, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    return commandBuffer;
+}
+
+uint64_t AsyncCompute::submit(uint32_t slot) {
+    PROFILE_SCOPE("AsyncCompute::submit");
+    VkCommandBuffer commandBuffer = _commandBuffers[slot];
+    vkEndCommandBuffer(commandBuffer);
+
+    const uint64_t signalValue = _value + 1;
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &_timeline;
+
+    {
+        std::lock_guard<std::mutex> queueLock(_ctx->queueMutex);
+        if (vkQueueSubmit(_ctx->computeQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            spdlog::error("Failed to submit async compute command buffer!");
+            throw std::runtime_error("Failed to submit async compute command buffer!");
+        }
+    }
+
+    _value = signalValue;
+    _slotValues[slot] = signalValue;
+    return signalValue;
+}
+
+void AsyncCompute::waitForValue(uint64_t value) const {
+    if (value == 0) return;
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &_timeline;
+    waitInfo.pValues = &value;
+    vkWaitSemaphores(_ctx->device, &waitInfo, UINT64_MAX);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/VulkanContext.h"
+
+
+// Per-frame work on the compute queue (the graphics queue on devices without a compute-only
+// family). Every submission signals the next value of a timeline semaphore; the frame's graphics
+// submit waits for that value, so compute work for frame N+1 overlaps the graphics work of frame N.
+class AsyncCompute {
+public:
+    explicit AsyncCompute(std::shared_ptr<VulkanContext> ctx);
+    ~AsyncCompute();
+
+    AsyncCompute(const AsyncCompute&) = delete;
+    AsyncCompute& operator=(const AsyncCompute&) = delete;
+
+    // Begins the frame slot's command buffer (waits for the slot's previous submission first)
+    VkCommandBuffer begin(uint32_t slot);
+    // Submits the slot's command buffer, returns the timeline value signaled on completion
+    uint64_t submit(uint32_t slot);
+
+    VkSemaphore getTimelineSemaphore() const { return _timeline; }
+    bool isDedicated() const { return _ctx->hasAsyncCompute(); }
+
+    void waitForValue(uint64_t value) const;
+    void waitIdle() const { waitForValue(_value); }
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+    VkSemaphore _timeline = VK_NULL_HANDLE;
+    uint64_t _value = 0;    // Last submitted value
+
+    std::array<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> _commandBuffers{};
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> _slotValues{};
+};
@@ -0,0 +1,208 @@
+#include "vulkan/CommandSubmitter.h"
+#include "utils/CpuProfiler.h"
+
+
+namespace {
+    // Lives as long as the calling thread, pools keep a weak reference to notice the thread exit
+    const std::shared_ptr<void>& getThreadToken() {
+        thread_local std::shared_ptr<void> token = std::make_shared<char>();
+        return token;
+    }
+}
+
+CommandSubmitter::CommandSubmitter(VkDevice device, VkQueue queue, uint32_t queueFamily, std::mutex& queueMutex)
+    : _device(device), _queue(queue), _queueFamily(queueFamily), _queueMutex(queueMutex)
+{
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+    if (vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &_timeline) != VK_SUCCESS) {
+        spdlog::error("Failed to create command submitter timeline semaphore!");
+        throw std::runtime_error("Failed to create command submitter timeline semaphore!");
+    }
+}
+
+CommandSubmitter::~CommandSubmitter() {
+    waitIdle();
+
+    // Pools of threads that are gone are released here too
+    for (auto& [thread, threadPool] : _threadPools) {
+        vkDestroyCommandPool(_device, threadPool->pool, nullptr);
+    }
+    for (auto& threadPool : _retiredPools) {
+        vkDestroyCommandPool(_device, threadPool->pool, nullptr);
+    }
+    vkDestroySemaphore(_device, _timeline, nullptr);
+}
+
+
+CommandSubmitter::ThreadPool& CommandSubmitter::getThreadPool() {
+    const std::shared_ptr<void>& token = getThreadToken();
+    std::unique_ptr<ThreadPool>& threadPool = _threadPools[std::this_thread::get_id()];
+
+    // Thread ids are reused, a pool left behind by an exited thread is not ours
+    if (threadPool && threadPool->owner.lock() != token) {
+        _retiredPools.push_back(std::move(threadPool));
+    }
+
+    if (!threadPool) {
+        threadPool = std::make_unique<ThreadPool>();
+        threadPool->owner = token;
+
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = _queueFamily;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        if (vkCreateCommandPool(_device, &poolInfo, nullptr, &threadPool->pool) != VK_SUCCESS) {
+            spdlog::error("Failed to create command submitter pool!");
+            throw std::runtime_error("Failed to create command submitter pool!");
+        }
+    }
+    return *threadPool;
+}
+
+void CommandSubmitter::releaseExitedThreadPools() {
+    for (auto it = _threadPools.begin(); it != _threadPools.end();) {
+        if (it->second && it->second->owner.expired()) {
+            _retiredPools.push_back(std::move(it->second));
+            it = _threadPools.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // The owning thread is gone, so once nothing is in flight nobody else touches the pool
+    for (auto it = _retiredPools.begin(); it != _retiredPools.end();) {
+        if ((*it)->outstanding == 0) {
+            vkDestroyCommandPool(_device, (*it)->pool, nullptr);
+            it = _retiredPools.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+VkCommandBuffer CommandSubmitter::begin() {
+    poll();
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    ThreadPool* threadPool;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        threadPool = &getThreadPool();
+        threadPool->outstanding++;
+        if (!threadPool->freeBuffers.empty()) {
+            commandBuffer = threadPool->freeBuffers.back();
+            threadPool->freeBuffers.pop_back();
+        }
+    }
+
+    // The pool itself is only touched by this thread
+    if (commandBuffer == VK_NULL_HANDLE) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = threadPool->pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(_device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            spdlog::error("Failed to allocate command submitter command buffer!");
+            throw std::runtime_error("Failed to allocate command submitter command buffer!");
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _recording[commandBuffer] = threadPool;
+    return commandBuffer;
+}
+
+uint64_t CommandSubmitter::submit(VkCommandBuffer commandBuffer, std::function<void()> onComplete) {
+    PROFILE_SCOPE("CommandSubmitter::submit");
+    vkEndCommandBuffer(commandBuffer);
+
+    // Values have to reach the queue in order, so they are taken and submitted under one lock
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _recording.find(commandBuffer);
+    if (it == _recording.end()) {
+        spdlog::error("Command buffer was not begun by this submitter!");
+        throw std::runtime_error("Command buffer was not begun by this submitter!");
+    }
+
+    const uint64_t signalValue = _submittedValue + 1;
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &_timeline;
+    {
+        std::lock_guard<std::mutex> queueLock(_queueMutex);
+        if (vkQueueSubmit(_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            spdlog::error("Failed to submit one time command buffer!");
+            throw std::runtime_error("Failed to submit one time command buffer!");
+        }
+    }
+
+    _submittedValue = signalValue;
+    _inFlight.push_back({ signalValue, commandBuffer, it->second, std::move(onComplete) });
+    _recording.erase(it);
+    return signalValue;
+}
+
+void CommandSubmitter::wait(uint64_t value) {
+    if (value > getCompletedValue()) {
+        PROFILE_SCOPE("CommandSubmitter::wait");
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &_timeline;
+        waitInfo.pValues = &value;
+        vkWaitSemaphores(_device, &waitInfo, UINT64_MAX);
+    }
+    poll();
+}
+
+void CommandSubmitter::poll() {
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const uint64_t completed = getCompletedValue();
+        while (!_inFlight.empty() && _inFlight.front().value <= completed) {
+            Submission& submission = _inFlight.front();
+            submission.pool->freeBuffers.push_back(submission.commandBuffer);
+            submission.pool->outstanding--;
+            if (submission.onComplete) callbacks.push_back(std::move(submission.onComplete));
+            _inFlight.pop_front();
+        }
+        releaseExitedThreadPools();
+    }
+
+    // Outside the lock, callbacks may submit again
+    for (auto& callback : callbacks) callback();
+}
+
+uint64_t CommandSubmitter::getCompletedValue() const {
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(_device, _timeline, &value);
+    return value;
+}
+
+uint64_t CommandSubmitter::getSubmittedValue() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _submittedValue;
+}
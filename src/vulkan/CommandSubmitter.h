@@ -0,0 +1,77 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <deque>
+#include <mutex>
+
+
+// One time command buffers without queue idles. Every submission signals the next value of a
+// timeline semaphore, so callers wait for their own work only (or not at all) and can attach a
+// callback that runs once it is done. Command buffers come from a pool per recording thread,
+// so loading threads can record while the main thread records its frames. Pools of threads that
+// have exited are destroyed once their last submission completes.
+class CommandSubmitter {
+public:
+    // queueMutex guards every submission to queue (shared with the other users of the queue)
+    CommandSubmitter(VkDevice device, VkQueue queue, uint32_t queueFamily, std::mutex& queueMutex);
+    // Waits for all submissions and runs their callbacks
+    ~CommandSubmitter();
+
+    CommandSubmitter(const CommandSubmitter&) = delete;
+    CommandSubmitter& operator=(const CommandSubmitter&) = delete;
+
+    // Begun command buffer from the calling thread's pool, submit it from the same thread
+    VkCommandBuffer begin();
+    // Returns the timeline value signaled when the work is done. onComplete runs on the thread
+    // calling poll() or wait() once that value is reached.
+    uint64_t submit(VkCommandBuffer commandBuffer, std::function<void()> onComplete = nullptr);
+
+    // Blocks until value is reached, then polls
+    void wait(uint64_t value);
+    void waitIdle() { wait(getSubmittedValue()); }
+    // Recycles finished command buffers and runs their callbacks
+    void poll();
+
+    bool isComplete(uint64_t value) const { return value <= getCompletedValue(); }
+    uint64_t getCompletedValue() const;
+    uint64_t getSubmittedValue() const;
+    VkSemaphore getTimelineSemaphore() const { return _timeline; }
+
+private:
+    VkDevice _device;
+    VkQueue _queue;
+    uint32_t _queueFamily;
+    std::mutex& _queueMutex;
+
+    VkSemaphore _timeline = VK_NULL_HANDLE;
+    uint64_t _submittedValue = 0;
+
+    // Only the owning thread records from a pool; finished buffers are handed back through
+    // freeBuffers and reset implicitly by the next vkBeginCommandBuffer. owner expires when the
+    // recording thread exits, outstanding counts buffers that are recording or in flight.
+    struct ThreadPool {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> freeBuffers;
+        std::weak_ptr<void> owner;
+        uint32_t outstanding = 0;
+    };
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadPool>> _threadPools;
+    // Pools of exited threads waiting for their last submissions
+    std::vector<std::unique_ptr<ThreadPool>> _retiredPools;
+    std::unordered_map<VkCommandBuffer, ThreadPool*> _recording;
+
+    struct Submission {
+        uint64_t value;
+        VkCommandBuffer commandBuffer;
+        ThreadPool* pool;
+        std::function<void()> onComplete;
+    };
+    std::deque<Submission> _inFlight;
+
+    mutable std::mutex _mutex;
+
+    ThreadPool& getThreadPool();
+    // Retires pools of exited threads and destroys the idle ones, called with _mutex held
+    void releaseExitedThreadPools();
+};
@@ -0,0 +1,112 @@
+#include "vulkan/ComputePipeline.h"
+
+ComputePipeline::ComputePipeline(std::shared_ptr<VulkanContext> ctx,
+    const std::string& computeShaderPath,
+    const ComputePipelineParams& params)
+    : _ctx(std::move(ctx)), _name(params.name)
+{
+    createPipelineLayout(params);
+    createComputePipeline(computeShaderPath, params);
+}
+
+
+ComputePipeline::~ComputePipeline()
+{
+    if (_pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(_ctx->device, _pipeline, nullptr);
+        _pipeline = VK_NULL_HANDLE;
+    }
+    if (_pipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(_ctx->device, _pipelineLayout, nullptr);
+        _pipelineLayout = VK_NULL_HANDLE;
+    }
+}
+
+
+void ComputePipeline::createPipelineLayout(const ComputePipelineParams& params)
+{
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = params.pushConstantSize;
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCI{};
+    pipelineLayoutCI.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCI.setLayoutCount = static_cast<uint32_t>(params.descriptorSetLayouts.size());
+    pipelineLayoutCI.pSetLayouts = params.descriptorSetLayouts.empty() ? nullptr : params.descriptorSetLayouts.data();
+    pipelineLayoutCI.pushConstantRangeCount = params.pushConstantSize > 0 ? 1 : 0;
+    pipelineLayoutCI.pPushConstantRanges = params.pushConstantSize > 0 ? &pushConstantRange : nullptr;
+    if (vkCreatePipelineLayout(_ctx->device, &pipelineLayoutCI, nullptr, &_pipelineLayout) != VK_SUCCESS) {
+        spdlog::error("Failed to create compute pipeline layout!");
+        throw std::runtime_error("Failed to create compute pipeline layout!");
+    }
+}
+
+
+void ComputePipeline::createComputePipeline(const std::string& computeShaderPath, const ComputePipelineParams& params)
+{
+    auto computeShaderCode = readBinaryFile(computeShaderPath);
+    VkShaderModule computeShaderModule = createShaderModule(computeShaderCode);
+
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = static_cast<uint32_t>(params.specializationEntries.size());
+    specializationInfo.pMapEntries = params.specializationEntries.data();
+    specializationInfo.dataSize = params.specializationData.size();
+    specializationInfo.pData = params.specializationData.data();
+
+    VkPipelineShaderStageCreateInfo computeShaderStageInfo{};
+    computeShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    computeShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    computeShaderStageInfo.module = computeShaderModule;
+    computeShaderStageInfo.pName = "main";
+    computeShaderStageInfo.pSpecializationInfo = params.specializationEntries.empty() ? nullptr : &specializationInfo;
+
+    VkComputePipelineCreateInfo computePipelineCI{};
+    computePipelineCI.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    computePipelineCI.stage = computeShaderStageInfo;
+    computePipelineCI.layout = _pipelineLayout;
+    computePipelineCI.basePipelineHandle = VK_NULL_HANDLE;
+    computePipelineCI.basePipelineIndex = -1;
+
+    if (vkCreateComputePipelines(_ctx->device, _ctx->pipelineCache, 1, &computePipelineCI, nullptr, &_pipeline) != VK_SUCCESS) {
+        vkDestroyShaderModule(_ctx->device, computeShaderModule, nullptr);
+        throw std::runtime_error("Failed to create compute pipeline!");
+    } else {
+        spdlog::info("Compute pipeline created successfully {}", _name != "" ? fmt::format("({})", _name) : "");
+    }
+
+    vkDestroyShaderModule(_ctx->device, computeShaderModule, nullptr);
+}
+
+VkShaderModule ComputePipeline::createShaderModule(const std::vector<char>& code)
+{
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = code.size();
+    createInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(_ctx->device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create shader module!");
+    }
+
+    return shaderModule;
+}
+
+std::vector<char> ComputePipeline::readBinaryFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        spdlog::error("Failed to open file: {}", filename);
+        return {};
+    }
+
+    size_t fileSize = (size_t) file.tellg();
+    std::vector<char> buffer(fileSize);
+
+    file.seekg(0);
+    file.read(buffer.data(), fileSize);
+
+    file.close();
+
+    return buffer;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/VulkanContext.h"
+#include "vulkan/VulkanHelper.h"
+
+
+struct ComputePipelineParams {
+    std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+
+    // Push constant block visible to the compute stage (0 = none)
+    uint32_t pushConstantSize = 0;
+
+    // Specialization constants
+    std::vector<VkSpecializationMapEntry> specializationEntries;
+    std::vector<uint8_t> specializationData;
+
+    std::string name;
+};
+
+
+class ComputePipeline {
+public:
+    ComputePipeline(std::shared_ptr<VulkanContext> ctx,
+        const std::string& computeShaderPath,
+        const ComputePipelineParams& params
+    );
+    ~ComputePipeline();
+
+    VkPipeline getPipeline() const { return _pipeline; }
+    VkPipelineLayout getPipelineLayout() const { return _pipelineLayout; }
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+
+    VkPipeline _pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
+
+    void createPipelineLayout(const ComputePipelineParams& params);
+    void createComputePipeline(const std::string& computeShaderPath, const ComputePipelineParams& params);
+
+    VkShaderModule createShaderModule(const std::vector<char>& code);
+    std::vector<char> readBinaryFile(const std::string& filename);
+
+    std::string _name;
+};
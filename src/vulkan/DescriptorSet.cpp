@@ -1,8 +1,8 @@
 #include "vulkan/DescriptorSet.h"
 
 
-DescriptorSet::DescriptorSet(std::shared_ptr<VulkanContext> ctx, const std::vector<Descriptor>& descriptors)
-    : _ctx(std::move(ctx))
+DescriptorSet::DescriptorSet(std::shared_ptr<VulkanContext> ctx, const std::vector<Descriptor>& descriptors, VkDescriptorPool pool)
+    : _ctx(std::move(ctx)), _pool(pool != VK_NULL_HANDLE ? pool : _ctx->descriptorPool)
 {
     createDescriptorSetLayout(descriptors);
     createDescriptorSet(descriptors);
@@ -11,7 +11,7 @@ DescriptorSet::DescriptorSet(std::shared_ptr<VulkanContext> ctx, const std::vect
 
 DescriptorSet::~DescriptorSet()
 {
-    vkFreeDescriptorSets(_ctx->device, _ctx->descriptorPool, 1, &_descriptorSet);
+    vkFreeDescriptorSets(_ctx->device, _pool, 1, &_descriptorSet);
     vkDestroyDescriptorSetLayout(_ctx->device, _descriptorSetLayout, nullptr);
 }
 
@@ -43,7 +43,7 @@ void DescriptorSet::createDescriptorSet(const std::vector<Descriptor>& descripto
 {
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = _ctx->descriptorPool;
+    allocInfo.descriptorPool = _pool;
     allocInfo.descriptorSetCount = 1;
     allocInfo.pSetLayouts = &_descriptorSetLayout;
 
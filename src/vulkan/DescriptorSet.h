@@ -29,7 +29,8 @@ struct Descriptor
 class DescriptorSet
 {
 public:
-    DescriptorSet(std::shared_ptr<VulkanContext> ctx, const std::vector<Descriptor>& descriptors);
+    // Allocated from ctx->descriptorPool unless another pool (with FREE_DESCRIPTOR_SET_BIT) is given
+    DescriptorSet(std::shared_ptr<VulkanContext> ctx, const std::vector<Descriptor>& descriptors, VkDescriptorPool pool = VK_NULL_HANDLE);
     ~DescriptorSet();
 
     VkDescriptorSetLayout getDescriptorSetLayout() const { return _descriptorSetLayout; }
@@ -38,6 +39,7 @@ public:
 private:
     std::shared_ptr<VulkanContext> _ctx;
 
+    VkDescriptorPool _pool;
     VkDescriptorSetLayout _descriptorSetLayout = VK_NULL_HANDLE;
     VkDescriptorSet _descriptorSet = VK_NULL_HANDLE;
 
@@ -0,0 +1,377 @@
+#include "vulkan/GpuProfiler.h"
+#include "vulkan/VulkanHelper.h"
+#include "gui/FontAwesome.h"
+
+#include <limits>
+
+
+namespace {
+    // Marks a scope dropped because the slot ran out of queries
+    constexpr size_t DROPPED_SCOPE = std::numeric_limits<size_t>::max();
+
+    float percentile(std::vector<float>& values, float p) {
+        if (values.empty()) return 0.0f;
+        size_t index = std::min(values.size() - 1, static_cast<size_t>(p * static_cast<float>(values.size())));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    bool createParentDirectory(const std::string& path) {
+        std::error_code error;
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) std::filesystem::create_directories(parent, error);
+        return !error;
+    }
+}
+
+
+GpuProfiler::GpuProfiler(std::shared_ptr<VulkanContext> ctx)
+    : _ctx(std::move(ctx))
+{
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(_ctx->physicalDevice, &properties);
+    _timestampPeriod = properties.limits.timestampPeriod;
+
+    if (!properties.limits.timestampComputeAndGraphics) {
+        spdlog::warn("Device does not support timestamps on graphics queues, GPU profiling and dynamic resolution are unavailable.");
+        return;
+    }
+
+    // Two queries (begin + end) per scope, one range per frame slot, plus the calibration query
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = 2 * MAX_SCOPES_PER_FRAME * MAX_FRAMES_IN_FLIGHT + 1;
+    if (vkCreateQueryPool(_ctx->device, &queryPoolInfo, nullptr, &_queryPool) != VK_SUCCESS) {
+        spdlog::error("Failed to create timestamp query pool!");
+        throw std::runtime_error("Failed to create timestamp query pool!");
+    }
+
+    // Queries start out undefined, every range is reset from the host after it is read
+    vkResetQueryPool(_ctx->device, _queryPool, 0, queryPoolInfo.queryCount);
+}
+
+GpuProfiler::~GpuProfiler() {
+    if (_queryPool != VK_NULL_HANDLE)
+        vkDestroyQueryPool(_ctx->device, _queryPool, nullptr);
+}
+
+
+void GpuProfiler::beginFrame(uint32_t slot, uint64_t frameNumber) {
+    readSlot(slot);
+    _currentSlot = slot;
+    _slots[slot].frameNumber = frameNumber;
+}
+
+void GpuProfiler::collectAll() {
+    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) readSlot(i);
+}
+
+void GpuProfiler::readSlot(uint32_t slotIndex) {
+    Slot& slot = _slots[slotIndex];
+    if (_queryPool == VK_NULL_HANDLE || slot.queryCount == 0) return;
+
+    const uint32_t firstQuery = 2 * MAX_SCOPES_PER_FRAME * slotIndex;
+
+    // The frame has completed, so the results are available without waiting. A scope left open
+    // (or never submitted) keeps its end query unavailable and the whole frame is dropped.
+    std::vector<uint64_t> timestamps(slot.queryCount);
+    VkResult result = vkGetQueryPoolResults(_ctx->device, _queryPool,
+        firstQuery, slot.queryCount,
+        timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+
+    if (result == VK_SUCCESS && slot.openScopes.empty()) {
+        FrameTimings frame{ slot.frameNumber, 0.0f, std::vector<float>(_scopeNames.size(), -1.0f) };
+        for (const PendingScope& scope : slot.scopes) {
+            const uint64_t begin = timestamps[scope.beginQuery - firstQuery];
+            const uint64_t end = timestamps[scope.beginQuery - firstQuery + 1];
+            const float ms = static_cast<float>(end - begin) * _timestampPeriod * 1e-6f;
+
+            // The same pass may run more than once per frame (e.g. several TLAS updates)
+            float& scopeMs = frame.scopeMs[scope.nameId];
+            scopeMs = (scopeMs < 0.0f ? 0.0f : scopeMs) + ms;
+            if (scope.depth == 0) frame.totalMs += ms;
+
+            _traceEvents.push_back({ scope.nameId, begin, end });
+            if (_traceEvents.size() > MAX_TRACE_EVENTS) _traceEvents.pop_front();
+        }
+        for (size_t i = 0; i < frame.scopeMs.size(); i++) {
+            if (frame.scopeMs[i] >= 0.0f) _lastMs[i] = frame.scopeMs[i];
+        }
+
+        _frames.push_back(std::move(frame));
+        if (_frames.size() > MAX_RECORDED_FRAMES) _frames.pop_front();
+    }
+
+    vkResetQueryPool(_ctx->device, _queryPool, firstQuery, slot.queryCount);
+    slot.queryCount = 0;
+    slot.scopes.clear();
+    slot.openScopes.clear();
+}
+
+
+uint32_t GpuProfiler::getScopeId(const char* name) {
+    auto [it, inserted] = _scopeIds.try_emplace(name, static_cast<uint32_t>(_scopeNames.size()));
+    if (inserted) {
+        _scopeNames.emplace_back(name);
+        _lastMs.push_back(0.0f);
+    }
+    return it->second;
+}
+
+void GpuProfiler::beginScope(VkCommandBuffer commandBuffer, const char* name) {
+    if (_queryPool == VK_NULL_HANDLE) return;
+
+    Slot& slot = _slots[_currentSlot];
+    if (slot.queryCount + 2 > 2 * MAX_SCOPES_PER_FRAME) {
+        if (!_overflowReported) {
+            spdlog::warn("GPU profiler: more than {} scopes in a frame, '{}' is not timed", MAX_SCOPES_PER_FRAME, name);
+            _overflowReported = true;
+        }
+        slot.openScopes.push_back(DROPPED_SCOPE);
+        return;
+    }
+
+    PendingScope scope{};
+    scope.nameId = getScopeId(name);
+    scope.beginQuery = 2 * MAX_SCOPES_PER_FRAME * _currentSlot + slot.queryCount;
+    scope.depth = static_cast<uint32_t>(slot.openScopes.size());
+    slot.queryCount += 2;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _queryPool, scope.beginQuery);
+    slot.openScopes.push_back(slot.scopes.size());
+    slot.scopes.push_back(scope);
+}
+
+void GpuProfiler::endScope(VkCommandBuffer commandBuffer) {
+    if (_queryPool == VK_NULL_HANDLE) return;
+
+    Slot& slot = _slots[_currentSlot];
+    if (slot.openScopes.empty()) {
+        spdlog::warn("GPU profiler: endScope without a matching beginScope");
+        return;
+    }
+    const size_t index = slot.openScopes.back();
+    slot.openScopes.pop_back();
+    if (index == DROPPED_SCOPE) return;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _queryPool, slot.scopes[index].beginQuery + 1);
+}
+
+
+float GpuProfiler::getLastTime(const std::string& name) const {
+    auto it = _scopeIds.find(name);
+    return it != _scopeIds.end() ? _lastMs[it->second] : 0.0f;
+}
+
+std::vector<GpuProfiler::ScopeStats> GpuProfiler::computeStats() const {
+    const size_t windowStart = _frames.size() > STATS_WINDOW ? _frames.size() - STATS_WINDOW : 0;
+
+    // Scope columns first, then the frame total
+    std::vector<ScopeStats> stats(_scopeNames.size() + 1);
+    std::vector<float> values;
+    values.reserve(STATS_WINDOW);
+    for (size_t column = 0; column < stats.size(); column++) {
+        const bool isTotal = column == _scopeNames.size();
+        ScopeStats& entry = stats[column];
+        entry.name = isTotal ? "Total" : _scopeNames[column];
+
+        values.clear();
+        for (size_t i = windowStart; i < _frames.size(); i++) {
+            const FrameTimings& frame = _frames[i];
+            float ms = isTotal ? frame.totalMs
+                : (column < frame.scopeMs.size() ? frame.scopeMs[column] : -1.0f);
+            if (ms >= 0.0f) values.push_back(ms);
+        }
+        if (values.empty()) continue;
+
+        entry.lastMs = values.back();
+        entry.averageMs = std::accumulate(values.begin(), values.end(), 0.0f) / static_cast<float>(values.size());
+        entry.p50Ms = percentile(values, 0.50f);
+        entry.p95Ms = percentile(values, 0.95f);
+        entry.p99Ms = percentile(values, 0.99f);
+    }
+    return stats;
+}
+
+
+bool GpuProfiler::exportFile(const std::string& path) const {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (extension == ".json") return exportJson(path);
+    if (extension == ".csv") return exportCsv(path);
+    spdlog::warn("Unsupported GPU profile format '{}' (expected .csv or .json)", path);
+    return false;
+}
+
+bool GpuProfiler::exportCsv(const std::string& path) const {
+    std::ofstream file;
+    if (createParentDirectory(path)) file.open(path);
+    if (!file.is_open()) {
+        spdlog::warn("Failed to open {} for writing", path);
+        return false;
+    }
+
+    // Missing passes are left empty, times are in milliseconds
+    file << "frame";
+    for (const auto& name : _scopeNames) file << ',' << name;
+    file << ",total\n";
+
+    for (const FrameTimings& frame : _frames) {
+        file << frame.frameNumber;
+        for (size_t i = 0; i < _scopeNames.size(); i++) {
+            file << ',';
+            if (i < frame.scopeMs.size() && frame.scopeMs[i] >= 0.0f) file << fmt::format("{:.4f}", frame.scopeMs[i]);
+        }
+        file << fmt::format(",{:.4f}\n", frame.totalMs);
+    }
+
+    spdlog::info("Exported GPU timings of {} frames to {}", _frames.size(), path);
+    return true;
+}
+
+bool GpuProfiler::exportJson(const std::string& path) const {
+    std::ofstream file;
+    if (createParentDirectory(path)) file.open(path);
+    if (!file.is_open()) {
+        spdlog::warn("Failed to open {} for writing", path);
+        return false;
+    }
+
+    // Scope names are fixed identifiers from the code, they need no escaping
+    file << "{\n  \"unit\": \"ms\",\n  \"passes\": [";
+    for (size_t i = 0; i < _scopeNames.size(); i++) {
+        file << (i ? ", " : "") << '"' << _scopeNames[i] << '"';
+    }
+    file << "],\n  \"summary\": [\n";
+    std::vector<ScopeStats> stats = computeStats();
+    for (size_t i = 0; i < stats.size(); i++) {
+        file << fmt::format("    {{ \"pass\": \"{}\", \"average\": {:.4f}, \"p50\": {:.4f}, \"p95\": {:.4f}, \"p99\": {:.4f} }}{}\n",
+            stats[i].name, stats[i].averageMs, stats[i].p50Ms, stats[i].p95Ms, stats[i].p99Ms, i + 1 < stats.size() ? "," : "");
+    }
+    file << "  ],\n  \"frames\": [\n";
+    for (size_t f = 0; f < _frames.size(); f++) {
+        const FrameTimings& frame = _frames[f];
+        file << fmt::format("    {{ \"frame\": {}, \"total\": {:.4f}", frame.frameNumber, frame.totalMs);
+        for (size_t i = 0; i < _scopeNames.size() && i < frame.scopeMs.size(); i++) {
+            if (frame.scopeMs[i] >= 0.0f) file << fmt::format(", \"{}\": {:.4f}", _scopeNames[i], frame.scopeMs[i]);
+        }
+        file << (f + 1 < _frames.size() ? " },\n" : " }\n");
+    }
+    file << "  ]\n}\n";
+
+    spdlog::info("Exported GPU timings of {} frames to {}", _frames.size(), path);
+    return true;
+}
+
+
+void GpuProfiler::calibrate() {
+    const uint32_t query = 2 * MAX_SCOPES_PER_FRAME * MAX_FRAMES_IN_FLIGHT;
+
+    // Nothing else on the queue, so the timestamp lands between the two CPU reads.
+    // The midpoint is off by at most half the submit round trip (VK_EXT_calibrated_timestamps
+    // would be exact, but is not available everywhere).
+    {
+        std::lock_guard<std::mutex> queueLock(_ctx->queueMutex);
+        vkQueueWaitIdle(_ctx->graphicsQueue);
+    }
+    vkResetQueryPool(_ctx->device, _queryPool, query, 1);
+    VkCommandBuffer commandBuffer = VulkanHelper::beginSingleTimeCommands(_ctx);
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _queryPool, query);
+    const int64_t before = CpuProfiler::now();
+    VulkanHelper::endSingleTimeCommands(_ctx, commandBuffer);
+    const int64_t after = CpuProfiler::now();
+
+    uint64_t tick = 0;
+    if (vkGetQueryPoolResults(_ctx->device, _queryPool, query, 1, sizeof(tick), &tick, sizeof(tick), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        spdlog::warn("GPU profiler: clock calibration failed, the GPU track will not line up with the CPU");
+        return;
+    }
+    _calibrationTick = tick;
+    _calibrationNs = before + (after - before) / 2;
+}
+
+std::vector<CpuProfiler::ExternalEvent> GpuProfiler::getTraceEvents() {
+    std::vector<CpuProfiler::ExternalEvent> events;
+    if (_queryPool == VK_NULL_HANDLE || _traceEvents.empty()) return events;
+
+    calibrate();
+    auto toNs = [this](uint64_t tick) {
+        const double deltaTicks = static_cast<double>(static_cast<int64_t>(tick - _calibrationTick));
+        return _calibrationNs + static_cast<int64_t>(deltaTicks * _timestampPeriod);
+    };
+
+    events.reserve(_traceEvents.size());
+    for (const TraceEvent& event : _traceEvents) {
+        events.push_back({ _scopeNames[event.nameId], "GPU", toNs(event.beginTick), toNs(event.endTick) });
+    }
+    return events;
+}
+
+bool GpuProfiler::writeChromeTrace(const std::string& path) {
+    return CpuProfiler::writeChromeTrace(path, getTraceEvents());
+}
+
+
+void GpuProfiler::buildUI() {
+    ImGui::SetNextWindowSize(ImVec2(420.0f, 0.0f), ImGuiCond_FirstUseEver);
+    ImGui::Begin(ICON_FA_STOPWATCH " GPU Profiler");
+
+    if (_queryPool == VK_NULL_HANDLE) {
+        ImGui::TextDisabled("Timestamps are not supported on this device.");
+        ImGui::End();
+        return;
+    }
+
+    std::vector<ScopeStats> stats = computeStats();
+    if (ImGui::BeginTable("##passes", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp)) {
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("Last");
+        ImGui::TableSetupColumn("Avg");
+        ImGui::TableSetupColumn("P50");
+        ImGui::TableSetupColumn("P95");
+        ImGui::TableSetupColumn("P99");
+        ImGui::TableHeadersRow();
+        for (const ScopeStats& entry : stats) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(entry.name.c_str());
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", entry.lastMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", entry.averageMs);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", entry.p50Ms);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", entry.p95Ms);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", entry.p99Ms);
+        }
+        ImGui::EndTable();
+    }
+
+    // Frame total over the statistics window
+    const size_t windowStart = _frames.size() > STATS_WINDOW ? _frames.size() - STATS_WINDOW : 0;
+    std::vector<float> totals;
+    totals.reserve(_frames.size() - windowStart);
+    for (size_t i = windowStart; i < _frames.size(); i++) totals.push_back(_frames[i].totalMs);
+    if (!totals.empty()) {
+        ImGui::PlotLines("##total", totals.data(), static_cast<int>(totals.size()), 0,
+            "GPU ms", 0.0f, std::max(stats.back().p99Ms * 1.25f, 0.1f), ImVec2(-1.0f, 60.0f));
+    }
+
+    if (ImGui::Button(ICON_FA_FILE_EXPORT " Export CSV")) {
+        _lastExportPath = fmt::format("captures/gpu_profile_{:03d}.csv", _exportCount++);
+        if (!exportCsv(_lastExportPath)) _lastExportPath.clear();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button(ICON_FA_FILE_EXPORT " Export JSON")) {
+        _lastExportPath = fmt::format("captures/gpu_profile_{:03d}.json", _exportCount++);
+        if (!exportJson(_lastExportPath)) _lastExportPath.clear();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button(ICON_FA_STREAM " Chrome Trace")) {
+        // CPU zones + GPU passes, open in chrome://tracing or ui.perfetto.dev
+        _lastExportPath = fmt::format("captures/trace_{:03d}.json", _traceCount++);
+        if (!writeChromeTrace(_lastExportPath)) _lastExportPath.clear();
+    }
+    ImGui::TextDisabled("%zu frames recorded", _frames.size());
+    if (!_lastExportPath.empty()) ImGui::TextDisabled("Saved %s", _lastExportPath.c_str());
+
+    ImGui::End();
+}
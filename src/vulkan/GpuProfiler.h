@@ -0,0 +1,137 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/VulkanContext.h"
+#include "utils/CpuProfiler.h"
+
+#include <deque>
+
+
+// GPU pass timings from timestamp queries. Every frame slot owns its own range of queries:
+// scopes are written into the current slot while recording, and the slot is read back (never
+// waited on) and host-reset once the frame pacer has retired it, so profiling does not stall.
+// Scopes may also be recorded into one-off command buffers submitted during the frame (TLAS update).
+class GpuProfiler {
+public:
+    static constexpr uint32_t MAX_SCOPES_PER_FRAME = 16;
+    static constexpr size_t STATS_WINDOW = 240;          // Frames used for averages and percentiles
+    static constexpr size_t MAX_RECORDED_FRAMES = 36000; // Frames kept for export (10 min at 60 FPS)
+    static constexpr size_t MAX_TRACE_EVENTS = 1 << 16;  // Raw scopes kept for the Chrome trace
+
+    explicit GpuProfiler(std::shared_ptr<VulkanContext> ctx);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    bool isSupported() const { return _queryPool != VK_NULL_HANDLE; }
+
+    // Reads back the frame that last used this slot and makes the slot current.
+    // Call after the slot's previous submission is known to be complete.
+    void beginFrame(uint32_t slot, uint64_t frameNumber);
+    // Reads back every slot (device must be idle)
+    void collectAll();
+
+    // Timestamps around a pass in the current slot. Both are written once all earlier work on the
+    // queue has finished, so consecutive scopes add up to the frame time.
+    void beginScope(VkCommandBuffer commandBuffer, const char* name);
+    void endScope(VkCommandBuffer commandBuffer);
+
+    // Brackets a pass for the lifetime of the object
+    class Scope {
+    public:
+        Scope(GpuProfiler* profiler, VkCommandBuffer commandBuffer, const char* name)
+            : _profiler(profiler), _commandBuffer(commandBuffer) {
+            if (_profiler) _profiler->beginScope(_commandBuffer, name);
+        }
+        ~Scope() { if (_profiler) _profiler->endScope(_commandBuffer); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        GpuProfiler* _profiler;
+        VkCommandBuffer _commandBuffer;
+    };
+
+    // Last measured duration of a scope in milliseconds (0 until it has been measured once)
+    float getLastTime(const std::string& name) const;
+
+    struct ScopeStats {
+        std::string name;
+        float lastMs = 0.0f;
+        float averageMs = 0.0f;
+        float p50Ms = 0.0f;
+        float p95Ms = 0.0f;
+        float p99Ms = 0.0f;
+    };
+    // Over the last STATS_WINDOW frames, in first-seen scope order, followed by the frame total
+    std::vector<ScopeStats> computeStats() const;
+
+    // Per-frame timings (one row / object per frame, one column / key per scope).
+    // The format follows the extension of path (.csv or .json).
+    bool exportFile(const std::string& path) const;
+    bool exportCsv(const std::string& path) const;
+    bool exportJson(const std::string& path) const;
+
+    // Recent scopes on the CPU steady clock, for CpuProfiler::writeChromeTrace. Recalibrates the GPU
+    // clock against the CPU clock first, which drains the graphics queue.
+    std::vector<CpuProfiler::ExternalEvent> getTraceEvents();
+    // CPU zones and GPU passes in one Chrome trace
+    bool writeChromeTrace(const std::string& path);
+
+    void buildUI();
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+    VkQueryPool _queryPool = VK_NULL_HANDLE;
+    float _timestampPeriod = 1.0f;    // Nanoseconds per tick
+
+    // Scopes recorded into a slot, waiting for their results
+    struct PendingScope {
+        uint32_t nameId;
+        uint32_t beginQuery;
+        uint32_t depth;       // Nesting level, only top-level scopes count towards the frame total
+    };
+    struct Slot {
+        uint64_t frameNumber = 0;
+        uint32_t queryCount = 0;
+        std::vector<PendingScope> scopes;
+        std::vector<size_t> openScopes;    // Indices into scopes, innermost last
+    };
+    std::array<Slot, MAX_FRAMES_IN_FLIGHT> _slots;
+    uint32_t _currentSlot = 0;
+    bool _overflowReported = false;
+    void readSlot(uint32_t slot);
+
+    // Scope names in first-seen order (column order of the exports)
+    std::vector<std::string> _scopeNames;
+    std::unordered_map<std::string, uint32_t> _scopeIds;
+    uint32_t getScopeId(const char* name);
+
+    // Measured frames, oldest first. Scopes missing from a frame are negative.
+    struct FrameTimings {
+        uint64_t frameNumber;
+        float totalMs;
+        std::vector<float> scopeMs;
+    };
+    std::deque<FrameTimings> _frames;
+    std::vector<float> _lastMs;
+
+    // Raw scopes for the trace timeline
+    struct TraceEvent {
+        uint32_t nameId;
+        uint64_t beginTick;
+        uint64_t endTick;
+    };
+    std::deque<TraceEvent> _traceEvents;
+
+    // GPU tick matching a CPU steady clock time, measured with a timestamp in a one-off submit.
+    // (The last query of the pool is reserved for it.)
+    uint64_t _calibrationTick = 0;
+    int64_t _calibrationNs = 0;
+    void calibrate();
+
+    // UI
+    uint32_t _exportCount = 0;
+    uint32_t _traceCount = 0;
+    std::string _lastExportPath;
+};
@@ -14,7 +14,7 @@ struct InstanceData {
     float transparency;            // Transparency (0 = opaque, 1 = fully transparent)
     float ior;                     // Index of refraction (e.g., 1.5 for glass, 1.33 for water)
     glm::vec3 absorbance;          // Used for translucent objects (Beer-Lambert law)
-    float pad;
+    float emissionStrength;        // Radiance scale for emissive materials
 };
 
 static_assert(sizeof(InstanceData) % 16 == 0, "InstanceData size must be multiple of 16 bytes");
@@ -0,0 +1,32 @@
+#pragma once
+#include "stdafx.h"
+
+// World space triangle of an emissive instance, stored on GPU for light sampling.
+// Entries double as an alias table (see AliasTable) over the emitted power of the triangles.
+struct EmissiveTriangle {
+    glm::vec3 p0; float pdf;              // Selection probability (power / total power)
+    glm::vec3 p1; float aliasProbability; // Chance to keep this entry when its bucket is picked
+    glm::vec3 p2; uint32_t alias;         // Entry taken otherwise
+    glm::vec3 emission; float area;       // Emitted radiance, world space area
+};
+
+static_assert(sizeof(EmissiveTriangle) % 16 == 0, "EmissiveTriangle size must be multiple of 16 bytes");
+
+// Header of the environment map buffer, followed by width * height EnvironmentTexel entries
+struct EnvironmentHeader {
+    uint32_t width;
+    uint32_t height;
+    float weightSum;                 // Sum of luminance * sin(theta) over all texels (0 = no environment)
+    uint32_t pad;
+};
+
+// Equirectangular environment texel, entries double as an alias table over luminance * sin(theta)
+struct EnvironmentTexel {
+    uint32_t radianceRG;             // Half floats (packHalf2x16)
+    uint32_t radianceB;              // Half float in the low bits
+    float aliasProbability;          // Chance to keep this entry when its bucket is picked
+    uint32_t alias;                  // Entry taken otherwise
+};
+
+static_assert(sizeof(EnvironmentHeader) == 16, "EnvironmentHeader must be 16 bytes");
+static_assert(sizeof(EnvironmentTexel) == 16, "EnvironmentTexel must be 16 bytes");
@@ -0,0 +1,380 @@
+#include "vulkan/MemoryAllocator.h"
+
+
+const char* toString(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::Geometry:              return "Geometry";
+        case MemoryCategory::AccelerationStructure: return "Acceleration structures";
+        case MemoryCategory::Image:                 return "Images";
+        case MemoryCategory::Scratch:               return "Scratch";
+        case MemoryCategory::Other:                 return "Other";
+        default:                                    return "Unknown";
+    }
+}
+
+
+MemoryAllocator::MemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, bool deviceAddress, bool memoryBudget)
+    : _physicalDevice(physicalDevice), _device(device), _deviceAddress(deviceAddress), _memoryBudget(memoryBudget)
+{
+    vkGetPhysicalDeviceMemoryProperties(_physicalDevice, &_memoryProperties);
+    _pools.resize(_memoryProperties.memoryTypeCount * 2);
+    updateBudget();
+}
+
+MemoryAllocator::~MemoryAllocator() {
+    // Owners free their allocations first, anything left here is a leak
+    Stats total = getTotalStats();
+    if (total.allocationCount > 0 || total.dedicatedCount > 0) {
+        spdlog::warn("Memory allocator destroyed with {} suballocations and {} dedicated allocations alive",
+            total.allocationCount, total.dedicatedCount);
+    }
+
+    for (Pool& pool : _pools) {
+        for (auto& block : pool.blocks) {
+            if (block) vkFreeMemory(_device, block->memory, nullptr);
+        }
+    }
+}
+
+
+MemoryAllocator::Allocation MemoryAllocator::allocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, MemoryCategory category) {
+    VkBufferMemoryRequirementsInfo2 info{};
+    info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+    info.buffer = buffer;
+
+    VkMemoryDedicatedRequirements dedicatedRequirements{};
+    dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicatedRequirements;
+    vkGetBufferMemoryRequirements2(_device, &info, &requirements);
+
+    const bool dedicated = dedicatedRequirements.requiresDedicatedAllocation || dedicatedRequirements.prefersDedicatedAllocation;
+    Allocation allocation = allocate(requirements.memoryRequirements, properties, false, dedicated, { buffer, VK_NULL_HANDLE });
+    addToCategory(allocation, category);
+
+    if (vkBindBufferMemory(_device, buffer, allocation.memory, allocation.offset) != VK_SUCCESS) {
+        free(allocation);
+        spdlog::error("Failed to bind buffer memory!");
+        throw std::runtime_error("Failed to bind buffer memory!");
+    }
+    return allocation;
+}
+
+MemoryAllocator::Allocation MemoryAllocator::allocateForImage(VkImage image, VkMemoryPropertyFlags properties, bool linearTiling) {
+    VkImageMemoryRequirementsInfo2 info{};
+    info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+    info.image = image;
+
+    VkMemoryDedicatedRequirements dedicatedRequirements{};
+    dedicatedRequirements.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    requirements.pNext = &dedicatedRequirements;
+    vkGetImageMemoryRequirements2(_device, &info, &requirements);
+
+    const bool dedicated = dedicatedRequirements.requiresDedicatedAllocation || dedicatedRequirements.prefersDedicatedAllocation
+        || requirements.memoryRequirements.size >= DEDICATED_IMAGE_SIZE;
+    Allocation allocation = allocate(requirements.memoryRequirements, properties, !linearTiling, dedicated, { VK_NULL_HANDLE, image });
+    addToCategory(allocation, MemoryCategory::Image);
+
+    if (vkBindImageMemory(_device, image, allocation.memory, allocation.offset) != VK_SUCCESS) {
+        free(allocation);
+        spdlog::error("Failed to bind image memory!");
+        throw std::runtime_error("Failed to bind image memory!");
+    }
+    return allocation;
+}
+
+
+MemoryAllocator::Allocation MemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+    bool optimalImage, bool dedicated, DedicatedTarget target)
+{
+    const uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+    const uint32_t poolIndex = memoryType * 2 + (optimalImage ? 1 : 0);
+
+    // Resources over half a block would leave most of it unusable
+    if (dedicated || requirements.size > BLOCK_SIZE / 2) return allocateDedicated(requirements, memoryType, poolIndex, target);
+
+    // Smallest power of two node that fits size and alignment (nodes are aligned to their size)
+    uint32_t level = LEVEL_COUNT - 1;
+    while (level > 0 && (levelSize(level) < requirements.size || levelSize(level) < requirements.alignment)) level--;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    Pool& pool = _pools[poolIndex];
+
+    Allocation allocation;
+    allocation.pool = poolIndex;
+    allocation.level = level;
+    allocation.size = requirements.size;
+
+    auto fill = [&](Block& block, uint32_t blockIndex) {
+        allocation.memory = block.memory;
+        allocation.block = blockIndex;
+        allocation.mapped = block.mapped ? static_cast<char*>(block.mapped) + allocation.offset : nullptr;
+        block.allocationCount++;
+        block.usedBytes += requirements.size;
+        block.nodeBytes += levelSize(level);
+        return allocation;
+    };
+
+    for (uint32_t i = 0; i < pool.blocks.size(); i++) {
+        if (pool.blocks[i] && suballocate(*pool.blocks[i], level, allocation.offset)) return fill(*pool.blocks[i], i);
+    }
+
+    // Every block is full, add one (reusing the slot of a released block)
+    auto block = std::make_unique<Block>();
+    block->memory = allocateMemory(BLOCK_SIZE, memoryType, {}, &block->mapped);
+    if (block->memory == VK_NULL_HANDLE) {
+        // The heap may still fit the resource on its own
+        spdlog::warn("Failed to allocate a {} MiB block of memory type {}, falling back to a dedicated allocation",
+            BLOCK_SIZE >> 20, memoryType);
+        lock.unlock();
+        return allocateDedicated(requirements, memoryType, poolIndex, target);
+    }
+    block->freeLists[0].insert(0);
+    spdlog::debug("Allocated {} MiB block of memory type {} ({})", BLOCK_SIZE >> 20, memoryType, optimalImage ? "images" : "buffers");
+
+    auto slot = std::find(pool.blocks.begin(), pool.blocks.end(), nullptr);
+    if (slot == pool.blocks.end()) slot = pool.blocks.insert(slot, nullptr);
+    *slot = std::move(block);
+
+    const uint32_t blockIndex = static_cast<uint32_t>(slot - pool.blocks.begin());
+    suballocate(*pool.blocks[blockIndex], level, allocation.offset);
+    return fill(*pool.blocks[blockIndex], blockIndex);
+}
+
+MemoryAllocator::Allocation MemoryAllocator::allocateDedicated(const VkMemoryRequirements& requirements, uint32_t memoryType,
+    uint32_t poolIndex, DedicatedTarget target)
+{
+    Allocation allocation;
+    allocation.memory = allocateMemory(requirements.size, memoryType, target, &allocation.mapped);
+    if (allocation.memory == VK_NULL_HANDLE) {
+        spdlog::error("Failed to allocate {} bytes of device memory (memory type {})!", requirements.size, memoryType);
+        throw std::runtime_error("Failed to allocate device memory!");
+    }
+    allocation.size = requirements.size;
+    allocation.pool = poolIndex;
+    allocation.block = Allocation::DEDICATED;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pools[poolIndex].dedicatedCount++;
+    _pools[poolIndex].dedicatedBytes += requirements.size;
+    return allocation;
+}
+
+void MemoryAllocator::addToCategory(Allocation& allocation, MemoryCategory category) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    allocation.category = category;
+    _categoryBytes[static_cast<size_t>(category)] += allocation.size;
+}
+
+bool MemoryAllocator::suballocate(Block& block, uint32_t level, VkDeviceSize& offset) {
+    // Smallest free node at or above the requested size
+    uint32_t freeLevel = level;
+    while (block.freeLists[freeLevel].empty()) {
+        if (freeLevel == 0) return false;
+        freeLevel--;
+    }
+
+    offset = *block.freeLists[freeLevel].begin();
+    block.freeLists[freeLevel].erase(block.freeLists[freeLevel].begin());
+
+    // Split it down, the upper halves become free buddies
+    while (freeLevel < level) {
+        freeLevel++;
+        block.freeLists[freeLevel].insert(offset + levelSize(freeLevel));
+    }
+    return true;
+}
+
+void MemoryAllocator::free(Allocation& allocation) {
+    if (allocation.memory == VK_NULL_HANDLE) return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Pool& pool = _pools[allocation.pool];
+    _categoryBytes[static_cast<size_t>(allocation.category)] -= allocation.size;
+
+    if (allocation.block == Allocation::DEDICATED) {
+        vkFreeMemory(_device, allocation.memory, nullptr);
+        pool.dedicatedCount--;
+        pool.dedicatedBytes -= allocation.size;
+        allocation = Allocation{};
+        return;
+    }
+
+    Block& block = *pool.blocks[allocation.block];
+    block.allocationCount--;
+    block.usedBytes -= allocation.size;
+    block.nodeBytes -= levelSize(allocation.level);
+
+    // Merge with the buddy as long as it is free as well
+    VkDeviceSize offset = allocation.offset;
+    uint32_t level = allocation.level;
+    while (level > 0) {
+        auto buddy = block.freeLists[level].find(offset ^ levelSize(level));
+        if (buddy == block.freeLists[level].end()) break;
+        offset = std::min(offset, *buddy);
+        block.freeLists[level].erase(buddy);
+        level--;
+    }
+    block.freeLists[level].insert(offset);
+
+    // Give empty blocks back to the driver, but keep one per pool for the next allocation
+    if (block.allocationCount == 0) {
+        size_t liveBlocks = std::count_if(pool.blocks.begin(), pool.blocks.end(), [](const auto& b) { return b != nullptr; });
+        if (liveBlocks > 1) {
+            vkFreeMemory(_device, block.memory, nullptr);
+            pool.blocks[allocation.block].reset();
+        }
+    }
+    allocation = Allocation{};
+}
+
+
+VkDeviceMemory MemoryAllocator::allocateMemory(VkDeviceSize size, uint32_t memoryType, DedicatedTarget target, void** mapped) {
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    VkMemoryDedicatedAllocateInfo dedicatedInfo{};
+    dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    dedicatedInfo.buffer = target.buffer;
+    dedicatedInfo.image = target.image;
+    if (target.buffer || target.image) {
+        dedicatedInfo.pNext = allocInfo.pNext;
+        allocInfo.pNext = &dedicatedInfo;
+    }
+
+    // Device addresses are only queried for buffers, but any block may end up holding one
+    VkMemoryAllocateFlagsInfo allocFlagsInfo{};
+    allocFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    if (_deviceAddress && !target.image) {
+        allocFlagsInfo.pNext = allocInfo.pNext;
+        allocInfo.pNext = &allocFlagsInfo;
+    }
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (vkAllocateMemory(_device, &allocInfo, nullptr, &memory) != VK_SUCCESS) return VK_NULL_HANDLE;
+
+    *mapped = nullptr;
+    if (_memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        vkMapMemory(_device, memory, 0, VK_WHOLE_SIZE, 0, mapped);
+    }
+    return memory;
+}
+
+uint32_t MemoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < _memoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) && (_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    spdlog::error("Failed to find suitable memory type!");
+    throw std::runtime_error("Failed to find suitable memory type!");
+}
+
+
+std::vector<MemoryAllocator::Stats> MemoryAllocator::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<Stats> stats;
+    for (uint32_t poolIndex = 0; poolIndex < _pools.size(); poolIndex++) {
+        const Pool& pool = _pools[poolIndex];
+        const uint32_t memoryType = poolIndex / 2;
+        if (pool.dedicatedCount == 0 && std::all_of(pool.blocks.begin(), pool.blocks.end(), [](const auto& b) { return b == nullptr; })) continue;
+
+        if (stats.empty() || stats.back().memoryType != memoryType) {
+            stats.push_back(Stats{});
+            stats.back().memoryType = memoryType;
+        }
+        Stats& entry = stats.back();
+        entry.dedicatedCount += pool.dedicatedCount;
+        entry.dedicatedBytes += pool.dedicatedBytes;
+
+        for (const auto& block : pool.blocks) {
+            if (!block) continue;
+            entry.blockCount++;
+            entry.allocationCount += block->allocationCount;
+            entry.blockBytes += BLOCK_SIZE;
+            entry.usedBytes += block->usedBytes;
+            entry.nodeBytes += block->nodeBytes;
+            for (uint32_t level = 0; level < LEVEL_COUNT; level++) {
+                if (!block->freeLists[level].empty()) {
+                    entry.largestFreeBytes = std::max(entry.largestFreeBytes, levelSize(level));
+                    break;
+                }
+            }
+        }
+    }
+    return stats;
+}
+
+MemoryAllocator::Stats MemoryAllocator::getTotalStats() const {
+    Stats total;
+    for (const Stats& entry : getStats()) {
+        total.blockCount += entry.blockCount;
+        total.allocationCount += entry.allocationCount;
+        total.dedicatedCount += entry.dedicatedCount;
+        total.blockBytes += entry.blockBytes;
+        total.usedBytes += entry.usedBytes;
+        total.nodeBytes += entry.nodeBytes;
+        total.dedicatedBytes += entry.dedicatedBytes;
+        total.largestFreeBytes = std::max(total.largestFreeBytes, entry.largestFreeBytes);
+    }
+    return total;
+}
+
+std::array<VkDeviceSize, static_cast<size_t>(MemoryCategory::Count)> MemoryAllocator::getCategoryBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _categoryBytes;
+}
+
+
+void MemoryAllocator::updateBudget() {
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    if (_memoryBudget) {
+        VkPhysicalDeviceMemoryProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties.pNext = &budgetProperties;
+        vkGetPhysicalDeviceMemoryProperties2(_physicalDevice, &properties);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _heapBudgets.assign(_memoryProperties.memoryHeapCount, HeapBudget{});
+    for (uint32_t heap = 0; heap < _memoryProperties.memoryHeapCount; heap++) {
+        HeapBudget& entry = _heapBudgets[heap];
+        entry.heap = heap;
+        entry.size = _memoryProperties.memoryHeaps[heap].size;
+        entry.deviceLocal = (_memoryProperties.memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    }
+
+    for (uint32_t poolIndex = 0; poolIndex < _pools.size(); poolIndex++) {
+        const Pool& pool = _pools[poolIndex];
+        HeapBudget& entry = _heapBudgets[_memoryProperties.memoryTypes[poolIndex / 2].heapIndex];
+        entry.allocatorBytes += pool.dedicatedBytes;
+        for (const auto& block : pool.blocks) {
+            if (block) entry.allocatorBytes += BLOCK_SIZE;
+        }
+    }
+
+    for (HeapBudget& entry : _heapBudgets) {
+        if (_memoryBudget) {
+            entry.budget = budgetProperties.heapBudget[entry.heap];
+            entry.usage = budgetProperties.heapUsage[entry.heap];
+        } else {
+            // Without the extension only our own memory is known
+            entry.budget = entry.size;
+            entry.usage = entry.allocatorBytes;
+        }
+    }
+}
+
+std::vector<MemoryAllocator::HeapBudget> MemoryAllocator::getHeapBudgets() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _heapBudgets;
+}
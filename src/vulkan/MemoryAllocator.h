@@ -0,0 +1,139 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <mutex>
+
+
+// What an allocation is used for, only for accounting
+enum class MemoryCategory : uint32_t {
+    Geometry = 0,               // Vertex / index / transform / AS instance buffers
+    AccelerationStructure = 1,
+    Image = 2,
+    Scratch = 3,                // Acceleration structure build scratch
+    Other = 4,                  // Uniforms, tables, shader binding tables, staging
+    Count
+};
+
+const char* toString(MemoryCategory category);
+
+
+// Device memory suballocator. Every memory type gets pools of large blocks that are split with a
+// buddy allocator (power of two nodes, so any alignment up to the node size comes for free).
+// Buffers / linear images and optimal images live in separate pools, which keeps them apart by
+// more than bufferImageGranularity. Big resources and ones the driver wants alone get dedicated
+// allocations. Host visible blocks stay mapped for their lifetime. Thread safe.
+class MemoryAllocator {
+public:
+    static constexpr VkDeviceSize BLOCK_SIZE = 64ull << 20;           // 64 MiB
+    static constexpr VkDeviceSize MIN_NODE_SIZE = 256;                // Smallest suballocation
+    static constexpr VkDeviceSize DEDICATED_IMAGE_SIZE = 8ull << 20;  // Images at least this big get their own memory
+    static constexpr uint32_t LEVEL_COUNT = 19;                       // log2(BLOCK_SIZE / MIN_NODE_SIZE) + 1
+
+    // deviceAddress: blocks are allocated with VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT
+    // memoryBudget: VK_EXT_memory_budget is enabled on the device
+    MemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device, bool deviceAddress, bool memoryBudget);
+    ~MemoryAllocator();
+
+    MemoryAllocator(const MemoryAllocator&) = delete;
+    MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+    struct Allocation {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;      // Requested size
+        void* mapped = nullptr;     // Host visible memory only
+        MemoryCategory category = MemoryCategory::Other;
+
+        // Bookkeeping for free()
+        uint32_t pool = 0;
+        uint32_t block = DEDICATED;
+        uint32_t level = 0;
+        static constexpr uint32_t DEDICATED = UINT32_MAX;
+    };
+
+    // Allocate memory for the resource and bind it, throws if no memory is left
+    Allocation allocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, MemoryCategory category = MemoryCategory::Other);
+    Allocation allocateForImage(VkImage image, VkMemoryPropertyFlags properties, bool linearTiling = false);
+    // Resets the allocation, no-op for empty ones
+    void free(Allocation& allocation);
+
+    struct Stats {
+        uint32_t memoryType = 0;
+        uint32_t blockCount = 0;
+        uint32_t allocationCount = 0;
+        uint32_t dedicatedCount = 0;
+        VkDeviceSize blockBytes = 0;        // Reserved in blocks
+        VkDeviceSize usedBytes = 0;         // Requested by suballocations
+        VkDeviceSize nodeBytes = 0;         // Taken by suballocations (power of two nodes)
+        VkDeviceSize dedicatedBytes = 0;
+        VkDeviceSize largestFreeBytes = 0;  // Biggest node that could still be handed out
+
+        VkDeviceSize freeBytes() const { return blockBytes - nodeBytes; }
+        // 0 = all free space in one node, towards 1 = free space scattered over small nodes
+        float fragmentation() const { return freeBytes() > 0 ? 1.0f - float(largestFreeBytes) / float(freeBytes()) : 0.0f; }
+        // Lost to rounding up to power of two nodes
+        VkDeviceSize wastedBytes() const { return nodeBytes - usedBytes; }
+    };
+    // One entry per memory type in use
+    std::vector<Stats> getStats() const;
+    Stats getTotalStats() const;
+
+    // Requested bytes per category (live allocations of this allocator)
+    std::array<VkDeviceSize, static_cast<size_t>(MemoryCategory::Count)> getCategoryBytes() const;
+
+    struct HeapBudget {
+        uint32_t heap = 0;
+        bool deviceLocal = false;
+        VkDeviceSize size = 0;
+        VkDeviceSize budget = 0;        // What the process can use before the driver starts paging (heap size without the extension)
+        VkDeviceSize usage = 0;         // Whole process (only this allocator's blocks and dedicated memory without the extension)
+        VkDeviceSize allocatorBytes = 0;
+    };
+    // Queries the budgets again, meant to be called once per frame (they change with other processes)
+    void updateBudget();
+    // Per heap, as of the last updateBudget()
+    std::vector<HeapBudget> getHeapBudgets() const;
+    bool hasMemoryBudget() const { return _memoryBudget; }
+
+private:
+    VkPhysicalDevice _physicalDevice;
+    VkDevice _device;
+    bool _deviceAddress;
+    bool _memoryBudget;
+    VkPhysicalDeviceMemoryProperties _memoryProperties{};
+
+    struct Block {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void* mapped = nullptr;
+        std::array<std::set<VkDeviceSize>, LEVEL_COUNT> freeLists;  // Free node offsets, level 0 = whole block
+        uint32_t allocationCount = 0;
+        VkDeviceSize usedBytes = 0;
+        VkDeviceSize nodeBytes = 0;
+    };
+
+    // Pool index = memoryType * 2 + (optimal image ? 1 : 0)
+    struct Pool {
+        std::vector<std::unique_ptr<Block>> blocks;   // Released blocks leave a null slot
+        uint32_t dedicatedCount = 0;
+        VkDeviceSize dedicatedBytes = 0;
+    };
+    std::vector<Pool> _pools;
+    std::array<VkDeviceSize, static_cast<size_t>(MemoryCategory::Count)> _categoryBytes{};
+    std::vector<HeapBudget> _heapBudgets;
+    mutable std::mutex _mutex;
+
+    struct DedicatedTarget {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkImage image = VK_NULL_HANDLE;
+    };
+    Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+        bool optimalImage, bool dedicated, DedicatedTarget target);
+    Allocation allocateDedicated(const VkMemoryRequirements& requirements, uint32_t memoryType, uint32_t pool, DedicatedTarget target);
+    bool suballocate(Block& block, uint32_t level, VkDeviceSize& offset);
+    VkDeviceMemory allocateMemory(VkDeviceSize size, uint32_t memoryType, DedicatedTarget target, void** mapped);
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    void addToCategory(Allocation& allocation, MemoryCategory category);
+
+    static VkDeviceSize levelSize(uint32_t level) { return BLOCK_SIZE >> level; }
+};
@@ -1,16 +1,36 @@
 #include "vulkan/RayTracingPipeline.h"
 #include "vulkan/VulkanRT.h"
 
+
+namespace {
+    // Destroys the shader modules once the pipeline is created, or when creation throws
+    struct ShaderModuleSet {
+        VkDevice device;
+        std::vector<VkShaderModule> modules;
+
+        ~ShaderModuleSet() {
+            for (VkShaderModule module : modules) vkDestroyShaderModule(device, module, nullptr);
+        }
+    };
+}
+
 RayTracingPipeline::RayTracingPipeline(std::shared_ptr<VulkanContext> ctx,
     const std::string& raygenShaderPath,
     const std::vector<std::string>& missShaderPaths,
-    const std::string& closestHitShaderPath,
+    const std::vector<std::string>& closestHitShaderPaths,
     const std::string& anyHitShaderPath,
     const RayTracingPipelineParams& params)
     : _ctx(std::move(ctx)), _name(params.name)
 {
     createPipelineLayout(params);
-    createRayTracingPipeline(raygenShaderPath, missShaderPaths, closestHitShaderPath, anyHitShaderPath, params);
+    try {
+        createRayTracingPipeline(raygenShaderPath, missShaderPaths, closestHitShaderPaths, anyHitShaderPath, params);
+    } catch (...) {
+        // Failed builds are recovered from (variant builds, hot reload), the destructor won't run
+        vkDestroyPipelineLayout(_ctx->device, _pipelineLayout, nullptr);
+        _pipelineLayout = VK_NULL_HANDLE;
+        throw;
+    }
 }
 
 
@@ -29,6 +49,11 @@ RayTracingPipeline::~RayTracingPipeline()
 
 void RayTracingPipeline::createPipelineLayout(const RayTracingPipelineParams& params)
 {
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = params.pushConstantStages;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = params.pushConstantSize;
+
     // Create the pipeline layout with the descriptor set layout
     VkPipelineLayoutCreateInfo pipelineLayoutCI{};
     pipelineLayoutCI.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -36,8 +61,8 @@ void RayTracingPipeline::createPipelineLayout(const RayTracingPipelineParams& pa
     pipelineLayoutCI.flags = 0;
     pipelineLayoutCI.setLayoutCount = static_cast<uint32_t>(params.descriptorSetLayouts.size());
     pipelineLayoutCI.pSetLayouts = params.descriptorSetLayouts.empty() ? nullptr : params.descriptorSetLayouts.data();
-    pipelineLayoutCI.pushConstantRangeCount = 0;
-    pipelineLayoutCI.pPushConstantRanges = nullptr;
+    pipelineLayoutCI.pushConstantRangeCount = params.pushConstantSize > 0 ? 1 : 0;
+    pipelineLayoutCI.pPushConstantRanges = params.pushConstantSize > 0 ? &pushConstantRange : nullptr;
     if (vkCreatePipelineLayout(_ctx->device, &pipelineLayoutCI, nullptr, &_pipelineLayout) != VK_SUCCESS) {
         spdlog::error("Failed to create pipeline layout!");
         throw std::runtime_error("Failed to create pipeline layout!");
@@ -48,7 +73,7 @@ void RayTracingPipeline::createPipelineLayout(const RayTracingPipelineParams& pa
 void RayTracingPipeline::createRayTracingPipeline(
     const std::string& raygenShaderPath,
     const std::vector<std::string>& missShaderPaths,
-    const std::string& closestHitShaderPath,
+    const std::vector<std::string>& closestHitShaderPaths,
     const std::string& anyHitShaderPath,
     const RayTracingPipelineParams& params)
 {
@@ -65,26 +90,45 @@ void RayTracingPipeline::createRayTracingPipeline(
         missShaderCodes.push_back(readBinaryFile(missPath));
     }
 
-    // Load closest hit shader
-    auto closestHitShaderCode = readBinaryFile(closestHitShaderPath);
+    // Load closest hit shaders (one per hit group)
+    std::vector<std::vector<char>> closestHitShaderCodes;
+    for (const auto& closestHitPath : closestHitShaderPaths) {
+        closestHitShaderCodes.push_back(readBinaryFile(closestHitPath));
+    }
 
     // Load any hit shader
     auto anyHitShaderCode = readBinaryFile(anyHitShaderPath);
 
-    // Create shader modules
-    VkShaderModule raygenShaderModule = createShaderModule(raygenShaderCode);
+    // Create shader modules, every module is owned by the set as soon as it exists
+    ShaderModuleSet moduleSet{ _ctx->device, {} };
+    auto createOwnedShaderModule = [&](const std::vector<char>& code) {
+        moduleSet.modules.push_back(createShaderModule(code));
+        return moduleSet.modules.back();
+    };
+    VkShaderModule raygenShaderModule = createOwnedShaderModule(raygenShaderCode);
 
     // Create miss shader modules
     std::vector<VkShaderModule> missShaderModules;
     for (const auto& code : missShaderCodes) {
-        missShaderModules.push_back(createShaderModule(code));
+        missShaderModules.push_back(createOwnedShaderModule(code));
     }
 
-    // Create closest hit shader module
-    VkShaderModule closestHitShaderModule = createShaderModule(closestHitShaderCode);
+    // Create closest hit shader modules
+    std::vector<VkShaderModule> closestHitShaderModules;
+    for (const auto& code : closestHitShaderCodes) {
+        closestHitShaderModules.push_back(createOwnedShaderModule(code));
+    }
 
     // Create any hit shader module
-    VkShaderModule anyHitShaderModule = createShaderModule(anyHitShaderCode);
+    VkShaderModule anyHitShaderModule = createOwnedShaderModule(anyHitShaderCode);
+
+    // Specialization constants shared by all stages
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = static_cast<uint32_t>(params.specializationEntries.size());
+    specializationInfo.pMapEntries = params.specializationEntries.data();
+    specializationInfo.dataSize = params.specializationData.size();
+    specializationInfo.pData = params.specializationData.data();
+    const VkSpecializationInfo* pSpecializationInfo = params.specializationEntries.empty() ? nullptr : &specializationInfo;
 
     // Ray generation group
     {
@@ -94,6 +138,7 @@ void RayTracingPipeline::createRayTracingPipeline(
         raygenShaderStageInfo.stage = VK_SHADER_STAGE_RAYGEN_BIT_KHR;
         raygenShaderStageInfo.module = raygenShaderModule;
         raygenShaderStageInfo.pName = "main";
+        raygenShaderStageInfo.pSpecializationInfo = pSpecializationInfo;
 
         shaderStages.push_back(raygenShaderStageInfo);
         VkRayTracingShaderGroupCreateInfoKHR shaderGroup{};
@@ -113,6 +158,7 @@ void RayTracingPipeline::createRayTracingPipeline(
         missShaderStageInfo.stage = VK_SHADER_STAGE_MISS_BIT_KHR;
         missShaderStageInfo.module = missShaderModules[i];
         missShaderStageInfo.pName = "main";
+        missShaderStageInfo.pSpecializationInfo = pSpecializationInfo;
 
         shaderStages.push_back(missShaderStageInfo);
         VkRayTracingShaderGroupCreateInfoKHR shaderGroup{};
@@ -125,32 +171,38 @@ void RayTracingPipeline::createRayTracingPipeline(
         _shaderGroups.push_back(shaderGroup);
     }
 
-    // Closest hit group
+    // Hit groups (one per closest hit shader, all sharing the same any hit shader)
     {
-        // Closest hit shader stage info
-        VkPipelineShaderStageCreateInfo closestHitShaderStageInfo{};
-        closestHitShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        closestHitShaderStageInfo.stage = VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
-        closestHitShaderStageInfo.module = closestHitShaderModule;
-        closestHitShaderStageInfo.pName = "main";
-        shaderStages.push_back(closestHitShaderStageInfo);
-
-        // Any hit shader stage info
+        // Any hit shader stage info (shared)
         VkPipelineShaderStageCreateInfo anyHitShaderStageInfo{};
         anyHitShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         anyHitShaderStageInfo.stage = VK_SHADER_STAGE_ANY_HIT_BIT_KHR;
         anyHitShaderStageInfo.module = anyHitShaderModule;
         anyHitShaderStageInfo.pName = "main";
+        anyHitShaderStageInfo.pSpecializationInfo = pSpecializationInfo;
         shaderStages.push_back(anyHitShaderStageInfo);
-
-        VkRayTracingShaderGroupCreateInfoKHR shaderGroup{};
-        shaderGroup.sType = VK_STRUCTURE_TYPE_RAY_TRACING_SHADER_GROUP_CREATE_INFO_KHR;
-        shaderGroup.type = VK_RAY_TRACING_SHADER_GROUP_TYPE_TRIANGLES_HIT_GROUP_KHR;
-        shaderGroup.generalShader = VK_SHADER_UNUSED_KHR;
-        shaderGroup.closestHitShader = static_cast<uint32_t>(shaderStages.size()) - 2;
-        shaderGroup.anyHitShader = static_cast<uint32_t>(shaderStages.size()) - 1;
-        shaderGroup.intersectionShader = VK_SHADER_UNUSED_KHR;
-        _shaderGroups.push_back(shaderGroup);
+        const uint32_t anyHitStageIndex = static_cast<uint32_t>(shaderStages.size()) - 1;
+
+        for (size_t i = 0; i < closestHitShaderModules.size(); i++) {
+            // Closest hit shader stage info
+            VkPipelineShaderStageCreateInfo closestHitShaderStageInfo{};
+            closestHitShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            closestHitShaderStageInfo.stage = VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+            closestHitShaderStageInfo.module = closestHitShaderModules[i];
+            closestHitShaderStageInfo.pName = "main";
+            closestHitShaderStageInfo.pSpecializationInfo = pSpecializationInfo;
+            shaderStages.push_back(closestHitShaderStageInfo);
+
+            VkRayTracingShaderGroupCreateInfoKHR shaderGroup{};
+            shaderGroup.sType = VK_STRUCTURE_TYPE_RAY_TRACING_SHADER_GROUP_CREATE_INFO_KHR;
+            shaderGroup.type = VK_RAY_TRACING_SHADER_GROUP_TYPE_TRIANGLES_HIT_GROUP_KHR;
+            shaderGroup.generalShader = VK_SHADER_UNUSED_KHR;
+            shaderGroup.closestHitShader = static_cast<uint32_t>(shaderStages.size()) - 1;
+            shaderGroup.anyHitShader = anyHitStageIndex;
+            shaderGroup.intersectionShader = VK_SHADER_UNUSED_KHR;
+            _shaderGroups.push_back(shaderGroup);
+        }
+        _hitGroupCount = static_cast<uint32_t>(closestHitShaderModules.size());
     }
 
     // Create the ray tracing pipeline
@@ -162,24 +214,22 @@ void RayTracingPipeline::createRayTracingPipeline(
     rayTracingPipelineCI.pStages = shaderStages.data();
     rayTracingPipelineCI.groupCount = static_cast<uint32_t>(_shaderGroups.size());
     rayTracingPipelineCI.pGroups = _shaderGroups.data();
-    rayTracingPipelineCI.maxPipelineRayRecursionDepth = 8;  // Max Recursive ray casts
+    rayTracingPipelineCI.maxPipelineRayRecursionDepth = params.maxRecursionDepth;  // Max Recursive ray casts
     rayTracingPipelineCI.layout = _pipelineLayout;
     rayTracingPipelineCI.basePipelineHandle = VK_NULL_HANDLE;
     rayTracingPipelineCI.basePipelineIndex = -1;
 
-    if (vkrt::vkCreateRayTracingPipelinesKHR(_ctx->device, VK_NULL_HANDLE, VK_NULL_HANDLE, 1, &rayTracingPipelineCI, nullptr, &_pipeline) != VK_SUCCESS) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    if (vkrt::vkCreateRayTracingPipelinesKHR(_ctx->device, VK_NULL_HANDLE, _ctx->pipelineCache, 1, &rayTracingPipelineCI, nullptr, &_pipeline) != VK_SUCCESS) {
+        _pipeline = VK_NULL_HANDLE;
+        spdlog::error("Failed to create ray tracing pipeline{}!", _name != "" ? fmt::format(" ({})", _name) : "");
         throw std::runtime_error("Failed to create ray tracing pipeline!");
     }else {
-        spdlog::info("Ray tracing pipeline created successfully {}", _name != "" ? fmt::format("({})", _name) : "");
+        auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        spdlog::info("Ray tracing pipeline created successfully {} in {:.1f} ms ({} pipeline cache)",
+            _name != "" ? fmt::format("({})", _name) : "", elapsed, _ctx->pipelineCacheWarm ? "warm" : "cold");
     }
-
-    // Cleanup shader modules
-    vkDestroyShaderModule(_ctx->device, raygenShaderModule, nullptr);
-    for (auto module : missShaderModules) {
-        vkDestroyShaderModule(_ctx->device, module, nullptr);
-    }
-    vkDestroyShaderModule(_ctx->device, closestHitShaderModule, nullptr);
-    vkDestroyShaderModule(_ctx->device, anyHitShaderModule, nullptr);
+    // Shader modules are destroyed with moduleSet
 }
 
 VkShaderModule RayTracingPipeline::createShaderModule(const std::vector<char>& code)
@@ -191,6 +241,7 @@ VkShaderModule RayTracingPipeline::createShaderModule(const std::vector<char>& c
 
     VkShaderModule shaderModule;
     if (vkCreateShaderModule(_ctx->device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+        spdlog::error("Failed to create shader module!");
         throw std::runtime_error("Failed to create shader module!");
     }
 
@@ -200,11 +251,16 @@ VkShaderModule RayTracingPipeline::createShaderModule(const std::vector<char>& c
 std::vector<char> RayTracingPipeline::readBinaryFile(const std::string& filename) {
     std::ifstream file(filename, std::ios::ate | std::ios::binary);
     if (!file.is_open()) {
-        spdlog::error("Failed to open file: {}", filename);
-        return {};
+        spdlog::error("Failed to open shader file: {}", filename);
+        throw std::runtime_error("Failed to open shader file!");
     }
 
+    // SPIR-V is a stream of 32 bit words, an empty or truncated file is not a shader
     size_t fileSize = (size_t) file.tellg();
+    if (fileSize == 0 || fileSize % sizeof(uint32_t) != 0) {
+        spdlog::error("Invalid SPIR-V file ({} bytes): {}", fileSize, filename);
+        throw std::runtime_error("Invalid SPIR-V file!");
+    }
     std::vector<char> buffer(fileSize);
 
     file.seekg(0);
@@ -8,6 +8,16 @@
 struct RayTracingPipelineParams {
     std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
 
+    // Specialization constants (applied to every stage, unused ids are ignored)
+    std::vector<VkSpecializationMapEntry> specializationEntries;
+    std::vector<uint8_t> specializationData;
+
+    // One push constant range shared by the given stages (0 = none)
+    uint32_t pushConstantSize = 0;
+    VkShaderStageFlags pushConstantStages = 0;
+
+    uint32_t maxRecursionDepth = 8;
+
     std::string name;
 };
 
@@ -17,7 +27,7 @@ public:
     RayTracingPipeline(std::shared_ptr<VulkanContext> ctx,
         const std::string& raygenShaderPath,
         const std::vector<std::string>& missShaderPaths,
-        const std::string& closestHitShaderPath,
+        const std::vector<std::string>& closestHitShaderPaths,
         const std::string& anyHitShaderPath,
         const RayTracingPipelineParams& params
     );
@@ -27,6 +37,7 @@ public:
     VkPipelineLayout getPipelineLayout() const { return _pipelineLayout; }
 
     const std::vector<VkRayTracingShaderGroupCreateInfoKHR>& getShaderGroups() { return _shaderGroups; }
+    uint32_t getHitGroupCount() const { return _hitGroupCount; }
 
 private:
     std::shared_ptr<VulkanContext> _ctx;
@@ -35,12 +46,13 @@ private:
     VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
 
     std::vector<VkRayTracingShaderGroupCreateInfoKHR> _shaderGroups{};
+    uint32_t _hitGroupCount = 0;
 
     void createPipelineLayout(const RayTracingPipelineParams& params);
     void createRayTracingPipeline(
         const std::string& raygenShaderPath,
         const std::vector<std::string>& missShaderPaths,
-        const std::string& closestHitShaderPath,
+        const std::vector<std::string>& closestHitShaderPaths,
         const std::string& anyHitShaderPath,
         const RayTracingPipelineParams& params
     );
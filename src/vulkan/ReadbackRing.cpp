@@ -0,0 +1,93 @@
+#include "vulkan/ReadbackRing.h"
+#include "vulkan/VulkanHelper.h"
+
+
+ReadbackRing::ReadbackRing(std::shared_ptr<VulkanContext> ctx, VkExtent2D extent, VkFormat format)
+    : _ctx(std::move(ctx)), _extent(extent), _format(format)
+{
+    const VkDeviceSize bufferSize = static_cast<VkDeviceSize>(_extent.width) * _extent.height * 4;
+
+    for (auto& slot : _slots) {
+        // Intermediate image so scaling and channel swizzling happen in a single blit
+        VulkanHelper::createImage(_ctx, _extent.width, _extent.height, _format, 1, 1, VK_SAMPLE_COUNT_1_BIT,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            slot.resolveImage, slot.resolveImageMemory);
+
+        slot.buffer = std::make_unique<Buffer>(_ctx, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+
+    spdlog::info("Readback ring created ({} slots of {}x{})", _slots.size(), _extent.width, _extent.height);
+}
+
+ReadbackRing::~ReadbackRing() {
+    // Owners wait for the device before tearing the ring down
+    for (auto& slot : _slots) {
+        slot.buffer.reset();
+        vkDestroyImage(_ctx->device, slot.resolveImage, nullptr);
+        _ctx->allocator->free(slot.resolveImageMemory);
+    }
+}
+
+void ReadbackRing::recordCopy(VkCommandBuffer commandBuffer, uint32_t slotIndex, VkImage srcImage, VkExtent2D srcExtent, std::string path) {
+    Slot& slot = _slots[slotIndex];
+    if (slot.pending) {
+        // The previous capture in this slot was never collected, it is lost
+        spdlog::warn("Readback slot {} overwritten before {} was collected", slotIndex, slot.path);
+    }
+
+    const VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+    VulkanHelper::transitionImageLayout(_ctx, commandBuffer, slot.resolveImage, range,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    VkImageBlit blitRegion{};
+    blitRegion.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blitRegion.srcOffsets[1]  = { (int32_t)srcExtent.width, (int32_t)srcExtent.height, 1 };
+    blitRegion.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    blitRegion.dstOffsets[1]  = { (int32_t)_extent.width, (int32_t)_extent.height, 1 };
+    vkCmdBlitImage(commandBuffer,
+        srcImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        slot.resolveImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &blitRegion, VK_FILTER_LINEAR);
+
+    VulkanHelper::transitionImageLayout(_ctx, commandBuffer, slot.resolveImage, range,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageExtent = { _extent.width, _extent.height, 1 };
+    vkCmdCopyImageToBuffer(commandBuffer, slot.resolveImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.buffer->getBuffer(), 1, &region);
+
+    // Make the copy visible to the host once the frame's fence signals
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = slot.buffer->getBuffer();
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+        0, nullptr, 1, &barrier, 0, nullptr);
+
+    slot.pending = true;
+    slot.path = std::move(path);
+}
+
+std::optional<CapturedImage> ReadbackRing::collect(uint32_t slotIndex) {
+    Slot& slot = _slots[slotIndex];
+    if (!slot.pending) return std::nullopt;
+    slot.pending = false;
+
+    // Copy out so the slot can be reused by the next frame while the encoder works
+    CapturedImage image;
+    image.path = std::move(slot.path);
+    image.width = _extent.width;
+    image.height = _extent.height;
+    const uint8_t* mapped = static_cast<const uint8_t*>(slot.buffer->getMappedMemory());
+    image.rgba.assign(mapped, mapped + static_cast<size_t>(_extent.width) * _extent.height * 4);
+    return image;
+}
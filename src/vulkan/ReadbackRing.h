@@ -0,0 +1,44 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/VulkanContext.h"
+#include "vulkan/resources/Buffer.h"
+#include "utils/ImageEncoder.h"
+
+
+// One host visible readback buffer per frame in flight. A frame that wants its output saved
+// records recordCopy() at the end of its command buffer; the copy is picked up with collect()
+// the next time that frame slot's fence has been waited on, so the CPU never waits for it.
+class ReadbackRing {
+public:
+    // extent: size of the saved images (the source is blitted to it), format must be 8-bit RGBA.
+    // Sources are already sRGB encoded (tonemap output), so the default format keeps the bytes as is.
+    ReadbackRing(std::shared_ptr<VulkanContext> ctx, VkExtent2D extent, VkFormat format = VK_FORMAT_R8G8B8A8_UNORM);
+    ~ReadbackRing();
+
+    ReadbackRing(const ReadbackRing&) = delete;
+    ReadbackRing& operator=(const ReadbackRing&) = delete;
+
+    // srcImage must be in TRANSFER_SRC_OPTIMAL, srcExtent is the region to scale into the slot
+    void recordCopy(VkCommandBuffer commandBuffer, uint32_t slot, VkImage srcImage, VkExtent2D srcExtent, std::string path);
+
+    // Only call once the fence of the frame that recorded into this slot has signaled
+    std::optional<CapturedImage> collect(uint32_t slot);
+
+    bool isPending(uint32_t slot) const { return _slots[slot].pending; }
+    VkExtent2D getExtent() const { return _extent; }
+
+private:
+    std::shared_ptr<VulkanContext> _ctx;
+    VkExtent2D _extent;
+    VkFormat _format;
+
+    struct Slot {
+        VkImage resolveImage = VK_NULL_HANDLE;
+        MemoryAllocator::Allocation resolveImageMemory;
+        std::unique_ptr<Buffer> buffer;
+        bool pending = false;
+        std::string path;
+    };
+    std::array<Slot, MAX_FRAMES_IN_FLIGHT> _slots;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "stdafx.h"
+
+// Whatever the renderer ultimately draws for: the window swapchain or an offscreen image.
+// The renderer needs its size and color format to allocate its own images, and writes its final
+// (display referred) output into the target's images when the target exposes them.
+class RenderTarget {
+public:
+    virtual ~RenderTarget() = default;
+
+    virtual VkExtent2D getExtent() const = 0;
+    virtual VkFormat getFormat() const = 0;
+
+    // One per image index passed to Renderer::recordToCommandBuffer (empty = renderer keeps its output)
+    virtual std::vector<VkImage> getImages() const { return {}; }
+    // Views the renderer can write from a compute shader, empty if the images lack storage usage
+    virtual std::vector<VkImageView> getStorageViews() const { return {}; }
+};
+
+// Fixed size target for headless rendering (no surface, never resized)
+class OffscreenTarget : public RenderTarget {
+public:
+    OffscreenTarget(VkExtent2D extent, VkFormat format) : _extent(extent), _format(format) {}
+
+    VkExtent2D getExtent() const override { return _extent; }
+    VkFormat getFormat() const override { return _format; }
+
+private:
+    VkExtent2D _extent;
+    VkFormat _format;
+};
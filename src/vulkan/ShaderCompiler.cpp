@@ -0,0 +1,129 @@
+#include "vulkan/ShaderCompiler.h"
+
+#ifdef SHADER_HOT_RELOAD
+#include <glslang/Public/ShaderLang.h>
+#include <glslang/Public/ResourceLimits.h>
+#include <glslang/SPIRV/GlslangToSpv.h>
+#include <mutex>
+#endif
+
+// used to go from macro to literal
+#define VALUE(string) #string
+#define TO_LITERAL(string) VALUE(string)
+
+
+namespace ShaderCompiler {
+
+    std::string getSourceDirectory() {
+#if defined(SHADER_DIR)
+        return std::filesystem::absolute(std::string(TO_LITERAL(SHADER_DIR))).string();
+#else
+        return {};
+#endif
+    }
+
+#ifdef SHADER_HOT_RELOAD
+
+    static std::string readTextFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return {};
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Resolves #include "..." relative to the including file, then to the root shader file
+    class Includer : public glslang::TShader::Includer {
+    public:
+        explicit Includer(std::filesystem::path rootDir) : _rootDir(std::move(rootDir)) {}
+
+        IncludeResult* includeLocal(const char* headerName, const char* includerName, size_t depth) override {
+            std::filesystem::path candidates[] = {
+                std::filesystem::path(includerName).parent_path() / headerName,
+                _rootDir / headerName
+            };
+            for (const auto& candidate : candidates) {
+                if (!std::filesystem::exists(candidate)) continue;
+                auto* content = new std::string(readTextFile(candidate));
+                return new IncludeResult(candidate.string(), content->data(), content->size(), content);
+            }
+            return nullptr;
+        }
+
+        IncludeResult* includeSystem(const char* headerName, const char* includerName, size_t depth) override {
+            return includeLocal(headerName, includerName, depth);
+        }
+
+        void releaseInclude(IncludeResult* result) override {
+            if (!result) return;
+            delete static_cast<std::string*>(result->userData);
+            delete result;
+        }
+
+    private:
+        std::filesystem::path _rootDir;
+    };
+
+    static EShLanguage getStage(const std::string& extension) {
+        if (extension == ".rgen")  return EShLangRayGen;
+        if (extension == ".rmiss") return EShLangMiss;
+        if (extension == ".rchit") return EShLangClosestHit;
+        if (extension == ".rahit") return EShLangAnyHit;
+        if (extension == ".rint")  return EShLangIntersect;
+        if (extension == ".comp")  return EShLangCompute;
+        spdlog::error("ShaderCompiler: unknown shader stage for extension '{}'", extension);
+        throw std::runtime_error("Unknown shader stage: " + extension);
+    }
+
+    bool isAvailable() { return true; }
+
+    std::vector<uint32_t> compileFile(const std::string& sourcePath) {
+        static std::once_flag initFlag;
+        std::call_once(initFlag, []() { glslang::InitializeProcess(); });
+
+        const std::filesystem::path path(sourcePath);
+        const EShLanguage stage = getStage(path.extension().string());
+
+        const std::string source = readTextFile(path);
+        if (source.empty()) {
+            spdlog::error("ShaderCompiler: failed to read {}", sourcePath);
+            throw std::runtime_error("Failed to read shader source: " + sourcePath);
+        }
+
+        // Same target as compile_shaders.sh (--target-env vulkan1.2)
+        glslang::TShader shader(stage);
+        const char* sourceText = source.c_str();
+        const char* sourceName = sourcePath.c_str();
+        shader.setStringsWithLengthsAndNames(&sourceText, nullptr, &sourceName, 1);
+        shader.setEnvInput(glslang::EShSourceGlsl, stage, glslang::EShClientVulkan, 100);
+        shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
+        shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_5);
+
+        const EShMessages messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+        Includer includer(path.parent_path());
+        if (!shader.parse(GetDefaultResources(), 460, false, messages, includer)) {
+            throw std::runtime_error(path.filename().string() + ":\n" + shader.getInfoLog());
+        }
+
+        glslang::TProgram program;
+        program.addShader(&shader);
+        if (!program.link(messages)) {
+            throw std::runtime_error(path.filename().string() + " (link):\n" + program.getInfoLog());
+        }
+
+        std::vector<uint32_t> spirv;
+        glslang::SpvOptions options;
+        glslang::GlslangToSpv(*program.getIntermediate(stage), spirv, &options);
+        return spirv;
+    }
+
+#else
+
+    bool isAvailable() { return false; }
+
+    std::vector<uint32_t> compileFile(const std::string& sourcePath) {
+        spdlog::error("ShaderCompiler: built without glslang, cannot compile {}", sourcePath);
+        throw std::runtime_error("Runtime shader compilation is disabled (configure with ENABLE_SHADER_HOT_RELOAD=ON)");
+    }
+
+#endif
+
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "stdafx.h"
+
+// Runtime GLSL -> SPIR-V compilation through glslang.
+// Only functional when built with ENABLE_SHADER_HOT_RELOAD (defines SHADER_HOT_RELOAD),
+// otherwise shaders come precompiled from compile_shaders.sh.
+namespace ShaderCompiler {
+
+    bool isAvailable();
+
+    // GLSL source folder baked in at configure time (empty when hot reload is disabled)
+    std::string getSourceDirectory();
+
+    // Compiles a shader source (stage from the file extension, #include resolved relative to the file).
+    // Throws std::runtime_error carrying the glslang log on failure.
+    std::vector<uint32_t> compileFile(const std::string& sourcePath);
+
+}
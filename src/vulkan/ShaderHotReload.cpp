@@ -0,0 +1,127 @@
+#include "vulkan/ShaderHotReload.h"
+#include "vulkan/ShaderCompiler.h"
+
+
+// Stages compiled on reload (compute passes are created once and keep their startup SPIR-V)
+static const std::array<const char*, 4> STAGE_EXTENSIONS = { ".rgen", ".rmiss", ".rchit", ".rahit" };
+
+static bool isWatched(const std::filesystem::path& path) {
+    const std::string extension = path.extension().string();
+    if (extension == ".glsl") return true;
+    return std::find(STAGE_EXTENSIONS.begin(), STAGE_EXTENSIONS.end(), extension) != STAGE_EXTENSIONS.end();
+}
+
+
+ShaderHotReload::ShaderHotReload(const std::string& sourceDir, const std::string& outputDir)
+    : _sourceDir(sourceDir), _outputDir(outputDir)
+{
+    _active = ShaderCompiler::isAvailable() && std::filesystem::is_directory(_sourceDir);
+    if (!_active) return;
+
+    // Baseline timestamps, nothing is recompiled until a file changes
+    scanForChanges();
+    _changesPending = false;
+    spdlog::info("Shader hot reload watching {}", _sourceDir.string());
+}
+
+ShaderHotReload::~ShaderHotReload()
+{
+    if (_pendingCompile.valid()) _pendingCompile.wait();
+}
+
+bool ShaderHotReload::scanForChanges() {
+    bool changed = false;
+    // Non-throwing iteration, a directory renamed mid-scan by an editor just ends this scan
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator entryIt(_sourceDir, ec), end; !ec && entryIt != end; entryIt.increment(ec)) {
+        const auto& entry = *entryIt;
+        std::error_code entryError;
+        if (!entry.is_regular_file(entryError) || !isWatched(entry.path())) continue;
+
+        const auto writeTime = entry.last_write_time(entryError);
+        if (entryError) continue;
+
+        auto [it, inserted] = _timestamps.try_emplace(entry.path().string(), writeTime);
+        if (!inserted && it->second != writeTime) {
+            it->second = writeTime;
+            changed = true;
+            spdlog::info("Shader source changed: {}", entry.path().filename().string());
+        }
+    }
+    _changesPending |= changed;
+    return changed;
+}
+
+bool ShaderHotReload::poll() {
+    if (!_active) return false;
+
+    // Collect a finished compile
+    bool reloaded = false;
+    if (_pendingCompile.valid() && _pendingCompile.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        _errorLog = _pendingCompile.get();
+        if (_errorLog.empty()) {
+            _reloadCount++;
+            reloaded = true;
+            spdlog::info("Shaders recompiled (reload #{}).", _reloadCount);
+        } else {
+            spdlog::error("Shader compilation failed:\n{}", _errorLog);
+        }
+    }
+
+    // Filesystem scan twice a second is plenty for editor saves
+    auto now = std::chrono::high_resolution_clock::now();
+    if (now - _lastScan > std::chrono::milliseconds(500)) {
+        _lastScan = now;
+        scanForChanges();
+    }
+
+    // One compile at a time, edits made meanwhile trigger another round afterwards
+    if (_changesPending && !_pendingCompile.valid()) {
+        _changesPending = false;
+        _pendingCompile = std::async(std::launch::async, &ShaderHotReload::compileAll, _sourceDir, _outputDir);
+    }
+
+    return reloaded;
+}
+
+std::string ShaderHotReload::compileAll(std::filesystem::path sourceDir, std::filesystem::path outputDir) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Compile everything first so a broken shader leaves the previous SPIR-V set untouched
+    std::vector<std::pair<std::filesystem::path, std::vector<uint32_t>>> outputs;
+    std::string errorLog;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator entryIt(sourceDir, ec), end; !ec && entryIt != end; entryIt.increment(ec)) {
+        const auto& path = entryIt->path();
+        const std::string extension = path.extension().string();
+        if (std::find(STAGE_EXTENSIONS.begin(), STAGE_EXTENSIONS.end(), extension) == STAGE_EXTENSIONS.end()) continue;
+
+        try {
+            // Same naming as compile_shaders.sh: <name>_<ext>.spv
+            auto outputPath = outputDir / (path.stem().string() + "_" + extension.substr(1) + ".spv");
+            outputs.emplace_back(outputPath, ShaderCompiler::compileFile(path.string()));
+        } catch (const std::exception& e) {
+            errorLog += std::string(e.what()) + "\n";
+        }
+    }
+    // Reported through the error log like a compile error instead of escaping the async task
+    if (ec) return "Failed to list " + sourceDir.string() + ": " + ec.message() + "\n";
+    if (!errorLog.empty()) return errorLog;
+
+    // Write through a temporary file + rename so a concurrent pipeline build never reads a partial file
+    for (const auto& [outputPath, spirv] : outputs) {
+        auto tempPath = outputPath;
+        tempPath += ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return "Failed to write " + tempPath.string() + "\n";
+            file.write(reinterpret_cast<const char*>(spirv.data()), spirv.size() * sizeof(uint32_t));
+        }
+        std::filesystem::rename(tempPath, outputPath, ec);
+        if (ec) return "Failed to replace " + outputPath.string() + ": " + ec.message() + "\n";
+    }
+
+    auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    spdlog::info("Compiled {} shaders in {:.1f} ms", outputs.size(), elapsed);
+    return {};
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "stdafx.h"
+
+#include <future>
+
+
+// Watches the GLSL sources of the ray tracing stages and recompiles them on a worker thread
+// into the .spv files the pipelines load, so the caller only has to rebuild its pipeline.
+// Inactive unless the runtime shader compiler is available (see ShaderCompiler.h).
+class ShaderHotReload {
+public:
+    ShaderHotReload(const std::string& sourceDir, const std::string& outputDir);
+    ~ShaderHotReload();
+
+    bool isActive() const { return _active; }
+
+    // Scans for edits (throttled) and collects a finished compile.
+    // Returns true once when freshly compiled SPIR-V has been written.
+    bool poll();
+
+    bool isCompiling() const { return _pendingCompile.valid(); }
+    const std::string& getErrorLog() const { return _errorLog; }
+    uint32_t getReloadCount() const { return _reloadCount; }
+
+private:
+    std::filesystem::path _sourceDir;
+    std::filesystem::path _outputDir;
+    bool _active = false;
+
+    std::unordered_map<std::string, std::filesystem::file_time_type> _timestamps;
+    TimePoint _lastScan = std::chrono::high_resolution_clock::now();
+    bool _changesPending = false;
+
+    std::future<std::string> _pendingCompile;  // Resolves to the error log (empty on success)
+    std::string _errorLog;
+    uint32_t _reloadCount = 0;
+
+    bool scanForChanges();
+    static std::string compileAll(std::filesystem::path sourceDir, std::filesystem::path outputDir);
+};
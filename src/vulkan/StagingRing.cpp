@@ -0,0 +1,222 @@
+#include "vulkan/StagingRing.h"
+#include "utils/CpuProfiler.h"
+
+
+StagingRing::StagingRing(VkDevice device, MemoryAllocator& allocator, VkQueue queue, uint32_t queueFamily, std::mutex& queueMutex,
+    VkDeviceSize capacity)
+    : _device(device), _allocator(allocator), _queue(queue), _queueMutex(queueMutex), _capacity(capacity)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = _capacity;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (vkCreateBuffer(_device, &bufferInfo, nullptr, &_buffer) != VK_SUCCESS) {
+        spdlog::error("Failed to create staging ring buffer!");
+        throw std::runtime_error("Failed to create staging ring buffer!");
+    }
+    _allocation = _allocator.allocateForBuffer(_buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    _mapped = static_cast<uint8_t*>(_allocation.mapped);
+
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+    if (vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &_timeline) != VK_SUCCESS) {
+        spdlog::error("Failed to create staging ring timeline semaphore!");
+        throw std::runtime_error("Failed to create staging ring timeline semaphore!");
+    }
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = queueFamily;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    if (vkCreateCommandPool(_device, &poolInfo, nullptr, &_commandPool) != VK_SUCCESS) {
+        spdlog::error("Failed to create staging ring command pool!");
+        throw std::runtime_error("Failed to create staging ring command pool!");
+    }
+
+    _stats.capacity = _capacity;
+    spdlog::info("Staging ring created ({} MiB)", _capacity >> 20);
+}
+
+StagingRing::~StagingRing() {
+    if (!_pendingCopies.empty()) {
+        spdlog::warn("Staging ring destroyed with {} copies never submitted", _pendingCopies.size());
+    }
+    waitForValue(_submittedValue);
+
+    vkDestroyCommandPool(_device, _commandPool, nullptr);
+    vkDestroySemaphore(_device, _timeline, nullptr);
+    vkDestroyBuffer(_device, _buffer, nullptr);
+    _allocator.free(_allocation);
+}
+
+
+void StagingRing::upload(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    retire(false);
+
+    // Half the ring per piece, so the next piece is written while the previous one is copied
+    const VkDeviceSize maxChunk = _capacity / 2;
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const VkDeviceSize chunk = std::min(size, maxChunk);
+        const VkDeviceSize offset = reserve(chunk);
+        memcpy(_mapped + offset, src, chunk);
+        _pendingCopies.push_back({ dst, { offset, dstOffset, chunk } });
+
+        _stats.uploadedBytes += chunk;
+        src += chunk;
+        dstOffset += chunk;
+        size -= chunk;
+    }
+}
+
+uint64_t StagingRing::submit() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    retire(false);
+    return submitLocked();
+}
+
+uint64_t StagingRing::submitLocked() {
+    if (_pendingCopies.empty()) return _submittedValue;
+    PROFILE_SCOPE("StagingRing::submit");
+
+    // Command buffers are recycled once their batch is done
+    VkCommandBuffer commandBuffer;
+    if (!_batches.empty() && _batches.front().value <= getCompletedValue()) {
+        commandBuffer = _batches.front().commandBuffer;
+        _batches.pop_front();
+        vkResetCommandBuffer(commandBuffer, 0);
+    } else {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = _commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(_device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            spdlog::error("Failed to allocate staging ring command buffer!");
+            throw std::runtime_error("Failed to allocate staging ring command buffer!");
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+    // Consecutive copies into the same buffer share one command
+    std::vector<VkBufferCopy> regions;
+    for (size_t i = 0; i < _pendingCopies.size(); i++) {
+        regions.push_back(_pendingCopies[i].region);
+        if (i + 1 == _pendingCopies.size() || _pendingCopies[i + 1].dst != _pendingCopies[i].dst) {
+            vkCmdCopyBuffer(commandBuffer, _buffer, _pendingCopies[i].dst, static_cast<uint32_t>(regions.size()), regions.data());
+            regions.clear();
+        }
+    }
+
+    // Covers later submissions on this queue (AS builds); other queues wait for the semaphore
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+    vkEndCommandBuffer(commandBuffer);
+
+    const uint64_t signalValue = _submittedValue + 1;
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &_timeline;
+    {
+        std::lock_guard<std::mutex> queueLock(_queueMutex);
+        if (vkQueueSubmit(_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+            spdlog::error("Failed to submit staging ring copies!");
+            throw std::runtime_error("Failed to submit staging ring copies!");
+        }
+    }
+
+    _submittedValue = signalValue;
+    _batches.push_back({ commandBuffer, signalValue });
+    _inFlight.push_back({ _head, signalValue });
+    _pendingCopies.clear();
+    _stats.submissions++;
+    return signalValue;
+}
+
+VkDeviceSize StagingRing::reserve(VkDeviceSize size) {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+    for (;;) {
+        // A piece never wraps around, the rest of the ring is skipped instead
+        uint64_t start = _head;
+        const VkDeviceSize offset = start % _capacity;
+        if (offset + size > _capacity) start += _capacity - offset;
+
+        // Nothing in use, the skipped bytes don't matter
+        if (_tail == _head) _tail = start;
+
+        if (start + size - _tail <= _capacity) {
+            _head = start + size;
+            return start % _capacity;
+        }
+
+        // Full: queued copies have to go out before their space can come back
+        if (!_pendingCopies.empty()) submitLocked();
+        retire(true);
+    }
+}
+
+void StagingRing::retire(bool wait) {
+    uint64_t completed = getCompletedValue();
+    if (wait && !_inFlight.empty() && _inFlight.front().value > completed) {
+        PROFILE_SCOPE("StagingRing::stall");
+        waitForValue(_inFlight.front().value);
+        completed = _inFlight.front().value;
+        _stats.stalls++;
+    }
+
+    while (!_inFlight.empty() && _inFlight.front().value <= completed) {
+        _tail = _inFlight.front().end;
+        _inFlight.pop_front();
+    }
+}
+
+uint64_t StagingRing::getCompletedValue() const {
+    uint64_t value = 0;
+    vkGetSemaphoreCounterValue(_device, _timeline, &value);
+    return value;
+}
+
+void StagingRing::waitForValue(uint64_t value) const {
+    if (value == 0) return;
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &_timeline;
+    waitInfo.pValues = &value;
+    vkWaitSemaphores(_device, &waitInfo, UINT64_MAX);
+}
+
+StagingRing::Stats StagingRing::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Stats stats = _stats;
+    stats.inFlightBytes = _head - _tail;
+    return stats;
+}
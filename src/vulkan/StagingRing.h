@@ -0,0 +1,92 @@
+#pragma once
+
+#include "stdafx.h"
+#include "vulkan/MemoryAllocator.h"
+
+#include <deque>
+#include <mutex>
+
+
+// Persistently mapped ring for host -> device buffer uploads. upload() copies the data into the
+// ring and queues the copy command, submit() sends everything queued in one submission on the
+// given queue and signals a timeline semaphore. Ring space is reclaimed once that value is
+// reached, so steady state uploads neither allocate nor wait. Thread safe.
+class StagingRing {
+public:
+    static constexpr VkDeviceSize DEFAULT_CAPACITY = 16ull << 20;  // 16 MiB
+    static constexpr VkDeviceSize ALIGNMENT = 16;
+
+    // queueMutex guards every submission to queue (shared with the other users of the queue)
+    StagingRing(VkDevice device, MemoryAllocator& allocator, VkQueue queue, uint32_t queueFamily, std::mutex& queueMutex,
+        VkDeviceSize capacity = DEFAULT_CAPACITY);
+    ~StagingRing();
+
+    StagingRing(const StagingRing&) = delete;
+    StagingRing& operator=(const StagingRing&) = delete;
+
+    // Queues a copy into dst (needs TRANSFER_DST usage, must live until the copy is done). Uploads
+    // larger than the ring are split, waits only when the ring is full of unfinished copies.
+    void upload(VkBuffer dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+
+    // Submits the queued copies, returns the value signaled when everything uploaded so far is on
+    // the device. Later submissions on the same queue see the data, other queues wait for the value.
+    uint64_t submit();
+
+    VkSemaphore getTimelineSemaphore() const { return _timeline; }
+    void waitForValue(uint64_t value) const;
+
+    struct Stats {
+        VkDeviceSize capacity = 0;
+        VkDeviceSize inFlightBytes = 0;   // Written but not yet retired
+        VkDeviceSize uploadedBytes = 0;   // Total since creation
+        uint32_t submissions = 0;
+        uint32_t stalls = 0;              // Times upload() had to wait for the device
+    };
+    Stats getStats() const;
+
+private:
+    VkDevice _device;
+    MemoryAllocator& _allocator;
+    VkQueue _queue;
+    std::mutex& _queueMutex;
+
+    VkBuffer _buffer = VK_NULL_HANDLE;
+    MemoryAllocator::Allocation _allocation;
+    uint8_t* _mapped = nullptr;
+    VkDeviceSize _capacity;
+
+    VkSemaphore _timeline = VK_NULL_HANDLE;
+    uint64_t _submittedValue = 0;
+
+    // Positions grow forever, the ring offset is position % capacity
+    uint64_t _head = 0;           // Next byte to write
+    uint64_t _tail = 0;           // Oldest byte a copy may still read
+    uint64_t _pendingEnd = 0;     // End of the data queued for the next submission
+    struct Region {
+        uint64_t end;
+        uint64_t value;           // Retired when the timeline reaches it
+    };
+    std::deque<Region> _inFlight;
+
+    struct PendingCopy {
+        VkBuffer dst;
+        VkBufferCopy region;
+    };
+    std::vector<PendingCopy> _pendingCopies;
+
+    // Own pool, recording here never touches the context's pools
+    VkCommandPool _commandPool = VK_NULL_HANDLE;
+    struct Batch {
+        VkCommandBuffer commandBuffer;
+        uint64_t value;
+    };
+    std::deque<Batch> _batches;
+
+    Stats _stats;
+    mutable std::mutex _mutex;
+
+    uint64_t submitLocked();
+    VkDeviceSize reserve(VkDeviceSize size);
+    void retire(bool wait);
+    uint64_t getCompletedValue() const;
+};
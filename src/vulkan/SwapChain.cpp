@@ -1,8 +1,8 @@
 #include "vulkan/SwapChain.h"
 
 
-SwapChain::SwapChain(std::shared_ptr<VulkanContext> ctx)
- : _ctx(ctx)
+SwapChain::SwapChain(std::shared_ptr<VulkanContext> ctx, VkPresentModeKHR preferredPresentMode)
+ : _ctx(ctx), _preferredPresentMode(preferredPresentMode)
 {
     createSwapChain();
 }
@@ -18,8 +18,11 @@ void SwapChain::createSwapChain()
 {
     SwapChainSupportDetails swapChainSupport = VulkanHelper::querySwapChainSupport(_ctx->physicalDevice, _ctx->surface);
 
-    VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
+    VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats, swapChainSupport.capabilities);
     VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+    if (firstTimeCreation || presentMode != _presentMode) spdlog::info("Swap chain present mode: {}", presentModeToString(presentMode));
+    _availablePresentModes = swapChainSupport.presentModes;
+    _presentMode = presentMode;
     VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
     uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
@@ -38,6 +41,13 @@ void SwapChain::createSwapChain()
     swapChainCreateInfo.imageArrayLayers = 1;
     swapChainCreateInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
+    // Storage usage lets the tonemap pass write the images directly (readback copies from them)
+    _storageUsage = supportsStorage(surfaceFormat.format, swapChainSupport.capabilities);
+    if (_storageUsage) {
+        swapChainCreateInfo.imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+    if (firstTimeCreation) spdlog::info("Swap chain storage usage: {}", _storageUsage ? "yes" : "no (tonemap output is copied)");
+
     QueueFamilyIndices indices = VulkanHelper::findQueueFamilies(_ctx->physicalDevice, _ctx->surface);
     uint32_t queueFamilyIndices[] = {indices.graphicsFamily.value(), indices.presentFamily.value()};
     if (indices.graphicsFamily != indices.presentFamily) {
@@ -87,7 +97,16 @@ void SwapChain::cleanupSwapChain() {
 }
 
 
-VkSurfaceFormatKHR SwapChain::chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) {
+VkSurfaceFormatKHR SwapChain::chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats, const VkSurfaceCapabilitiesKHR& capabilities) {
+    // UNORM images the tonemap pass can write as storage images (it applies the sRGB curve itself)
+    for (const auto& availableFormat : availableFormats) {
+        if (availableFormat.format == VK_FORMAT_B8G8R8A8_UNORM && availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR
+            && supportsStorage(availableFormat.format, capabilities)) {
+            return availableFormat;
+        }
+    }
+
+    // Otherwise sRGB images, the tonemapped output is copied in
     for (const auto& availableFormat : availableFormats) {
         if (availableFormat.format == VK_FORMAT_B8G8R8A8_SRGB && availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
             return availableFormat;
@@ -97,17 +116,49 @@ VkSurfaceFormatKHR SwapChain::chooseSwapSurfaceFormat(const std::vector<VkSurfac
     return availableFormats[0];
 }
 
+bool SwapChain::supportsStorage(VkFormat format, const VkSurfaceCapabilitiesKHR& capabilities) const {
+    // Image stores never apply the sRGB curve, so only UNORM formats qualify
+    const VkImageUsageFlags usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    if ((capabilities.supportedUsageFlags & usage) != usage) return false;
+    if (VulkanHelper::convertToUnormFormat(format) != format) return false;
+
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(_ctx->physicalDevice, format, &props);
+    return (props.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+}
+
 VkPresentModeKHR SwapChain::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) {
-    // Check for mailbox mode first (triple buffering)
+    // Preferred mode (mailbox = triple buffering by default) if the surface supports it
     for (const auto& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
+        if (availablePresentMode == _preferredPresentMode) {
             return availablePresentMode;
         }
     }
-    // Fallback to FIFO mode (double buffering)
+    // Fallback to FIFO mode (double buffering, always supported)
+    if (_preferredPresentMode != VK_PRESENT_MODE_FIFO_KHR) {
+        spdlog::warn("Present mode {} is not supported, using FIFO", presentModeToString(_preferredPresentMode));
+    }
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+const char* SwapChain::presentModeToString(VkPresentModeKHR mode) {
+    switch (mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:    return "Immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR:      return "Mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR:         return "FIFO";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO Relaxed";
+        default:                               return "Unknown";
+    }
+}
+
+std::optional<VkPresentModeKHR> SwapChain::presentModeFromString(const std::string& name) {
+    if (name == "immediate") return VK_PRESENT_MODE_IMMEDIATE_KHR;
+    if (name == "mailbox") return VK_PRESENT_MODE_MAILBOX_KHR;
+    if (name == "fifo") return VK_PRESENT_MODE_FIFO_KHR;
+    if (name == "fifo-relaxed") return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+    return std::nullopt;
+}
+
 VkExtent2D SwapChain::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) {
     if (capabilities.currentExtent.width != UINT32_MAX) {
         return capabilities.currentExtent;
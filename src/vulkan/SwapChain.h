@@ -2,11 +2,12 @@
 
 #include "stdafx.h"
 #include "vulkan/VulkanContext.h"
+#include "vulkan/RenderTarget.h"
 
 
-class SwapChain {
+class SwapChain : public RenderTarget {
 public:
-    SwapChain(std::shared_ptr<VulkanContext> ctx);
+    SwapChain(std::shared_ptr<VulkanContext> ctx, VkPresentModeKHR preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR);
     ~SwapChain();
 
     void createSwapChain();
@@ -19,6 +20,20 @@ public:
     const std::vector<VkImageView>& getSwapChainImageViews() const { return _swapChainImageViews; }
     const int getSwapChainImageCount() const { return static_cast<int>(_swapChainImages.size()); }
 
+    VkExtent2D getExtent() const override { return _swapChainExtent; }
+    VkFormat getFormat() const override { return _swapChainImageFormat; }
+    std::vector<VkImage> getImages() const override { return _swapChainImages; }
+    std::vector<VkImageView> getStorageViews() const override { return _storageUsage ? _swapChainImageViews : std::vector<VkImageView>{}; }
+
+    // Present mode used by the next createSwapChain (falls back to FIFO if the surface lacks it)
+    void setPreferredPresentMode(VkPresentModeKHR mode) { _preferredPresentMode = mode; }
+    VkPresentModeKHR getPreferredPresentMode() const { return _preferredPresentMode; }
+    VkPresentModeKHR getPresentMode() const { return _presentMode; }
+    const std::vector<VkPresentModeKHR>& getAvailablePresentModes() const { return _availablePresentModes; }
+
+    static const char* presentModeToString(VkPresentModeKHR mode);
+    static std::optional<VkPresentModeKHR> presentModeFromString(const std::string& name);  // fifo, fifo-relaxed, mailbox, immediate
+
 private:
     std::shared_ptr<VulkanContext> _ctx;
 
@@ -27,8 +42,14 @@ private:
     VkExtent2D _swapChainExtent;
     std::vector<VkImage> _swapChainImages;
     std::vector<VkImageView> _swapChainImageViews;
+    bool _storageUsage = false;     // Images were created with storage + transfer source usage
+
+    VkPresentModeKHR _preferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    VkPresentModeKHR _presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    std::vector<VkPresentModeKHR> _availablePresentModes;
 
-    VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
+    VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats, const VkSurfaceCapabilitiesKHR& capabilities);
+    bool supportsStorage(VkFormat format, const VkSurfaceCapabilitiesKHR& capabilities) const;
     VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
     VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities);
 
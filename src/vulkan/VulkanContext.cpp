@@ -1,27 +1,40 @@
 #include "vulkan/VulkanContext.h"
 #include "vulkan/VulkanRT.h"
+#include "utils/CpuProfiler.h"
 
 
 VulkanContext::VulkanContext(SDL_Window* window)
     : window(window)
 {
+    PROFILE_SCOPE("VulkanContext::VulkanContext");
     createVulkanInstance();
     setupDebugMessenger();
-    createSurface(window);
+    if (!isHeadless()) createSurface(window);
     pickPhysicalDevice();
     createLogicalDevice();
+    allocator = std::make_unique<MemoryAllocator>(physicalDevice, device, true, memoryBudgetSupported);
+    createPipelineCache();
     loadVulkanRTFunctions();
     createDescriptorPool();
     createCommandPool();
+    stagingRing = std::make_unique<StagingRing>(device, *allocator, computeQueue, computeQueueFamily, queueMutex);
+    graphicsSubmitter = std::make_unique<CommandSubmitter>(device, graphicsQueue, graphicsQueueFamily, queueMutex);
+    computeSubmitter = std::make_unique<CommandSubmitter>(device, computeQueue, computeQueueFamily, queueMutex);
 }
 
 VulkanContext::~VulkanContext() {
     spdlog::info("Destroying Vulkan context...");
+    computeSubmitter.reset();
+    graphicsSubmitter.reset();
+    stagingRing.reset();
     vkDestroyCommandPool(device, commandPool, nullptr);
+    vkDestroyCommandPool(device, computeCommandPool, nullptr);
     vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+    savePipelineCache();
     vkDestroyPipelineCache(device, pipelineCache, nullptr);
+    allocator.reset();
     vkDestroyDevice(device, nullptr);
-    vkDestroySurfaceKHR(instance, surface, nullptr);
+    if (surface) vkDestroySurfaceKHR(instance, surface, nullptr);
 
     if (debugMessenger) {
         auto destroyDebugUtilsMessengerEXT = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
@@ -69,10 +82,13 @@ void VulkanContext::createVulkanInstance() {
     }
 
     // Required extensions
-    // SDL extensions
-    uint32_t sdlExtensionCount = 0;
-    const char * const *sdlExtensionsRaw = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
-    std::vector<const char*> requiredExtensions(sdlExtensionsRaw, sdlExtensionsRaw + sdlExtensionCount);
+    // SDL extensions (surface + platform WSI), not needed without a window
+    std::vector<const char*> requiredExtensions;
+    if (!isHeadless()) {
+        uint32_t sdlExtensionCount = 0;
+        const char * const *sdlExtensionsRaw = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
+        requiredExtensions.assign(sdlExtensionsRaw, sdlExtensionsRaw + sdlExtensionCount);
+    }
 
     // Debug Utils extension
     if(!isInstanceExtensionAvailable(VK_EXT_DEBUG_UTILS_EXTENSION_NAME)) {
@@ -88,6 +104,11 @@ void VulkanContext::createVulkanInstance() {
         requiredExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
     }
 
+#ifdef __APPLE__
+    // Normally pulled in by SDL, headless has to ask for it itself
+    if (isHeadless()) requiredExtensions.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
+#endif
+
     instanceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(requiredExtensions.size());
     instanceCreateInfo.ppEnabledExtensionNames = requiredExtensions.data();
 
@@ -164,13 +185,13 @@ void VulkanContext::pickPhysicalDevice() {
         }
     }
     if (physicalDevice == VK_NULL_HANDLE) {
-        spdlog::warn("No suitable discrete GPU found, trying fallback to any integrated GPU!");
+        spdlog::warn("No suitable discrete GPU found, trying fallback to any integrated or software device!");
         for (const auto& device : devices) {
             VkPhysicalDeviceProperties deviceProperties;
             vkGetPhysicalDeviceProperties(device, &deviceProperties);
             if (isDeviceSuitable(device, true)) {
                 physicalDevice = device;
-                spdlog::info("Found Suitable iGPU: {}", deviceProperties.deviceName);
+                spdlog::info("Found Suitable fallback device: {}", deviceProperties.deviceName);
                 break;
             }
         }
@@ -196,19 +217,36 @@ void VulkanContext::createLogicalDevice() {
         if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
             graphicsFamily = i;
         }
+        if (isHeadless()) continue;
         VkBool32 presentSupport = false;
         vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
         if (presentSupport) {
             presentFamily = i;
         }
     }
+    // Nothing is presented headless, the present queue just aliases the graphics queue
+    if (isHeadless()) presentFamily = graphicsFamily;
+
+    // Prefer a compute family without graphics (async compute) for acceleration structure builds
+    std::optional<uint32_t> computeFamily;
+    for (uint32_t i = 0; i < queueFamilyCount; ++i) {
+        if ((queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            computeFamily = i;
+            break;
+        }
+    }
+    graphicsQueueFamily = graphicsFamily.value();
+    computeQueueFamily = computeFamily.value_or(graphicsFamily.value());
+    computeQueueTimestamps = queueFamilies[computeQueueFamily].timestampValidBits > 0;
+    if (computeFamily) spdlog::info("Async compute queue family: {}", computeQueueFamily);
+    else spdlog::info("No dedicated compute queue family, acceleration structures are built on the graphics queue");
 
     // Create logical device
     VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     // Specify the queue create info for graphics and present queues
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set<uint32_t> uniqueQueueFamilies = {graphicsFamily.value(), presentFamily.value()};
+    std::set<uint32_t> uniqueQueueFamilies = {graphicsFamily.value(), presentFamily.value(), computeQueueFamily};
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
         VkDeviceQueueCreateInfo queueCreateInfo{};
@@ -222,8 +260,7 @@ void VulkanContext::createLogicalDevice() {
     deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
 
     // Specify the device extensions
-    const std::vector<const char*> deviceExtensions = {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+    std::vector<const char*> deviceExtensions = {
         VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
         VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
         VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
@@ -232,6 +269,10 @@ void VulkanContext::createLogicalDevice() {
         VK_KHR_SPIRV_1_4_EXTENSION_NAME,
         VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME
     };
+    if (!isHeadless()) deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    // Optional, the allocator falls back to its own usage and the heap sizes without it
+    memoryBudgetSupported = isDeviceExtensionAvailable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (memoryBudgetSupported) deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
     deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
     deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
@@ -241,10 +282,37 @@ void VulkanContext::createLogicalDevice() {
     deviceFeatures.sampleRateShading = VK_TRUE; // Enable sample rate shading
     deviceFeatures.shaderInt64 = VK_TRUE;       // Enable 64-bit integer support in shaders
 
+    // Timeline semaphores and host query reset are core 1.2 features, but still optional
+    VkPhysicalDeviceVulkan12Features supportedVulkan12Features{};
+    supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 supportedFeatures2{};
+    supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures2.pNext = &supportedVulkan12Features;
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures2);
+    std::string missingFeatures;
+    if (!supportedVulkan12Features.timelineSemaphore) missingFeatures += " timelineSemaphore";
+    if (!supportedVulkan12Features.hostQueryReset) missingFeatures += " hostQueryReset";
+    if (!missingFeatures.empty()) {
+        spdlog::error("The selected GPU does not support the required Vulkan 1.2 feature(s):{}", missingFeatures);
+        throw std::runtime_error("Required Vulkan 1.2 features are not supported!");
+    }
+
+    // Enable timeline semaphores (frame pacing)
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{};
+    timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
+    // Enable host query reset (GPU profiler resets retired timestamp ranges from the CPU)
+    VkPhysicalDeviceHostQueryResetFeatures hostQueryResetFeatures{};
+    hostQueryResetFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_QUERY_RESET_FEATURES;
+    hostQueryResetFeatures.hostQueryReset = VK_TRUE;
+    timelineSemaphoreFeatures.pNext = &hostQueryResetFeatures;
+
     // Enable buffer device address feature (required for ray tracing)
     VkPhysicalDeviceBufferDeviceAddressFeatures bufferDeviceAddressFeatures{};
     bufferDeviceAddressFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES;
     bufferDeviceAddressFeatures.bufferDeviceAddress = VK_TRUE;
+    bufferDeviceAddressFeatures.pNext = &timelineSemaphoreFeatures;
 
     // Enable ray tracing pipeline features
     VkPhysicalDeviceRayTracingPipelineFeaturesKHR rayTracingPipelineFeatures{};
@@ -273,17 +341,167 @@ void VulkanContext::createLogicalDevice() {
     // Get the graphics queue handle
     vkGetDeviceQueue(device, graphicsFamily.value(), 0, &graphicsQueue);
     vkGetDeviceQueue(device, presentFamily.value(), 0, &presentQueue);
+    vkGetDeviceQueue(device, computeQueueFamily, 0, &computeQueue);
+}
+
+// On-disk pipeline cache: this header followed by the vkGetPipelineCacheData blob.
+// Any field mismatch (other GPU, driver update, truncated/corrupt file) discards the file.
+struct PipelineCacheFileHeader {
+    uint32_t magic;
+    uint32_t fileVersion;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t deviceUUID[VK_UUID_SIZE];
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+static constexpr uint32_t PIPELINE_CACHE_MAGIC = 0x43505452; // "RTPC"
+static constexpr uint32_t PIPELINE_CACHE_FILE_VERSION = 1;
+
+// FNV-1a, enough to catch truncated or damaged files
+static uint64_t hashPipelineCacheData(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static PipelineCacheFileHeader makePipelineCacheFileHeader(VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceIDProperties idProperties{};
+    idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &idProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+    PipelineCacheFileHeader header{};
+    header.magic = PIPELINE_CACHE_MAGIC;
+    header.fileVersion = PIPELINE_CACHE_FILE_VERSION;
+    header.vendorID = properties2.properties.vendorID;
+    header.deviceID = properties2.properties.deviceID;
+    header.driverVersion = properties2.properties.driverVersion;
+    memcpy(header.deviceUUID, idProperties.deviceUUID, VK_UUID_SIZE);
+    memcpy(header.pipelineCacheUUID, properties2.properties.pipelineCacheUUID, VK_UUID_SIZE);
+    return header;
+}
+
+void VulkanContext::createPipelineCache() {
+    // Per-user writable location, falls back to the working directory
+    char* prefPath = SDL_GetPrefPath("arminkz", "VulkanRayTracer");
+    _pipelineCachePath = (std::filesystem::path(prefPath ? prefPath : "") / "pipeline_cache.bin").string();
+    SDL_free(prefPath);
+
+    const PipelineCacheFileHeader expected = makePipelineCacheFileHeader(physicalDevice);
+    std::vector<uint8_t> initialData;
+
+    std::ifstream file(_pipelineCachePath, std::ios::binary);
+    if (file.is_open()) {
+        PipelineCacheFileHeader header{};
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+        bool valid = file.gcount() == sizeof(header)
+            && header.magic == expected.magic
+            && header.fileVersion == expected.fileVersion
+            && header.vendorID == expected.vendorID
+            && header.deviceID == expected.deviceID
+            && header.driverVersion == expected.driverVersion
+            && memcmp(header.deviceUUID, expected.deviceUUID, VK_UUID_SIZE) == 0
+            && memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) == 0
+            && header.dataSize >= sizeof(VkPipelineCacheHeaderVersionOne)
+            && header.dataSize < (1ull << 30);
+
+        if (valid) {
+            initialData.resize(header.dataSize);
+            file.read(reinterpret_cast<char*>(initialData.data()), initialData.size());
+            valid = file.gcount() == static_cast<std::streamsize>(initialData.size())
+                && hashPipelineCacheData(initialData.data(), initialData.size()) == header.dataHash;
+        }
+
+        // The driver's own header must agree as well
+        if (valid) {
+            VkPipelineCacheHeaderVersionOne driverHeader{};
+            memcpy(&driverHeader, initialData.data(), sizeof(driverHeader));
+            valid = driverHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+                && driverHeader.vendorID == expected.vendorID
+                && driverHeader.deviceID == expected.deviceID
+                && memcmp(driverHeader.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+
+        if (!valid) {
+            spdlog::warn("Pipeline cache {} is corrupt or from another device/driver, starting cold", _pipelineCachePath);
+            initialData.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheCI{};
+    pipelineCacheCI.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipelineCacheCI.initialDataSize = initialData.size();
+    pipelineCacheCI.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    if (vkCreatePipelineCache(device, &pipelineCacheCI, nullptr, &pipelineCache) != VK_SUCCESS) {
+        // A rejected blob is not fatal, retry empty
+        pipelineCacheCI.initialDataSize = 0;
+        pipelineCacheCI.pInitialData = nullptr;
+        initialData.clear();
+        if (vkCreatePipelineCache(device, &pipelineCacheCI, nullptr, &pipelineCache) != VK_SUCCESS) {
+            spdlog::error("Failed to create pipeline cache!");
+            throw std::runtime_error("Failed to create pipeline cache!");
+        }
+    }
+
+    pipelineCacheWarm = !initialData.empty();
+    spdlog::info("Pipeline cache {} ({} bytes from {})", pipelineCacheWarm ? "warm" : "cold", initialData.size(), _pipelineCachePath);
+}
+
+void VulkanContext::savePipelineCache() {
+    if (pipelineCache == VK_NULL_HANDLE || _pipelineCachePath.empty()) return;
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) return;
+    std::vector<uint8_t> data(dataSize);
+    if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, data.data()) != VK_SUCCESS) return;
+    data.resize(dataSize);
+
+    PipelineCacheFileHeader header = makePipelineCacheFileHeader(physicalDevice);
+    header.dataSize = data.size();
+    header.dataHash = hashPipelineCacheData(data.data(), data.size());
+
+    // Write next to the target and rename so a crash never leaves a half written cache
+    const std::string tempPath = _pipelineCachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            spdlog::warn("Could not write pipeline cache to {}", tempPath);
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, _pipelineCachePath, ec);
+    if (ec) {
+        spdlog::warn("Could not replace pipeline cache {}: {}", _pipelineCachePath, ec.message());
+        return;
+    }
+    spdlog::info("Pipeline cache saved ({} bytes) to {}", data.size(), _pipelineCachePath);
 }
 
 void VulkanContext::createDescriptorPool() {
 
     // Descriptor usage counts per type
-    uint32_t totalUBOs = MAX_FRAMES_IN_FLIGHT;
-    uint32_t totalSSBOs = 10;
+    // (every count is doubled as contingency: new sets are allocated before the old ones are freed)
+    // The tonemapper's sets scale with the swapchain image count and come from its own pool
+    uint32_t totalUBOs = MAX_FRAMES_IN_FLIGHT * 2 * 2;               // Scene set + reprojection set per frame
+    uint32_t totalSSBOs = MAX_FRAMES_IN_FLIGHT * 4 * 2;              // Instance data, sampler tables, emissive triangles, environment per frame
     //uint32_t totalSamplers = 70;
-    uint32_t totalAccelerationStructures = MAX_FRAMES_IN_FLIGHT;     // One per frame
-    uint32_t totalStorageImages = MAX_FRAMES_IN_FLIGHT;              // One per frame
-    uint32_t maxSets = MAX_FRAMES_IN_FLIGHT * 2;                     // One per frame + One contingency while resizing
+    uint32_t totalAccelerationStructures = MAX_FRAMES_IN_FLIGHT * 2; // One per frame
+    uint32_t totalStorageImages = (MAX_FRAMES_IN_FLIGHT * 9 + 4 * 5) * 2; // 4 trace outputs + 5 for reprojection per frame, 4 denoiser sets of 5
+    uint32_t maxSets = (MAX_FRAMES_IN_FLIGHT * 2 + 4) * 2;                // Scene + reprojection set per frame, 4 denoiser sets
 
     std::vector<VkDescriptorPoolSize> poolSizes = {
         //{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, totalSamplers }
@@ -319,6 +537,12 @@ void VulkanContext::createCommandPool() {
         throw std::runtime_error("Failed to create command pool!");
     }
 
+    // Separate pool even without a dedicated family, so compute recording never touches the graphics pool
+    poolInfo.queueFamilyIndex = computeQueueFamily;
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &computeCommandPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create compute command pool!");
+    }
+
     spdlog::info("Command pool created successfully");
 }
 
@@ -346,7 +570,6 @@ bool VulkanContext::isDeviceSuitable(VkPhysicalDevice device, bool fallback) {
 
     // Check if the device supports certain extensions (including ray tracing extensions)
     std::set<std::string> requiredExtensions = {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
         VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME,
         VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
@@ -355,6 +578,7 @@ bool VulkanContext::isDeviceSuitable(VkPhysicalDevice device, bool fallback) {
         VK_KHR_SPIRV_1_4_EXTENSION_NAME,
         VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME
     };
+    if (!isHeadless()) requiredExtensions.insert(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
     uint32_t extensionCount;
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
     std::vector<VkExtensionProperties> availableExtensions(extensionCount);
@@ -364,9 +588,12 @@ bool VulkanContext::isDeviceSuitable(VkPhysicalDevice device, bool fallback) {
     }
     bool hasRequiredExtensions = requiredExtensions.empty();
 
-    // Check if the device swapchain is adequate
-    SwapChainSupportDetails swapChainSupport = VulkanHelper::querySwapChainSupport(device, surface);
-    bool swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
+    // Check if the device swapchain is adequate (nothing to present to when headless)
+    bool swapChainAdequate = true;
+    if (!isHeadless()) {
+        SwapChainSupportDetails swapChainSupport = VulkanHelper::querySwapChainSupport(device, surface);
+        swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
+    }
 
     // Log device name + suitability
     spdlog::debug("Evaluating GPU: {}", deviceProperties.deviceName);
@@ -410,6 +637,20 @@ bool VulkanContext::isInstanceExtensionAvailable(const char* extensionName) {
     return false;
 }
 
+bool VulkanContext::isDeviceExtensionAvailable(const char* extensionName) {
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+    for (const auto& extension : availableExtensions) {
+        if (strcmp(extensionName, extension.extensionName) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 
 VKAPI_ATTR VkBool32 VKAPI_CALL VulkanContext::debugCallback(
     VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
@@ -1,10 +1,16 @@
 #pragma once
 #include "stdafx.h"
 #include "vulkan/VulkanHelper.h"
+#include "vulkan/MemoryAllocator.h"
+#include "vulkan/StagingRing.h"
+#include "vulkan/CommandSubmitter.h"
+
+#include <mutex>
 
 
 class VulkanContext {
 public:
+    // A null window creates a headless context (no surface, no swapchain, any device type)
     VulkanContext(SDL_Window* window);
     ~VulkanContext();
 
@@ -12,6 +18,7 @@ public:
     VulkanContext& operator=(const VulkanContext&) = delete;
 
     SDL_Window* window = nullptr;
+    bool isHeadless() const { return window == nullptr; }
 
     VkInstance instance;
     VkSurfaceKHR surface = nullptr;
@@ -21,19 +28,45 @@ public:
     VkQueue graphicsQueue;
     VkQueue presentQueue;
 
+    // Acceleration structure builds. A compute-only family when the device exposes one, otherwise
+    // the graphics queue again (same VkQueue handle).
+    VkQueue computeQueue;
+    // Held around every vkQueueSubmit / vkQueuePresentKHR, loading threads submit too (the
+    // queues may all be the same VkQueue)
+    std::mutex queueMutex;
+    uint32_t graphicsQueueFamily = 0;
+    uint32_t computeQueueFamily = 0;
+    bool computeQueueTimestamps = false;  // Timestamps can be written on the compute queue
+    bool hasAsyncCompute() const { return computeQueueFamily != graphicsQueueFamily; }
+    bool memoryBudgetSupported = false;   // VK_EXT_memory_budget is enabled
+
+    // Persisted across runs (see createPipelineCache), shared by every pipeline creation
     VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    bool pipelineCacheWarm = false;  // True when the cache was restored from disk
 
     VkDescriptorPool descriptorPool;
     VkCommandPool commandPool;
+    VkCommandPool computeCommandPool;  // Command buffers submitted to computeQueue
+
+    // Backs every Buffer / StorageImage, created right after the device
+    std::unique_ptr<MemoryAllocator> allocator;
+    // Host -> device buffer uploads, submitted on computeQueue
+    std::unique_ptr<StagingRing> stagingRing;
+    // One time commands (layout transitions, acceleration structure builds) from any thread
+    std::unique_ptr<CommandSubmitter> graphicsSubmitter;
+    std::unique_ptr<CommandSubmitter> computeSubmitter;
 
 private:
     bool _validationLayersAvailable = true;
+    std::string _pipelineCachePath;
 
     void createVulkanInstance();
     void setupDebugMessenger();
     void createSurface(SDL_Window* window);
     void pickPhysicalDevice();
     void createLogicalDevice();
+    void createPipelineCache();
+    void savePipelineCache();
     void createDescriptorPool();
     void createCommandPool();
     void loadVulkanRTFunctions();
@@ -50,6 +83,7 @@ private:
 
     bool isInstanceLayerAvailable(const char* layerName);
     bool isInstanceExtensionAvailable(const char* extensionName);
+    bool isDeviceExtensionAvailable(const char* extensionName);
 
     void printVulkanInfo();
 };
@@ -4,35 +4,20 @@
 namespace VulkanHelper {
 
     VkCommandBuffer beginSingleTimeCommands(const std::shared_ptr<VulkanContext>& ctx) {
-        VkCommandBufferAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.commandPool = ctx->commandPool;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandBufferCount = 1;
-
-        VkCommandBuffer commandBuffer;
-        vkAllocateCommandBuffers(ctx->device, &allocInfo, &commandBuffer);
-
-        VkCommandBufferBeginInfo beginInfo = {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT; // Optional
-
-        vkBeginCommandBuffer(commandBuffer, &beginInfo);
-        return commandBuffer;
+        return ctx->graphicsSubmitter->begin();
     }
 
     void endSingleTimeCommands(const std::shared_ptr<VulkanContext>& ctx, VkCommandBuffer commandBuffer) {
-        vkEndCommandBuffer(commandBuffer);
-
-        VkSubmitInfo submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &commandBuffer;
+        // Waits for this command buffer only, frames queued before it keep running
+        ctx->graphicsSubmitter->wait(ctx->graphicsSubmitter->submit(commandBuffer));
+    }
 
-        vkQueueSubmit(ctx->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(ctx->graphicsQueue);
+    VkCommandBuffer beginComputeCommands(const std::shared_ptr<VulkanContext>& ctx) {
+        return ctx->computeSubmitter->begin();
+    }
 
-        vkFreeCommandBuffers(ctx->device, ctx->commandPool, 1, &commandBuffer);
+    void endComputeCommands(const std::shared_ptr<VulkanContext>& ctx, VkCommandBuffer commandBuffer) {
+        ctx->computeSubmitter->wait(ctx->computeSubmitter->submit(commandBuffer));
     }
 
 
@@ -54,8 +39,8 @@ namespace VulkanHelper {
                       VkDeviceSize size,
                       VkBufferUsageFlags usage,
                       VkMemoryPropertyFlags properties,
-                      bool needsDeviceAddress,
-                      VkBuffer& buffer, VkDeviceMemory& bufferMemory)
+                      VkBuffer& buffer, MemoryAllocator::Allocation& allocation,
+                      MemoryCategory category)
     {
         // Create buffer
         VkBufferCreateInfo bufferInfo{};
@@ -64,35 +49,26 @@ namespace VulkanHelper {
         bufferInfo.usage = usage;
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // Only one queue family will use this buffer
 
-        if (vkCreateBuffer(ctx->device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
-            spdlog::error("Failed to create buffer!");
-            return;
-        }
-
-        // Get memory requirements for the buffer
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(ctx->device, buffer, &memRequirements);
-
-        // Allocate memory for the buffer
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-
-        if (needsDeviceAddress) {
-            VkMemoryAllocateFlagsInfo allocFlagsInfo{};
-            allocFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
-            allocFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR;
-            allocInfo.pNext = &allocFlagsInfo;
+        // Acceleration structures and their inputs are built on the compute queue and traced on the
+        // graphics queue, upload targets are filled by the staging ring on the compute queue as well.
+        // Concurrent sharing saves the ownership transfers.
+        const VkBufferUsageFlags crossQueueUsage =
+            VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR
+            | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        const uint32_t queueFamilies[] = { ctx->graphicsQueueFamily, ctx->computeQueueFamily };
+        if (ctx->hasAsyncCompute() && (usage & crossQueueUsage)) {
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = 2;
+            bufferInfo.pQueueFamilyIndices = queueFamilies;
         }
 
-        allocInfo.memoryTypeIndex = findMemoryType(ctx, memRequirements.memoryTypeBits, properties);
-        if (vkAllocateMemory(ctx->device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-            spdlog::error("Failed to allocate buffer memory!");
+        if (vkCreateBuffer(ctx->device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+            spdlog::error("Failed to create buffer!");
             return;
         }
 
-        // Bind the buffer memory to the buffer
-        vkBindBufferMemory(ctx->device, buffer, bufferMemory, 0);
+        // Suballocated and bound, blocks for buffers always have device addresses enabled
+        allocation = ctx->allocator->allocateForBuffer(buffer, properties, category);
     }
 
 
@@ -212,6 +188,18 @@ namespace VulkanHelper {
     }
 
 
+    void recordAccelerationStructureBuildBarrier(VkCommandBuffer commandBuffer)
+    {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+        barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+        vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+
     void createImage(const std::shared_ptr<VulkanContext>& ctx,
                      uint32_t width,
                      uint32_t height,
@@ -222,7 +210,7 @@ namespace VulkanHelper {
                      VkImageTiling tiling,
                      VkImageUsageFlags usage,
                      VkMemoryPropertyFlags properties,
-                     VkImage& image, VkDeviceMemory& imageMemory,
+                     VkImage& image, MemoryAllocator::Allocation& allocation,
                      VkImageCreateFlags flags)
     {
         VkImageCreateInfo imageInfo{};
@@ -246,19 +234,7 @@ namespace VulkanHelper {
             return;
         }
 
-        VkMemoryRequirements memRequirements;
-        vkGetImageMemoryRequirements(ctx->device, image, &memRequirements);
-
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = findMemoryType(ctx, memRequirements.memoryTypeBits, properties);
-        if (vkAllocateMemory(ctx->device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-            spdlog::error("Failed to allocate image memory!");
-            return;
-        }
-
-        vkBindImageMemory(ctx->device, image, imageMemory, 0);
+        allocation = ctx->allocator->allocateForImage(image, properties, tiling == VK_IMAGE_TILING_LINEAR);
     }
 
 
@@ -488,8 +464,11 @@ namespace VulkanHelper {
             if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
                 indices.graphicsFamily = i;
             }
-            VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
+            // Without a surface (headless) the graphics family stands in for presentation
+            VkBool32 presentSupport = (surface == VK_NULL_HANDLE) && indices.graphicsFamily.has_value();
+            if (surface != VK_NULL_HANDLE) {
+                vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
+            }
             if (presentSupport) {
                 indices.presentFamily = i;
             }
@@ -559,7 +538,10 @@ namespace VulkanHelper {
     std::string formatToString(VkFormat format) {
         switch (format) {
             case VK_FORMAT_R8G8B8A8_UNORM: return "VK_FORMAT_R8G8B8A8_UNORM";
+            case VK_FORMAT_R8G8B8A8_SRGB: return "VK_FORMAT_R8G8B8A8_SRGB";
+            case VK_FORMAT_B8G8R8A8_UNORM: return "VK_FORMAT_B8G8R8A8_UNORM";
             case VK_FORMAT_B8G8R8A8_SRGB: return "VK_FORMAT_B8G8R8A8_SRGB";
+            case VK_FORMAT_R16G16B16A16_SFLOAT: return "VK_FORMAT_R16G16B16A16_SFLOAT";
             case VK_FORMAT_D32_SFLOAT: return "VK_FORMAT_D32_SFLOAT";
             case VK_FORMAT_D32_SFLOAT_S8_UINT: return "VK_FORMAT_D32_SFLOAT_S8_UINT";
             case VK_FORMAT_D24_UNORM_S8_UINT: return "VK_FORMAT_D24_UNORM_S8_UINT";
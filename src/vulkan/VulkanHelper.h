@@ -1,6 +1,7 @@
 #pragma once
 #include "stdafx.h"
 #include "vulkan/VulkanContext.h"
+#include "vulkan/MemoryAllocator.h"
 
 class VulkanContext;
 
@@ -21,12 +22,18 @@ struct SwapChainSupportDetails {
 
 namespace VulkanHelper {
 
+    // Blocking one time commands through ctx->graphicsSubmitter (use it directly to not wait)
     VkCommandBuffer beginSingleTimeCommands(const std::shared_ptr<VulkanContext>& ctx);
     void endSingleTimeCommands(const std::shared_ptr<VulkanContext>& ctx, VkCommandBuffer commandBuffer);
+    // Same on the compute queue
+    VkCommandBuffer beginComputeCommands(const std::shared_ptr<VulkanContext>& ctx);
+    void endComputeCommands(const std::shared_ptr<VulkanContext>& ctx, VkCommandBuffer commandBuffer);
 
     uint32_t findMemoryType(const std::shared_ptr<VulkanContext>& ctx, uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
-    void createBuffer(const std::shared_ptr<VulkanContext>& ctx, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, bool needsDeviceAddress, VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+    // Memory comes from ctx->allocator and is already bound
+    void createBuffer(const std::shared_ptr<VulkanContext>& ctx, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, MemoryAllocator::Allocation& allocation,
+        MemoryCategory category = MemoryCategory::Other);
     void copyBuffer(const std::shared_ptr<VulkanContext>& ctx, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
     void copyBufferToImage(const std::shared_ptr<VulkanContext>& ctx, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
     void copyBufferToCubemap(const std::shared_ptr<VulkanContext>& ctx, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
@@ -35,6 +42,10 @@ namespace VulkanHelper {
     uint64_t getBufferDeviceAddress(const std::shared_ptr<VulkanContext>& ctx,
         VkBuffer buffer);
 
+    // After an acceleration structure build: later builds / refits on the same queue (also in later
+    // submissions) read the result and may reuse the scratch memory
+    void recordAccelerationStructureBuildBarrier(VkCommandBuffer commandBuffer);
+
     void createImage(const std::shared_ptr<VulkanContext>& ctx,
         uint32_t width, uint32_t height,
         VkFormat format,
@@ -44,7 +55,7 @@ namespace VulkanHelper {
         VkImageTiling tiling,
         VkImageUsageFlags usage,
         VkMemoryPropertyFlags properties,
-        VkImage& image, VkDeviceMemory& imageMemory,
+        VkImage& image, MemoryAllocator::Allocation& allocation,
         VkImageCreateFlags flags = 0);
 
 
@@ -60,13 +60,14 @@ BLAS::BLAS(std::shared_ptr<VulkanContext> ctx, const DeviceMesh& dmesh)
 	accelerationStructureCreateInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
 	vkrt::vkCreateAccelerationStructureKHR(_ctx->device, &accelerationStructureCreateInfo, nullptr, &_handle);
 
-    // Create scratch buffer
-    Buffer scratchBuffer(
+    // Scratch memory, released once the build is done
+    auto scratchBuffer = std::make_shared<Buffer>(
         _ctx,
         accelerationStructureBuildSizesInfo.buildScratchSize,
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        true);
+        true,
+        MemoryCategory::Scratch);
 
     // AS Build geometry info
     VkAccelerationStructureBuildGeometryInfoKHR accelerationBuildGeometryInfo{};
@@ -77,7 +78,7 @@ BLAS::BLAS(std::shared_ptr<VulkanContext> ctx, const DeviceMesh& dmesh)
     accelerationBuildGeometryInfo.dstAccelerationStructure = _handle;
     accelerationBuildGeometryInfo.geometryCount = 1;
     accelerationBuildGeometryInfo.pGeometries = &accelerationStructureGeometry;
-    accelerationBuildGeometryInfo.scratchData.deviceAddress = scratchBuffer.getDeviceAddress();
+    accelerationBuildGeometryInfo.scratchData.deviceAddress = scratchBuffer->getDeviceAddress();
 
     // AS Build range info
     VkAccelerationStructureBuildRangeInfoKHR accelerationStructureBuildRangeInfo{};
@@ -87,21 +88,21 @@ BLAS::BLAS(std::shared_ptr<VulkanContext> ctx, const DeviceMesh& dmesh)
     accelerationStructureBuildRangeInfo.transformOffset = 0;
     std::vector<VkAccelerationStructureBuildRangeInfoKHR*> accelerationBuildStructureRangeInfos = { &accelerationStructureBuildRangeInfo };
 
-    // Build the acceleration structure
-    VkCommandBuffer commandBuffer = VulkanHelper::beginSingleTimeCommands(_ctx);
+    // Build on the compute queue without waiting. TLAS builds submitted there later see the result
+    // through the barrier, other queues wait for the build value.
+    VkCommandBuffer commandBuffer = _ctx->computeSubmitter->begin();
     vkrt::vkCmdBuildAccelerationStructuresKHR(
         commandBuffer,
         1,
         &accelerationBuildGeometryInfo,
         accelerationBuildStructureRangeInfos.data());
-    VulkanHelper::endSingleTimeCommands(_ctx, commandBuffer);
-
-    // Cleanup scratch buffer
-    scratchBuffer.destroy();
+    VulkanHelper::recordAccelerationStructureBuildBarrier(commandBuffer);
+    _buildValue = _ctx->computeSubmitter->submit(commandBuffer, [scratchBuffer]() mutable { scratchBuffer.reset(); });
 }
 
 BLAS::~BLAS()
 {
+    _ctx->computeSubmitter->wait(_buildValue);
     if (_handle != VK_NULL_HANDLE) {
         vkrt::vkDestroyAccelerationStructureKHR(_ctx->device, _handle, nullptr);
     }
@@ -9,10 +9,15 @@
 
 class BLAS {
 public:
+    // Build is submitted to ctx->computeSubmitter and not waited for
     BLAS(std::shared_ptr<VulkanContext> ctx, const DeviceMesh& dmesh);
     ~BLAS();
 
     uint64_t getDeviceAddress() const { return _deviceAddress; }
+    // computeSubmitter value signaled when the build is done
+    uint64_t getBuildValue() const { return _buildValue; }
+    // Acceleration structure memory (the scratch memory is gone after the build)
+    VkDeviceSize getMemorySize() const { return _asBuffer->getMemorySize(); }
 
 private:
     std::shared_ptr<VulkanContext> _ctx;
@@ -20,5 +25,5 @@ private:
     std::unique_ptr<Buffer> _asBuffer;
     VkAccelerationStructureKHR _handle = VK_NULL_HANDLE;
     uint64_t _deviceAddress = 0;
-
+    uint64_t _buildValue = 0;
 };
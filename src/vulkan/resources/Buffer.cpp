@@ -1,16 +1,22 @@
 #include "vulkan/resources/Buffer.h"
 #include "vulkan/VulkanHelper.h"
 
-Buffer::Buffer(std::shared_ptr<VulkanContext> ctx, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, bool needsDeviceAddress)
+static MemoryCategory categoryForUsage(VkBufferUsageFlags usage) {
+    if (usage & VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR) return MemoryCategory::AccelerationStructure;
+    if (usage & (VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR
+        | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) return MemoryCategory::Geometry;
+    return MemoryCategory::Other;
+}
+
+Buffer::Buffer(std::shared_ptr<VulkanContext> ctx, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, bool needsDeviceAddress,
+    std::optional<MemoryCategory> category)
     : _ctx(std::move(ctx)), _mappedMemory(nullptr)
 {
     // Create the buffer and allocate memory for it
-    VulkanHelper::createBuffer(_ctx, size, usage, properties, needsDeviceAddress, _buffer, _bufferMemory);
+    VulkanHelper::createBuffer(_ctx, size, usage, properties, _buffer, _allocation, category.value_or(categoryForUsage(usage)));
 
-    // Map the memory to the buffer
-    if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-        vkMapMemory(_ctx->device, _bufferMemory, 0, size, 0, &_mappedMemory);
-    }
+    // Host visible memory is mapped by the allocator
+    _mappedMemory = _allocation.mapped;
 
     // Get the device address if needed
     if (needsDeviceAddress) {
@@ -26,18 +32,13 @@ Buffer::~Buffer()
 
 void Buffer::destroy()
 {
-    // Unmap the memory if it was mapped
-    if (_mappedMemory) {
-        vkUnmapMemory(_ctx->device, _bufferMemory);
-        _mappedMemory = nullptr;
-    }
+    _mappedMemory = nullptr;
 
-    // Destroy the buffer and free the memory
+    // Destroy the buffer and return its memory to the allocator
     if (_buffer) {
         vkDestroyBuffer(_ctx->device, _buffer, nullptr);
-        vkFreeMemory(_ctx->device, _bufferMemory, nullptr);
+        _ctx->allocator->free(_allocation);
         _buffer = VK_NULL_HANDLE;
-        _bufferMemory = VK_NULL_HANDLE;
     }
 
     _deviceAddress = 0;
@@ -6,13 +6,17 @@
 class Buffer
 {
 public:
-    Buffer(std::shared_ptr<VulkanContext> ctx, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, bool needsDeviceAddress = false);
+    // Memory is accounted by usage (geometry, acceleration structure, other) unless category is given
+    Buffer(std::shared_ptr<VulkanContext> ctx, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, bool needsDeviceAddress = false,
+        std::optional<MemoryCategory> category = std::nullopt);
     ~Buffer();
 
     void destroy();
 
     VkBuffer getBuffer() const { return _buffer; }
-    VkDeviceMemory getMemory() const { return _bufferMemory; }
+    VkDeviceMemory getMemory() const { return _allocation.memory; }
+    VkDeviceSize getMemoryOffset() const { return _allocation.offset; }
+    VkDeviceSize getMemorySize() const { return _allocation.size; }
     void* getMappedMemory() const { return _mappedMemory; }
     uint64_t getDeviceAddress() const { return _deviceAddress; }
 
@@ -24,7 +28,7 @@ private:
     std::shared_ptr<VulkanContext> _ctx;
 
     VkBuffer _buffer = VK_NULL_HANDLE;
-    VkDeviceMemory _bufferMemory = VK_NULL_HANDLE;
-    void* _mappedMemory = nullptr;
+    MemoryAllocator::Allocation _allocation;
+    void* _mappedMemory = nullptr;  // Points into the persistently mapped block
     uint64_t _deviceAddress = 0;
 };
@@ -6,13 +6,16 @@
 
 class StorageImage {
 public:
-    StorageImage(std::shared_ptr<VulkanContext> ctx, uint32_t width, uint32_t height, VkFormat format);
+    StorageImage(std::shared_ptr<VulkanContext> ctx, uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags additionalUsage = 0);
     ~StorageImage();
 
     void destroy();
 
     VkImage getImage() const { return _image; }
     VkImageView getImageView() const { return _imageView; }
+    VkFormat getFormat() const { return _format; }
+    uint32_t getWidth() const { return _width; }
+    uint32_t getHeight() const { return _height; }
 
     VkDescriptorImageInfo getDescriptorInfo() const;
 
@@ -24,6 +27,6 @@ private:
     VkFormat _format;
 
     VkImage _image = VK_NULL_HANDLE;
-    VkDeviceMemory _imageMemory = VK_NULL_HANDLE;
+    MemoryAllocator::Allocation _allocation;
     VkImageView _imageView = VK_NULL_HANDLE;
 };
@@ -1,38 +1,45 @@
 #include "vulkan/resources/TLAS.h"
 #include "vulkan/resources/Buffer.h"
 #include "vulkan/VulkanRT.h"
+#include "utils/CpuProfiler.h"
+
+namespace {
+    VkAccelerationStructureGeometryKHR makeInstancesGeometry(uint64_t instancesDeviceAddress) {
+        VkAccelerationStructureGeometryKHR geometry{};
+        geometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+        geometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+        geometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+        geometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+        geometry.geometry.instances.arrayOfPointers = VK_FALSE;
+        geometry.geometry.instances.data.deviceAddress = instancesDeviceAddress;
+        return geometry;
+    }
+}
 
-TLAS::TLAS(std::shared_ptr<VulkanContext> ctx, const std::vector<VkAccelerationStructureInstanceKHR>& instances)
+
+TLAS::TLAS(std::shared_ptr<VulkanContext> ctx, const std::vector<VkAccelerationStructureInstanceKHR>& instances, uint32_t capacity)
     : _ctx(std::move(ctx))
 {
+    PROFILE_SCOPE("TLAS::build");
+
     if (instances.empty()) {
         spdlog::error("TLAS::initialize called with empty instances vector!");
         throw std::runtime_error("Cannot create TLAS with zero instances");
     }
 
-    const uint32_t instanceCount = static_cast<uint32_t>(instances.size());
-    const VkDeviceSize instancesBufferSize = sizeof(VkAccelerationStructureInstanceKHR) * instanceCount;
+    _instanceCount = static_cast<uint32_t>(instances.size());
+    _capacity = std::max(capacity, _instanceCount);
+    const VkDeviceSize instancesBufferSize = sizeof(VkAccelerationStructureInstanceKHR) * _capacity;
 
-    // Buffer for instance data
-    Buffer instancesBuffer(
+    // Buffer for instance data (kept for refits)
+    _instancesBuffer = std::make_unique<Buffer>(
         _ctx,
         instancesBufferSize,
         VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         true);
-    instancesBuffer.copyData(instances.data(), instancesBufferSize);
 
-    // Get device address of the instance buffer
-    VkDeviceOrHostAddressConstKHR instanceDataDeviceAddress{};
-    instanceDataDeviceAddress.deviceAddress = instancesBuffer.getDeviceAddress();
-
-    VkAccelerationStructureGeometryKHR accelerationStructureGeometry{};
-    accelerationStructureGeometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-    accelerationStructureGeometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-    accelerationStructureGeometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
-    accelerationStructureGeometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-    accelerationStructureGeometry.geometry.instances.arrayOfPointers = VK_FALSE;
-    accelerationStructureGeometry.geometry.instances.data = instanceDataDeviceAddress;
+    VkAccelerationStructureGeometryKHR accelerationStructureGeometry = makeInstancesGeometry(_instancesBuffer->getDeviceAddress());
 
     VkAccelerationStructureBuildGeometryInfoKHR accelerationStructureBuildGeometryInfo{};
     accelerationStructureBuildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
@@ -41,7 +48,8 @@ TLAS::TLAS(std::shared_ptr<VulkanContext> ctx, const std::vector<VkAccelerationS
     accelerationStructureBuildGeometryInfo.geometryCount = 1;
     accelerationStructureBuildGeometryInfo.pGeometries = &accelerationStructureGeometry;
 
-    uint32_t primitive_count = instanceCount;
+    // Sizes for the full capacity, any build up to it fits
+    uint32_t primitive_count = _capacity;
 
     VkAccelerationStructureBuildSizesInfoKHR accelerationStructureBuildSizesInfo{};
     accelerationStructureBuildSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
@@ -66,143 +74,95 @@ TLAS::TLAS(std::shared_ptr<VulkanContext> ctx, const std::vector<VkAccelerationS
     accelerationStructureCreateInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
     vkrt::vkCreateAccelerationStructureKHR(_ctx->device, &accelerationStructureCreateInfo, nullptr, &_handle);
 
-    Buffer scratchBuffer(
+    _scratchBuffer = std::make_unique<Buffer>(
         _ctx,
-        accelerationStructureBuildSizesInfo.buildScratchSize,
+        std::max(accelerationStructureBuildSizesInfo.buildScratchSize, accelerationStructureBuildSizesInfo.updateScratchSize),
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        true);
-
-    VkAccelerationStructureBuildGeometryInfoKHR accelerationBuildGeometryInfo{};
-    accelerationBuildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-    accelerationBuildGeometryInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-    accelerationBuildGeometryInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
-    accelerationBuildGeometryInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
-    accelerationBuildGeometryInfo.dstAccelerationStructure = _handle;
-    accelerationBuildGeometryInfo.geometryCount = 1;
-    accelerationBuildGeometryInfo.pGeometries = &accelerationStructureGeometry;
-    accelerationBuildGeometryInfo.scratchData.deviceAddress = scratchBuffer.getDeviceAddress();
-
-    VkAccelerationStructureBuildRangeInfoKHR accelerationStructureBuildRangeInfo{};
-    accelerationStructureBuildRangeInfo.primitiveCount = instanceCount;
-    accelerationStructureBuildRangeInfo.primitiveOffset = 0;
-    accelerationStructureBuildRangeInfo.firstVertex = 0;
-    accelerationStructureBuildRangeInfo.transformOffset = 0;
-    std::vector<VkAccelerationStructureBuildRangeInfoKHR*> accelerationBuildStructureRangeInfos = { &accelerationStructureBuildRangeInfo };
+        true,
+        MemoryCategory::Scratch);
 
-    VkCommandBuffer commandBuffer = VulkanHelper::beginSingleTimeCommands(_ctx);
-    vkrt::vkCmdBuildAccelerationStructuresKHR(
-        commandBuffer,
-        1,
-        &accelerationBuildGeometryInfo,
-        accelerationBuildStructureRangeInfos.data());
-    VulkanHelper::endSingleTimeCommands(_ctx, commandBuffer);
+    // Not waited for: refits on the compute queue are ordered by the barrier, frames wait for the value
+    VkCommandBuffer commandBuffer = _ctx->computeSubmitter->begin();
+    recordBuild(commandBuffer, instances, VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR, nullptr, nullptr);
+    VulkanHelper::recordAccelerationStructureBuildBarrier(commandBuffer);
+    _buildValue = _ctx->computeSubmitter->submit(commandBuffer);
 
     VkAccelerationStructureDeviceAddressInfoKHR accelerationDeviceAddressInfo{};
     accelerationDeviceAddressInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
     accelerationDeviceAddressInfo.accelerationStructure = _handle;
     _deviceAddress = vkrt::vkGetAccelerationStructureDeviceAddressKHR(_ctx->device, &accelerationDeviceAddressInfo);
 
-    scratchBuffer.destroy();
-    instancesBuffer.destroy();
-
-    spdlog::info("Top Level Acceleration Structure created with {} instances.", instanceCount);
+    spdlog::info("Top Level Acceleration Structure created with {} instances (capacity {}).", _instanceCount, _capacity);
 }
 
 TLAS::~TLAS()
 {
+    _ctx->computeSubmitter->wait(_buildValue);
     if (_handle != VK_NULL_HANDLE) {
         vkrt::vkDestroyAccelerationStructureKHR(_ctx->device, _handle, nullptr);
     }
 }
 
-void TLAS::update(const std::vector<VkAccelerationStructureInstanceKHR>& instances)
+void TLAS::recordUpdate(VkCommandBuffer commandBuffer, const std::vector<VkAccelerationStructureInstanceKHR>& instances, GpuProfiler* profiler)
 {
-    if (instances.empty()) {
-        spdlog::error("TLAS::update called with empty instances vector!");
+    PROFILE_SCOPE("TLAS::update");
+
+    if (instances.size() != _instanceCount) {
+        spdlog::error("TLAS::update called with {} instances, the TLAS was built for {}!", instances.size(), _instanceCount);
         return;
     }
+    recordBuild(commandBuffer, instances, VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR, "TLAS Update", profiler);
+}
 
-    const uint32_t instanceCount = static_cast<uint32_t>(instances.size());
-    const VkDeviceSize instancesBufferSize = sizeof(VkAccelerationStructureInstanceKHR) * instanceCount;
-
-    // Buffer for instance data
-    Buffer instancesBuffer(
-        _ctx,
-        instancesBufferSize,
-        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        true);
-    instancesBuffer.copyData(instances.data(), instancesBufferSize);
-
-    // Get device address of the instance buffer
-    VkDeviceOrHostAddressConstKHR instanceDataDeviceAddress{};
-    instanceDataDeviceAddress.deviceAddress = instancesBuffer.getDeviceAddress();
-
-    VkAccelerationStructureGeometryKHR accelerationStructureGeometry{};
-    accelerationStructureGeometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-    accelerationStructureGeometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-    accelerationStructureGeometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
-    accelerationStructureGeometry.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-    accelerationStructureGeometry.geometry.instances.arrayOfPointers = VK_FALSE;
-    accelerationStructureGeometry.geometry.instances.data = instanceDataDeviceAddress;
-
-    // Get size info for scratch buffer
-    VkAccelerationStructureBuildGeometryInfoKHR accelerationStructureBuildGeometryInfo{};
-    accelerationStructureBuildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
-    accelerationStructureBuildGeometryInfo.type  = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-    accelerationStructureBuildGeometryInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
-    accelerationStructureBuildGeometryInfo.geometryCount = 1;
-    accelerationStructureBuildGeometryInfo.pGeometries = &accelerationStructureGeometry;
+void TLAS::recordRebuild(VkCommandBuffer commandBuffer, const std::vector<VkAccelerationStructureInstanceKHR>& instances, GpuProfiler* profiler)
+{
+    PROFILE_SCOPE("TLAS::rebuild");
 
-    uint32_t primitive_count = instanceCount;
+    if (instances.size() > _capacity) {
+        spdlog::error("TLAS::rebuild called with {} instances, the TLAS only has room for {}!", instances.size(), _capacity);
+        return;
+    }
+    _instanceCount = static_cast<uint32_t>(instances.size());
+    recordBuild(commandBuffer, instances, VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR, "TLAS Rebuild", profiler);
+}
 
-    VkAccelerationStructureBuildSizesInfoKHR accelerationStructureBuildSizesInfo{};
-    accelerationStructureBuildSizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
-    vkrt::vkGetAccelerationStructureBuildSizesKHR(
-        _ctx->device,
-        VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-        &accelerationStructureBuildGeometryInfo,
-        &primitive_count,
-        &accelerationStructureBuildSizesInfo);
+void TLAS::recordBuild(VkCommandBuffer commandBuffer, const std::vector<VkAccelerationStructureInstanceKHR>& instances,
+    VkBuildAccelerationStructureModeKHR mode, const char* scopeName, GpuProfiler* profiler)
+{
+    // The previous build/refit has completed, the instance buffer can be overwritten
+    if (!instances.empty()) {
+        _instancesBuffer->copyData(instances.data(), sizeof(VkAccelerationStructureInstanceKHR) * instances.size());
+    }
 
-    // Create scratch buffer for update
-    Buffer scratchBuffer(
-        _ctx,
-        accelerationStructureBuildSizesInfo.updateScratchSize,
-        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        true);
+    VkAccelerationStructureGeometryKHR accelerationStructureGeometry = makeInstancesGeometry(_instancesBuffer->getDeviceAddress());
 
+    const bool update = mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
     VkAccelerationStructureBuildGeometryInfoKHR accelerationBuildGeometryInfo{};
     accelerationBuildGeometryInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
     accelerationBuildGeometryInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
     accelerationBuildGeometryInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
-    accelerationBuildGeometryInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;  // UPDATE mode!
-    accelerationBuildGeometryInfo.srcAccelerationStructure = _handle;  // Source for update
-    accelerationBuildGeometryInfo.dstAccelerationStructure = _handle;  // Destination is same
+    accelerationBuildGeometryInfo.mode = mode;
+    accelerationBuildGeometryInfo.srcAccelerationStructure = update ? _handle : VK_NULL_HANDLE;  // Source for update
+    accelerationBuildGeometryInfo.dstAccelerationStructure = _handle;
     accelerationBuildGeometryInfo.geometryCount = 1;
     accelerationBuildGeometryInfo.pGeometries = &accelerationStructureGeometry;
-    accelerationBuildGeometryInfo.scratchData.deviceAddress = scratchBuffer.getDeviceAddress();
+    accelerationBuildGeometryInfo.scratchData.deviceAddress = _scratchBuffer->getDeviceAddress();
 
     VkAccelerationStructureBuildRangeInfoKHR accelerationStructureBuildRangeInfo{};
-    accelerationStructureBuildRangeInfo.primitiveCount = instanceCount;
+    accelerationStructureBuildRangeInfo.primitiveCount = static_cast<uint32_t>(instances.size());
     accelerationStructureBuildRangeInfo.primitiveOffset = 0;
     accelerationStructureBuildRangeInfo.firstVertex = 0;
     accelerationStructureBuildRangeInfo.transformOffset = 0;
     std::vector<VkAccelerationStructureBuildRangeInfoKHR*> accelerationBuildStructureRangeInfos = { &accelerationStructureBuildRangeInfo };
 
-    // Update the acceleration structure on the device
-    VkCommandBuffer commandBuffer = VulkanHelper::beginSingleTimeCommands(_ctx);
+    if (profiler) profiler->beginScope(commandBuffer, scopeName);
     vkrt::vkCmdBuildAccelerationStructuresKHR(
         commandBuffer,
         1,
         &accelerationBuildGeometryInfo,
         accelerationBuildStructureRangeInfos.data());
-    VulkanHelper::endSingleTimeCommands(_ctx, commandBuffer);
-
-    scratchBuffer.destroy();
-    instancesBuffer.destroy();
+    if (profiler) profiler->endScope(commandBuffer);
 }
 
 
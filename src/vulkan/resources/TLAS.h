@@ -4,14 +4,28 @@
 #include "vulkan/VulkanContext.h"
 #include "vulkan/VulkanHelper.h"
 #include "vulkan/resources/Buffer.h"
+#include "vulkan/GpuProfiler.h"
 
 
 class TLAS {
 public:
-    TLAS(std::shared_ptr<VulkanContext> ctx, const std::vector<VkAccelerationStructureInstanceKHR>& instances);
+    // Build is submitted to ctx->computeSubmitter and not waited for. Storage is sized for
+    // capacity instances (at least the initial count) so later rebuilds can add objects.
+    TLAS(std::shared_ptr<VulkanContext> ctx, const std::vector<VkAccelerationStructureInstanceKHR>& instances, uint32_t capacity = 0);
     ~TLAS();
 
-    void update(const std::vector<VkAccelerationStructureInstanceKHR>& instances);
+    // Records a refit in place into a compute queue command buffer, timed as "TLAS Update" when a
+    // profiler is given. The instance count must match the build. Instance data goes through a
+    // persistent host-visible buffer, so the previous refit of this TLAS must have completed.
+    void recordUpdate(VkCommandBuffer commandBuffer, const std::vector<VkAccelerationStructureInstanceKHR>& instances, GpuProfiler* profiler = nullptr);
+    // Same as recordUpdate, but rebuilds in place for a different instance count (up to the
+    // capacity). The handle stays the same, so descriptors bound to it remain valid.
+    void recordRebuild(VkCommandBuffer commandBuffer, const std::vector<VkAccelerationStructureInstanceKHR>& instances, GpuProfiler* profiler = nullptr);
+
+    uint32_t getInstanceCount() const { return _instanceCount; }
+    uint32_t getCapacity() const { return _capacity; }
+    // computeSubmitter value signaled when the build is done
+    uint64_t getBuildValue() const { return _buildValue; }
 
     VkWriteDescriptorSetAccelerationStructureKHR getDescriptorInfo() const;
 
@@ -21,4 +35,14 @@ private:
     std::unique_ptr<Buffer> _asBuffer;
     VkAccelerationStructureKHR _handle = VK_NULL_HANDLE;
     uint64_t _deviceAddress = 0;
+    uint64_t _buildValue = 0;
+
+    // Kept for refits
+    uint32_t _instanceCount = 0;
+    uint32_t _capacity = 0;
+    std::unique_ptr<Buffer> _instancesBuffer;
+    std::unique_ptr<Buffer> _scratchBuffer;   // Sized for the larger of build and update scratch
+
+    void recordBuild(VkCommandBuffer commandBuffer, const std::vector<VkAccelerationStructureInstanceKHR>& instances,
+        VkBuildAccelerationStructureModeKHR mode, const char* scopeName, GpuProfiler* profiler);
 };